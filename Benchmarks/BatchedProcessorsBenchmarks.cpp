@@ -0,0 +1,133 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // the baseline: one single instance processor per track, each processing its own channels
+    template <typename Processor>
+    class SeparateInstances : public juce::dsp::ProcessorBase
+    {
+    public:
+        template <typename... Args>
+        SeparateInstances (size_t numInstances, Args&&... args)
+        {
+            for (size_t k = 0; k < numInstances; k++)
+                _instances.push_back (std::make_unique<Processor> (args...));
+        }
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _channelsPerInstance = spec.numChannels / _instances.size();
+
+            for (auto& instance : _instances)
+                instance->prepare ({ spec.sampleRate, spec.maximumBlockSize, static_cast<juce::uint32> (_channelsPerInstance) });
+        }
+        virtual void reset() override
+        {
+            for (auto& instance : _instances)
+                instance->reset();
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            for (size_t k = 0; k < _instances.size(); k++)
+            {
+                auto block = context.getOutputBlock().getSubsetChannelBlock (k * _channelsPerInstance, _channelsPerInstance);
+                _instances[k]->process (juce::dsp::ProcessContextReplacing<float> (block));
+            }
+        }
+
+        Processor& operator[] (size_t instance) { return *_instances[instance]; }
+
+    private:
+        std::vector<std::unique_ptr<Processor>> _instances;
+        size_t _channelsPerInstance = 0;
+    };
+} // namespace
+
+TEST_CASE ("Batched lowpass against separate instances", "[BatchedProcessors]")
+{
+    const auto blockSize = static_cast<size_t> (GENERATE (64, 256, 1024));
+    const auto smoothing = GENERATE (false, true);
+    const size_t numInstances = 32;
+    const size_t numChannels = 2 * numInstances;
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    SeparateInstances<OnePoleFilter::Lowpass<float>> separate (numInstances);
+    Batched::Lowpass<float> batched (numInstances);
+    separate.prepare (spec);
+    batched.prepare (spec);
+
+    for (size_t k = 0; k < numInstances; k++)
+    {
+        separate[k].setCutoffFrequency (500.0f + 100.0f * k, true);
+        batched.setCutoffFrequency (k, 500.0f + 100.0f * k, true);
+    }
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("SeparateInstances<Lowpass>", blockSize, numChannels, smoothing),
+                                        separate,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                for (size_t k = 0; k < numInstances; k++)
+                                                    separate[k].setCutoffFrequency (runIndex % 2 == 0 ? 300.0f : 3000.0f);
+                                        });
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("Batched::Lowpass", blockSize, numChannels, smoothing),
+                                        batched,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                for (size_t k = 0; k < numInstances; k++)
+                                                    batched.setCutoffFrequency (k, runIndex % 2 == 0 ? 300.0f : 3000.0f);
+                                        });
+}
+
+TEST_CASE ("Batched allpass against separate instances", "[BatchedProcessors]")
+{
+    const auto blockSize = static_cast<size_t> (GENERATE (64, 256, 1024));
+    const auto smoothing = GENERATE (false, true);
+    const size_t numInstances = 32;
+    const size_t numChannels = 2 * numInstances;
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    SeparateInstances<VariableDelayAllpass<float>> separate (numInstances, 4800);
+    Batched::VariableDelayAllpass<float> batched (numInstances, 4800);
+    separate.prepare (spec);
+    batched.prepare (spec);
+
+    for (size_t k = 0; k < numInstances; k++)
+    {
+        separate[k].setDelayInSamples (1000.5f + 10.0f * k, 0, true);
+        separate[k].setGain (0.5f, true);
+        batched.setDelayInSamples (k, 1000.5f + 10.0f * k, true);
+        batched.setGain (k, 0.5f, true);
+    }
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("SeparateInstances<VariableDelayAllpass>", blockSize, numChannels, smoothing),
+                                        separate,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                for (size_t k = 0; k < numInstances; k++)
+                                                    separate[k].setDelayInSamples (runIndex % 2 == 0 ? 1000.5f : 2000.5f);
+                                        });
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("Batched::VariableDelayAllpass", blockSize, numChannels, smoothing),
+                                        batched,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                for (size_t k = 0; k < numInstances; k++)
+                                                    batched.setDelayInSamples (k, runIndex % 2 == 0 ? 1000.5f : 2000.5f);
+                                        });
+}
@@ -0,0 +1,77 @@
+#include "BenchmarkHelpers.h"
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace BenchmarkHelpers
+{
+    static std::map<std::string, size_t>& getSamplesPerRunRegistry()
+    {
+        static std::map<std::string, size_t> registry;
+        return registry;
+    }
+
+    void registerSamplesPerRun (const std::string& benchmarkName, size_t numChannelSamples)
+    {
+        getSamplesPerRunRegistry()[benchmarkName] = numChannelSamples;
+    }
+
+    size_t getSamplesPerRun (const std::string& benchmarkName)
+    {
+        auto it = getSamplesPerRunRegistry().find (benchmarkName);
+
+        return it != getSamplesPerRunRegistry().end() ? it->second : 1;
+    }
+
+    class NsPerSampleListener : public Catch::EventListenerBase
+    {
+    public:
+        using Catch::EventListenerBase::EventListenerBase;
+
+        void benchmarkEnded (const Catch::BenchmarkStats<>& benchmarkStats) override
+        {
+            const auto numSamples = static_cast<double> (getSamplesPerRun (benchmarkStats.info.name));
+
+            _results.push_back ({ benchmarkStats.info.name,
+                                  benchmarkStats.mean.point.count() / numSamples,
+                                  benchmarkStats.mean.lower_bound.count() / numSamples,
+                                  benchmarkStats.mean.upper_bound.count() / numSamples });
+        }
+
+        void testRunEnded (const Catch::TestRunStats& testRunStats) override
+        {
+            (void) testRunStats;
+
+            if (_results.empty())
+                return;
+
+            const char* path = std::getenv ("BENCHMARK_CSV");
+            std::ofstream file;
+
+            if (path != nullptr)
+                file.open (path);
+
+            std::ostream& out = file.is_open() ? static_cast<std::ostream&> (file) : std::cout;
+
+            out << "benchmark,ns_per_sample,ns_per_sample_lower,ns_per_sample_upper\n";
+
+            for (auto& r : _results)
+                out << r.name << "," << r.mean << "," << r.lowerBound << "," << r.upperBound << "\n";
+        }
+
+    private:
+        struct Result
+        {
+            std::string name;
+            double mean;
+            double lowerBound;
+            double upperBound;
+        };
+
+        std::vector<Result> _results;
+    };
+
+    CATCH_REGISTER_LISTENER (NsPerSampleListener)
+} // namespace BenchmarkHelpers
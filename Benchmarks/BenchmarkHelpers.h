@@ -0,0 +1,69 @@
+#pragma once
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+#include <juce_dsp/juce_dsp.h>
+
+namespace BenchmarkHelpers
+{
+    // Results are reported in ns per channel sample, i.e. the mean time of one run divided by
+    // numChannels * numSamples. They are written as CSV to the file named by the BENCHMARK_CSV
+    // environment variable, or to stdout when it is not set.
+    void registerSamplesPerRun (const std::string& benchmarkName, size_t numChannelSamples);
+    size_t getSamplesPerRun (const std::string& benchmarkName);
+
+    template <typename SampleType = float>
+    static juce::AudioBuffer<SampleType> generateNoise (size_t numChannels, size_t numSamples)
+    {
+        juce::AudioBuffer<SampleType> buffer (static_cast<int> (numChannels), static_cast<int> (numSamples));
+        juce::Random random (1234);
+
+        for (auto ch = 0; ch < buffer.getNumChannels(); ch++)
+            for (auto i = 0; i < buffer.getNumSamples(); i++)
+                buffer.setSample (ch, i, static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f));
+
+        return buffer;
+    }
+
+    static std::string getPrecisionName (bool doubleState, bool doubleIO)
+    {
+        return std::string ("/state=") + (doubleState ? "double" : "float") + "/io=" + (doubleIO ? "double" : "float");
+    }
+
+    static std::string getBenchmarkName (const std::string& processorName, size_t blockSize, size_t numChannels, bool smoothing, size_t numTaps = 0)
+    {
+        std::string name = processorName + "/block=" + std::to_string (blockSize) + "/channels=" + std::to_string (numChannels);
+
+        if (numTaps > 0)
+            name += "/taps=" + std::to_string (numTaps);
+
+        return name + "/smoothing=" + (smoothing ? "on" : "off");
+    }
+
+    // Processes the buffer in place once per benchmark run. The update callback is invoked before
+    // every run so that parameters can be retargeted and the smoothers kept ramping.
+    template <typename Processor, typename SampleType, typename ParameterUpdate>
+    static void benchmarkProcess (const std::string& benchmarkName, Processor& processor, juce::AudioBuffer<SampleType>& buffer, ParameterUpdate&& updateParameters)
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        juce::dsp::AudioBlock<SampleType> block (buffer);
+        juce::dsp::ProcessContextReplacing<SampleType> context (block);
+
+        registerSamplesPerRun (benchmarkName, block.getNumChannels() * block.getNumSamples());
+
+        size_t runIndex = 0;
+
+        BENCHMARK (std::string (benchmarkName))
+        {
+            updateParameters (runIndex++);
+            processor.process (context);
+            return buffer.getSample (0, 0);
+        };
+    }
+
+    static std::vector<size_t> blockSizes() { return { 16, 64, 256, 1024, 4096 }; }
+    static std::vector<size_t> channelCounts() { return { 1, 2, 8, 64 }; }
+} // namespace BenchmarkHelpers
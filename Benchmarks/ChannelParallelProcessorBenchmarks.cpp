@@ -0,0 +1,30 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Channel parallel allpass scaling", "[ChannelParallelProcessor]")
+{
+    const auto blockSize = static_cast<size_t> (GENERATE (64, 256, 1024));
+    const auto numThreads = static_cast<size_t> (GENERATE (1, 2, 4, 8, 16));
+    const size_t numChannels = 64;
+    const size_t numTaps = 4;
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    ChannelParallelProcessor parallelProcessor ([numTaps] { return std::make_unique<VariableDelayAllpass<>> (4800, numTaps); }, numThreads);
+    parallelProcessor.setParallelThreshold (0);
+    parallelProcessor.prepare (spec);
+
+    parallelProcessor.forEachProcessor<VariableDelayAllpass<>> ([numTaps] (VariableDelayAllpass<>& allpass) {
+        allpass.setGain (0.5f, true);
+
+        for (size_t n = 0; n < numTaps; n++)
+            allpass.setDelayInSamples (100.0f + 500.0f * n, n, true);
+    });
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("ChannelParallelProcessor<VariableDelayAllpass>/threads=" + std::to_string (numThreads), blockSize, numChannels, false, numTaps),
+                                        parallelProcessor,
+                                        buffer,
+                                        [] (size_t) {});
+}
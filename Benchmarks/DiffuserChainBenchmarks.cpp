@@ -0,0 +1,71 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // predelay -> lowpass -> 4 allpasses, one pass over the block per processor
+    class BlockwiseDiffuser
+    {
+    public:
+        explicit BlockwiseDiffuser (const juce::dsp::ProcessSpec& spec)
+        {
+            _predelay.prepare (spec);
+            _lowpassFilter.prepare (spec);
+
+            for (auto& allpass : _allpasses)
+                allpass.prepare (spec);
+
+            _predelay.setDelayInSamples (960.0f, 0, true);
+            _lowpassFilter.setCutoffFrequency (6000.0f, true);
+
+            const std::array<float, 4> delays{ 141.5f, 107.25f, 379.0f, 277.75f };
+
+            for (size_t n = 0; n < _allpasses.size(); n++)
+            {
+                _allpasses[n].setDelayInSamples (delays[n], 0, true);
+                _allpasses[n].setGain (n < 2 ? 0.75f : 0.625f, true);
+            }
+        }
+
+        void retarget (size_t runIndex)
+        {
+            _lowpassFilter.setCutoffFrequency (runIndex % 2 == 0 ? 4000.0f : 8000.0f);
+            _allpasses[0].setDelayInSamples (runIndex % 2 == 0 ? 141.5f : 151.5f);
+        }
+
+        void process (const juce::dsp::ProcessContextReplacing<float>& context)
+        {
+            _predelay.process (context);
+            _lowpassFilter.process (context);
+
+            for (auto& allpass : _allpasses)
+                allpass.process (context);
+        }
+
+    private:
+        VariableDelayLine<float> _predelay{ 4800 };
+        OnePoleFilter::Lowpass<float> _lowpassFilter;
+        std::array<VariableDelayAllpass<float>, 4> _allpasses{ VariableDelayAllpass<float> (1000), VariableDelayAllpass<float> (1000), VariableDelayAllpass<float> (1000), VariableDelayAllpass<float> (1000) };
+    };
+} // namespace
+
+TEST_CASE ("Block-wise diffuser chain", "[DiffuserChain]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto smoothing = GENERATE (false, true);
+    const size_t numChannels = 2;
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    BlockwiseDiffuser diffuser (spec);
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("BlockwiseChain<Diffuser>", blockSize, numChannels, smoothing),
+                                        diffuser,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                diffuser.retarget (runIndex);
+                                        });
+}
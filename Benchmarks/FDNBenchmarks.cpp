@@ -0,0 +1,40 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+template <size_t N>
+static void benchmarkFdn (size_t blockSize, size_t numChannels, bool modulation)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    FDN<N> fdn (4800);
+    fdn.prepare (spec);
+    fdn.setFeedback (0.9f, true);
+    fdn.setDampingFrequency (6000.0f, true);
+    fdn.setModulation (modulation ? 0.5f : 0.0f, 8.0f);
+
+    for (size_t n = 0; n < N; n++)
+        fdn.setDelayInSamples (1000.0f + 3000.0f * n / N, n, true);
+
+    const auto noise = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+    auto buffer = noise;
+
+    // the output is not fed back in as the next input, since it would build up in the feedback loop
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("FDN<" + std::to_string (N) + ">", blockSize, numChannels, modulation),
+                                        fdn,
+                                        buffer,
+                                        [&] (size_t)
+                                        {
+                                            buffer.makeCopyOf (noise, true);
+                                        });
+}
+
+TEST_CASE ("Feedback delay network process", "[FDN]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = static_cast<size_t> (GENERATE (1, 2));
+    const auto modulation = GENERATE (false, true);
+
+    benchmarkFdn<4> (blockSize, numChannels, modulation);
+    benchmarkFdn<8> (blockSize, numChannels, modulation);
+    benchmarkFdn<16> (blockSize, numChannels, modulation);
+}
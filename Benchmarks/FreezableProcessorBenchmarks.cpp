@@ -0,0 +1,58 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+static void benchmarkFreezable (size_t blockSize, size_t numChannels, bool frozen)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    FreezableProcessor processor (
+        [spec]
+        {
+            auto fdn = std::make_unique<FDN<8>> (2000);
+            fdn->prepare (spec);
+            fdn->setFeedback (0.5f, true);
+            fdn->setDampingFrequency (6000.0f, true);
+
+            for (size_t n = 0; n < 8; n++)
+                fdn->setDelayInSamples (300.0f + 1500.0f * n / 8, n, true);
+
+            return fdn;
+        },
+        1 << 16);
+    processor.prepare (spec);
+
+    const auto noise = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+    auto buffer = noise;
+
+    if (frozen)
+    {
+        processor.freeze();
+
+        // get through the warm-up and the crossfade before timing
+        const auto numWarmUpBlocks = static_cast<size_t> (processor.getImpulseResponse().getNumSamples() + spec.sampleRate) / blockSize + 1;
+
+        for (size_t i = 0; i < numWarmUpBlocks; i++)
+        {
+            buffer.makeCopyOf (noise, true);
+            juce::dsp::AudioBlock<float> block (buffer);
+            processor.process (juce::dsp::ProcessContextReplacing<float> (block));
+        }
+    }
+
+    BenchmarkHelpers::benchmarkProcess ("FreezableProcessor/FDN<8>/" + std::string (frozen ? "frozen" : "live") + "/block=" + std::to_string (blockSize) + "/channels=" + std::to_string (numChannels),
+                                        processor,
+                                        buffer,
+                                        [&] (size_t)
+                                        {
+                                            buffer.makeCopyOf (noise, true);
+                                        });
+}
+
+TEST_CASE ("Freezable processor process", "[FreezableProcessor]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = static_cast<size_t> (GENERATE (1, 2));
+
+    benchmarkFreezable (blockSize, numChannels, false);
+    benchmarkFreezable (blockSize, numChannels, true);
+}
@@ -0,0 +1,107 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("One pole lowpass filter process", "[OnePoleFilter]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+    const auto smoothing = GENERATE (false, true);
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    OnePoleFilter::Lowpass lowpassFilter;
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("OnePoleFilter::Lowpass", blockSize, numChannels, smoothing),
+                                        lowpassFilter,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                lowpassFilter.setCutoffFrequency (runIndex % 2 == 0 ? 500.0f : 2000.0f);
+                                        });
+}
+
+TEST_CASE ("One pole highpass filter process", "[OnePoleFilter]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+    const auto smoothing = GENERATE (false, true);
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    OnePoleFilter::Highpass highpassFilter;
+    highpassFilter.prepare (spec);
+    highpassFilter.setCutoffFrequency (1000.0f, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("OnePoleFilter::Highpass", blockSize, numChannels, smoothing),
+                                        highpassFilter,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                highpassFilter.setCutoffFrequency (runIndex % 2 == 0 ? 500.0f : 2000.0f);
+                                        });
+}
+
+template <typename SampleType, typename IOType>
+static void benchmarkLowpassPrecision (size_t blockSize, size_t numChannels)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    OnePoleFilter::Lowpass<SampleType> lowpassFilter;
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise<IOType> (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("OnePoleFilter::Lowpass" + BenchmarkHelpers::getPrecisionName (std::is_same<SampleType, double>::value, std::is_same<IOType, double>::value), blockSize, numChannels, false),
+                                        lowpassFilter,
+                                        buffer,
+                                        [] (size_t) {});
+}
+
+TEST_CASE ("One pole lowpass filter precision", "[OnePoleFilter][precision]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+
+    benchmarkLowpassPrecision<float, float> (blockSize, numChannels);
+    benchmarkLowpassPrecision<double, float> (blockSize, numChannels);
+    benchmarkLowpassPrecision<double, double> (blockSize, numChannels);
+}
+
+template <typename SampleType>
+static void benchmarkLowpassBlockScan (size_t blockSize, size_t numChannels, bool blockScan)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    OnePoleFilter::Lowpass<SampleType> lowpassFilter;
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+    lowpassFilter.setBlockScan (blockScan);
+
+    auto buffer = BenchmarkHelpers::generateNoise<SampleType> (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName (std::string ("OnePoleFilter::Lowpass<") + (std::is_same<SampleType, double>::value ? "double" : "float") + (blockScan ? ">/scan" : ">/serial"), blockSize, numChannels, false),
+                                        lowpassFilter,
+                                        buffer,
+                                        [] (size_t) {});
+}
+
+TEST_CASE ("One pole lowpass filter block scan", "[OnePoleFilter][scan]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (as<size_t>{}, 1, 2);
+
+    for (const auto blockScan : { false, true })
+    {
+        benchmarkLowpassBlockScan<float> (blockSize, numChannels, blockScan);
+        benchmarkLowpassBlockScan<double> (blockSize, numChannels, blockScan);
+    }
+}
@@ -0,0 +1,92 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // cheap enough that the copy and the mixing pass show
+    using Filter = OnePoleFilter::Lowpass<float>;
+
+    // keeps a copy of the dry signal, processes in place, then mixes in a pass of its own
+    class SeparateMix
+    {
+    public:
+        explicit SeparateMix (const juce::dsp::ProcessSpec& spec)
+            : _dry (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize))
+        {
+            _filter.prepare (spec);
+            _filter.setCutoffFrequency (4000.0f, true);
+        }
+
+        void process (const juce::dsp::ProcessContextReplacing<float>& context)
+        {
+            auto& block = context.getOutputBlock();
+            const auto numSamples = block.getNumSamples();
+
+            juce::dsp::AudioBlock<float> (_dry).getSubBlock (0, numSamples).copyFrom (block);
+
+            _filter.process (context);
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+            {
+                const auto* dry = _dry.getReadPointer (static_cast<int> (ch));
+                auto* samples = block.getChannelPointer (ch);
+
+                for (size_t i = 0; i < numSamples; i++)
+                    samples[i] = 0.3f * dry[i] + 0.7f * samples[i];
+            }
+        }
+
+    private:
+        Filter _filter;
+        juce::AudioBuffer<float> _dry;
+    };
+
+    // the same mix fused into the filter's output loop, optionally reading a separate input block
+    class FusedMix
+    {
+    public:
+        FusedMix (const juce::dsp::ProcessSpec& spec, const juce::AudioBuffer<float>* input)
+            : _input (input)
+        {
+            _filter.prepare (spec);
+            _filter.setCutoffFrequency (4000.0f, true);
+            _filter.getOutputMix().setDryLevel (0.3f, true);
+            _filter.getOutputMix().setWetLevel (0.7f, true);
+        }
+
+        void process (const juce::dsp::ProcessContextReplacing<float>& context)
+        {
+            if (_input == nullptr)
+            {
+                _filter.process (context);
+                return;
+            }
+
+            const juce::dsp::AudioBlock<const float> inputBlock (_input->getArrayOfReadPointers(), static_cast<size_t> (_input->getNumChannels()), static_cast<size_t> (_input->getNumSamples()));
+            _filter.process (juce::dsp::ProcessContextNonReplacing<float> (inputBlock, context.getOutputBlock()));
+        }
+
+    private:
+        Filter _filter;
+        const juce::AudioBuffer<float>* _input;
+    };
+} // namespace
+
+TEST_CASE ("Fused against separate dry/wet mix", "[OutputMix]")
+{
+    const auto blockSize = GENERATE (as<size_t>{}, 64, 512, 4096);
+    const size_t numChannels = 2;
+
+    const juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+    const auto input = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    SeparateMix separate (spec);
+    FusedMix fused (spec, nullptr);
+    FusedMix outOfPlace (spec, &input);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("SeparateMix<Lowpass>", blockSize, numChannels, false), separate, buffer, [] (size_t) {});
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("FusedMix<Lowpass>", blockSize, numChannels, false), fused, buffer, [] (size_t) {});
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("FusedMix<Lowpass>/out-of-place", blockSize, numChannels, false), outOfPlace, buffer, [] (size_t) {});
+}
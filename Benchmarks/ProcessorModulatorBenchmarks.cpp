@@ -0,0 +1,35 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Processor modulator driving a variable delay line", "[ProcessorModulator]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+    const auto updateRate = static_cast<size_t> (GENERATE (1, 32, 256));
+    const auto smoothing = GENERATE (false, true);
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    VariableDelayLine delayLine (4800);
+    OscillatorWrapper oscillator;
+    ProcessorModulator modulator (oscillator, updateRate);
+
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (delayLine);
+    modulator.setModulationTarget ([&] (float value) { delayLine.setDelayInSamples (value); });
+    modulator.setModulationRange ({ 100.0f, 200.0f });
+
+    // without smoothing the modulator is stopped, so only the sub-block slicing is measured
+    modulator.setModulationFrequency (smoothing ? 1.0f : 0.0f);
+
+    delayLine.prepare (spec);
+    modulator.prepare (spec);
+    delayLine.setDelayInSamples (150.0f, 0, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("ProcessorModulator/updateRate=" + std::to_string (updateRate), blockSize, numChannels, smoothing),
+                                        modulator,
+                                        buffer,
+                                        [] (size_t) {});
+}
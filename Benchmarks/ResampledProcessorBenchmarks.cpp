@@ -0,0 +1,52 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+static std::unique_ptr<juce::dsp::ProcessorBase> makeFdn (const juce::dsp::ProcessSpec& spec, double delayScale)
+{
+    auto fdn = std::make_unique<FDN<8>> (static_cast<size_t> (3000.0 * delayScale));
+    fdn->prepare (spec);
+    fdn->setFeedback (0.9f, true);
+    fdn->setDampingFrequency (6000.0f, true);
+
+    for (size_t n = 0; n < 8; n++)
+        fdn->setDelayInSamples (static_cast<float> ((600.0 + 2000.0 * n / 8) * delayScale), n, true);
+
+    return fdn;
+}
+
+// the same network, with delays designed at 29761 Hz, at the host rate and at the reduced internal rate
+static void benchmarkResampled (double sampleRate, size_t blockSize, size_t numChannels, bool resampled)
+{
+    juce::dsp::ProcessSpec spec{ sampleRate, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+    const auto designSampleRate = 29761.0;
+
+    std::unique_ptr<juce::dsp::ProcessorBase> processor;
+
+    if (resampled)
+        processor = std::make_unique<ResampledProcessor> (makeFdn, designSampleRate);
+    else
+        processor = makeFdn (spec, sampleRate / designSampleRate);
+
+    processor->prepare (spec);
+
+    const auto noise = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+    auto buffer = noise;
+
+    BenchmarkHelpers::benchmarkProcess ("FDN<8>/" + std::string (resampled ? "resampled" : "host rate") + "/rate=" + std::to_string (static_cast<int> (sampleRate)) + "/block=" + std::to_string (blockSize) + "/channels=" + std::to_string (numChannels),
+                                        *processor,
+                                        buffer,
+                                        [&] (size_t)
+                                        {
+                                            buffer.makeCopyOf (noise, true);
+                                        });
+}
+
+TEST_CASE ("Resampled processor process", "[ResampledProcessor]")
+{
+    const auto sampleRate = GENERATE (48000.0, 96000.0, 192000.0);
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = static_cast<size_t> (GENERATE (1, 2));
+
+    benchmarkResampled (sampleRate, blockSize, numChannels, false);
+    benchmarkResampled (sampleRate, blockSize, numChannels, true);
+}
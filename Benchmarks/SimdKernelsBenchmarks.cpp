@@ -0,0 +1,51 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+// the same processors prepared with each supported kernel variant forced, the output is identical
+template <typename Processor, typename Setup>
+static void benchmarkVariants (const std::string& processorName, size_t blockSize, size_t numChannels, Processor& processor, Setup&& setup)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    for (const auto variant : { SimdKernels::Variant::generic, SimdKernels::Variant::avx2, SimdKernels::Variant::avx512 })
+    {
+        if (! SimdKernels::isSupported (variant))
+            continue;
+
+        SimdKernels::forceVariant (variant);
+        processor.prepare (spec);
+        SimdKernels::clearForcedVariant();
+
+        setup (processor);
+
+        auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+        BenchmarkHelpers::benchmarkProcess (processorName + "/" + SimdKernels::getName (variant) + "/block=" + std::to_string (blockSize) + "/channels=" + std::to_string (numChannels),
+                                            processor,
+                                            buffer,
+                                            [] (size_t) {});
+    }
+}
+
+TEST_CASE ("Kernel variants process", "[SimdKernels]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = static_cast<size_t> (GENERATE (1, 2));
+
+    OnePoleFilter::Highpass<float> highpass;
+    benchmarkVariants ("Highpass", blockSize, numChannels, highpass, [] (auto& filter) { filter.setCutoffFrequency (1000.0f, true); });
+
+    VariableDelayLine<float> delayLine (4800, 4);
+    benchmarkVariants ("VariableDelayLine/taps=4", blockSize, numChannels, delayLine, [] (auto& line)
+                       {
+                           for (size_t n = 0; n < 4; n++)
+                               line.setDelayInSamples (1000.5f + 500.0f * n, n, true);
+                       });
+
+    VariableDelayAllpass<float> allpass (4800);
+    benchmarkVariants ("VariableDelayAllpass", blockSize, numChannels, allpass, [] (auto& ap)
+                       {
+                           ap.setDelayInSamples (1000.5f, 0, true);
+                           ap.setGain (0.5f, true);
+                       });
+}
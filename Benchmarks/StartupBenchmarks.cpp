@@ -0,0 +1,52 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+// One run is one instance, so these report ns per instance rather than per channel sample.
+template <typename Factory>
+static void benchmarkStartup (const std::string& processorName, const juce::dsp::ProcessSpec& spec, Factory&& makeProcessor)
+{
+    const auto name = processorName + "/channels=" + std::to_string (spec.numChannels);
+    const juce::dsp::ProcessSpec otherSpec{ spec.sampleRate * 2.0, spec.maximumBlockSize / 2, spec.numChannels };
+
+    BenchmarkHelpers::registerSamplesPerRun (name + "/construct+prepare", 1);
+    BenchmarkHelpers::registerSamplesPerRun (name + "/prepare=same", 1);
+    BenchmarkHelpers::registerSamplesPerRun (name + "/prepare=changed", 1);
+
+    BENCHMARK_ADVANCED (name + "/construct+prepare") (Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<decltype (makeProcessor())> instances (static_cast<size_t> (meter.runs()));
+
+        meter.measure ([&] (int i)
+                       {
+                           auto& instance = instances[static_cast<size_t> (i)];
+                           instance = makeProcessor();
+                           instance->prepare (spec);
+                       });
+    };
+
+    auto processor = makeProcessor();
+    processor->prepare (spec);
+
+    BENCHMARK (name + "/prepare=same")
+    {
+        processor->prepare (spec);
+    };
+
+    size_t runIndex = 0;
+
+    BENCHMARK (name + "/prepare=changed")
+    {
+        processor->prepare (runIndex++ % 2 == 0 ? otherSpec : spec);
+    };
+}
+
+TEST_CASE ("Processor startup", "[Startup]")
+{
+    const auto numChannels = static_cast<juce::uint32> (GENERATE (2, 8));
+    const juce::dsp::ProcessSpec spec{ 48000.0, 512, numChannels };
+
+    benchmarkStartup ("Lowpass", spec, [] { return std::make_unique<OnePoleFilter::Lowpass<>>(); });
+    benchmarkStartup ("VariableDelayLine/taps=4", spec, [] { return std::make_unique<VariableDelayLine<>> (4800, 4); });
+    benchmarkStartup ("VariableDelayAllpass", spec, [] { return std::make_unique<VariableDelayAllpass<>> (4800); });
+    benchmarkStartup ("FDN<8>", spec, [] { return std::make_unique<FDN<8>> (4800); });
+}
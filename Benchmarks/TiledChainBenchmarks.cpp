@@ -0,0 +1,117 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // modulated predelay -> lowpass -> 4 allpasses, as separate processors
+    struct Diffuser
+    {
+        Diffuser()
+            : modulator (oscillator, 32)
+        {
+            oscillator.setWaveform (OscillatorWrapper::Sine);
+            modulator.setProcessorToModulate (predelay);
+            modulator.setModulationTarget ([this] (float value) { predelay.setDelayInSamples (value); });
+            modulator.setModulationRange ({ 4700.0f, 4900.0f });
+            modulator.setModulationFrequency (0.5f);
+        }
+
+        void setParameters()
+        {
+            predelay.setDelayInSamples (4800.0f, 0, true);
+            lowpassFilter.setCutoffFrequency (6000.0f, true);
+
+            const std::array<float, 4> delays{ 1423.5f, 1071.25f, 3790.0f, 2777.75f };
+
+            for (size_t n = 0; n < allpasses.size(); n++)
+            {
+                allpasses[n].setDelayInSamples (delays[n], 0, true);
+                allpasses[n].setGain (n < 2 ? 0.75f : 0.625f, true);
+            }
+        }
+
+        VariableDelayLine<float> predelay{ 9600 };
+        OscillatorWrapper oscillator;
+        ProcessorModulator<float> modulator;
+        OnePoleFilter::Lowpass<float> lowpassFilter;
+        std::array<VariableDelayAllpass<float>, 4> allpasses{ VariableDelayAllpass<float> (4000), VariableDelayAllpass<float> (4000), VariableDelayAllpass<float> (4000), VariableDelayAllpass<float> (4000) };
+    };
+
+    // every processor over the whole block before the next one starts
+    class UntiledChain
+    {
+    public:
+        UntiledChain (Diffuser& diffuser, const juce::dsp::ProcessSpec& spec)
+            : _diffuser (diffuser)
+        {
+            _diffuser.predelay.prepare (spec);
+            _diffuser.modulator.prepare (spec);
+            _diffuser.lowpassFilter.prepare (spec);
+
+            for (auto& allpass : _diffuser.allpasses)
+                allpass.prepare (spec);
+
+            _diffuser.setParameters();
+        }
+
+        void process (const juce::dsp::ProcessContextReplacing<float>& context)
+        {
+            _diffuser.modulator.process (context);
+            _diffuser.lowpassFilter.process (context);
+
+            for (auto& allpass : _diffuser.allpasses)
+                allpass.process (context);
+        }
+
+    private:
+        Diffuser& _diffuser;
+    };
+
+    std::unique_ptr<TiledChain> makeTiledChain (Diffuser& diffuser, const juce::dsp::ProcessSpec& spec, size_t tileSize)
+    {
+        auto chain = std::make_unique<TiledChain> (tileSize);
+        chain->addProcessor (diffuser.modulator);
+        chain->addProcessor (diffuser.lowpassFilter);
+
+        for (auto& allpass : diffuser.allpasses)
+            chain->addProcessor (allpass);
+
+        diffuser.predelay.prepare ({ spec.sampleRate, static_cast<juce::uint32> (tileSize), spec.numChannels });
+        chain->prepare (spec);
+        diffuser.setParameters();
+
+        return chain;
+    }
+} // namespace
+
+TEST_CASE ("Tiled against untiled chain", "[TiledChain]")
+{
+    const auto blockSize = GENERATE (as<size_t>{}, 128, 4096, 16384);
+    const size_t numChannels = 2;
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    Diffuser untiledDiffuser;
+    UntiledChain untiled (untiledDiffuser, spec);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("UntiledChain<Diffuser>", blockSize, numChannels, false),
+                                        untiled,
+                                        buffer,
+                                        [] (size_t) {});
+
+    for (size_t tileSize : { 64, 128, 256 })
+    {
+        if (tileSize >= blockSize)
+            continue;
+
+        Diffuser tiledDiffuser;
+        auto tiled = makeTiledChain (tiledDiffuser, spec, tileSize);
+
+        BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("TiledChain<Diffuser>/tile=" + std::to_string (tileSize), blockSize, numChannels, false),
+                                            *tiled,
+                                            buffer,
+                                            [] (size_t) {});
+    }
+}
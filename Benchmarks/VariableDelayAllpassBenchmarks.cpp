@@ -0,0 +1,63 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Variable delay allpass process", "[VariableDelayAllpass]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+    const auto numTaps = static_cast<size_t> (GENERATE (1, 4, 8));
+    const auto smoothing = GENERATE (false, true);
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    VariableDelayAllpass allpass (4800, numTaps);
+    allpass.prepare (spec);
+    allpass.setGain (0.5f, true);
+
+    for (size_t n = 0; n < numTaps; n++)
+        allpass.setDelayInSamples (100.0f + 500.0f * n, n, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("VariableDelayAllpass", blockSize, numChannels, smoothing, numTaps),
+                                        allpass,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                            {
+                                                allpass.setGain (runIndex % 2 == 0 ? 0.4f : 0.6f);
+
+                                                for (size_t n = 0; n < numTaps; n++)
+                                                    allpass.setDelayInSamples ((runIndex % 2 == 0 ? 100.5f : 200.5f) + 500.0f * n, n);
+                                            }
+                                        });
+}
+
+template <typename SampleType, typename IOType>
+static void benchmarkAllpassPrecision (size_t blockSize, size_t numChannels)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    VariableDelayAllpass<SampleType> allpass (4800);
+    allpass.prepare (spec);
+    allpass.setGain (0.5f, true);
+    allpass.setDelayInSamples (100.5f, 0, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise<IOType> (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("VariableDelayAllpass" + BenchmarkHelpers::getPrecisionName (std::is_same<SampleType, double>::value, std::is_same<IOType, double>::value), blockSize, numChannels, false, 1),
+                                        allpass,
+                                        buffer,
+                                        [] (size_t) {});
+}
+
+TEST_CASE ("Variable delay allpass precision", "[VariableDelayAllpass][precision]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+
+    benchmarkAllpassPrecision<float, float> (blockSize, numChannels);
+    benchmarkAllpassPrecision<double, float> (blockSize, numChannels);
+    benchmarkAllpassPrecision<double, double> (blockSize, numChannels);
+}
@@ -0,0 +1,57 @@
+#include "BenchmarkHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Variable delay line process", "[VariableDelayLine]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+    const auto numTaps = static_cast<size_t> (GENERATE (1, 4, 8));
+    const auto smoothing = GENERATE (false, true);
+
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    VariableDelayLine delayLine (4800, numTaps);
+    delayLine.prepare (spec);
+
+    for (size_t n = 0; n < numTaps; n++)
+        delayLine.setDelayInSamples (100.0f + 500.0f * n, n, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("VariableDelayLine", blockSize, numChannels, smoothing, numTaps),
+                                        delayLine,
+                                        buffer,
+                                        [&] (size_t runIndex)
+                                        {
+                                            if (smoothing)
+                                                for (size_t n = 0; n < numTaps; n++)
+                                                    delayLine.setDelayInSamples ((runIndex % 2 == 0 ? 100.5f : 200.5f) + 500.0f * n, n);
+                                        });
+}
+
+template <typename SampleType, typename IOType>
+static void benchmarkDelayLinePrecision (size_t blockSize, size_t numChannels)
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) };
+
+    VariableDelayLine<SampleType> delayLine (4800);
+    delayLine.prepare (spec);
+    delayLine.setDelayInSamples (100.5f, 0, true);
+
+    auto buffer = BenchmarkHelpers::generateNoise<IOType> (numChannels, blockSize);
+
+    BenchmarkHelpers::benchmarkProcess (BenchmarkHelpers::getBenchmarkName ("VariableDelayLine" + BenchmarkHelpers::getPrecisionName (std::is_same<SampleType, double>::value, std::is_same<IOType, double>::value), blockSize, numChannels, false, 1),
+                                        delayLine,
+                                        buffer,
+                                        [] (size_t) {});
+}
+
+TEST_CASE ("Variable delay line precision", "[VariableDelayLine][precision]")
+{
+    const auto blockSize = GENERATE (from_range (BenchmarkHelpers::blockSizes()));
+    const auto numChannels = GENERATE (from_range (BenchmarkHelpers::channelCounts()));
+
+    benchmarkDelayLinePrecision<float, float> (blockSize, numChannels);
+    benchmarkDelayLinePrecision<double, float> (blockSize, numChannels);
+    benchmarkDelayLinePrecision<double, double> (blockSize, numChannels);
+}
@@ -0,0 +1,503 @@
+#include "BatchedProcessors.h"
+
+namespace Batched
+{
+    namespace
+    {
+        // the interleaved scratch holds this many samples per lane, longer blocks are split
+        constexpr size_t batchLength = 64;
+
+        // lanes without a channel in the block are processed as silence
+        template <typename IOType, typename SampleType>
+        void interleave (const juce::dsp::AudioBlock<IOType>& block, size_t start, size_t length, SampleType* destination, size_t numLanes)
+        {
+            const auto numChannels = juce::jmin (block.getNumChannels(), numLanes);
+
+            for (size_t ch = 0; ch < numChannels; ch++)
+            {
+                const auto* source = block.getChannelPointer (ch) + start;
+
+                for (size_t i = 0; i < length; i++)
+                    destination[i * numLanes + ch] = static_cast<SampleType> (source[i]);
+            }
+
+            for (size_t ch = numChannels; ch < numLanes; ch++)
+                for (size_t i = 0; i < length; i++)
+                    destination[i * numLanes + ch] = static_cast<SampleType> (0);
+        }
+
+        template <typename IOType, typename SampleType>
+        void deinterleave (const SampleType* source, size_t numLanes, const juce::dsp::AudioBlock<IOType>& block, size_t start, size_t length)
+        {
+            const auto numChannels = juce::jmin (block.getNumChannels(), numLanes);
+
+            for (size_t ch = 0; ch < numChannels; ch++)
+            {
+                auto* destination = block.getChannelPointer (ch) + start;
+
+                for (size_t i = 0; i < length; i++)
+                    destination[i] = static_cast<IOType> (source[i * numLanes + ch]);
+            }
+        }
+    } // namespace
+
+    template <typename SampleType>
+    void SmoothedValues<SampleType>::prepare (size_t numLanes, size_t maximumSteps, double sampleRate, double rampLengthInSeconds)
+    {
+        jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+
+        _values.resize (maximumSteps * numLanes);
+        _current.resize (numLanes);
+        _target.resize (numLanes);
+        _step.resize (numLanes);
+        _countdown.resize (numLanes);
+        _stepsToTarget = static_cast<int> (std::floor (rampLengthInSeconds * sampleRate));
+
+        reset();
+    }
+
+    template <typename SampleType>
+    void SmoothedValues<SampleType>::reset()
+    {
+        std::copy (_target.begin(), _target.end(), _current.begin());
+        std::fill (_countdown.begin(), _countdown.end(), 0);
+        _valuesAreTargets = false;
+    }
+
+    template <typename SampleType>
+    void SmoothedValues<SampleType>::setTargetValue (size_t lane, SampleType newValue)
+    {
+        jassert (lane < _target.size());
+
+        if (newValue == _target[lane])
+            return;
+
+        _valuesAreTargets = false;
+
+        if (_stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue (lane, newValue);
+            return;
+        }
+
+        _target[lane] = newValue;
+        _countdown[lane] = _stepsToTarget;
+        _step[lane] = (_target[lane] - _current[lane]) / static_cast<SampleType> (_countdown[lane]);
+    }
+
+    template <typename SampleType>
+    void SmoothedValues<SampleType>::setCurrentAndTargetValue (size_t lane, SampleType newValue)
+    {
+        jassert (lane < _target.size());
+
+        _target[lane] = _current[lane] = newValue;
+        _countdown[lane] = 0;
+        _valuesAreTargets = false;
+    }
+
+    template <typename SampleType>
+    SampleType SmoothedValues<SampleType>::getTargetValue (size_t lane) const
+    {
+        return _target[lane];
+    }
+
+    template <typename SampleType>
+    bool SmoothedValues<SampleType>::isSmoothing() const
+    {
+        return std::any_of (_countdown.begin(), _countdown.end(), [] (auto countdown) { return countdown > 0; });
+    }
+
+    template <typename SampleType>
+    const SampleType* SmoothedValues<SampleType>::getNextValues (const SimdKernels::Kernels<SampleType>& kernels, size_t numSteps)
+    {
+        const auto numLanes = _current.size();
+
+        jassert (numSteps * numLanes <= _values.size());
+
+        if (! _valuesAreTargets)
+        {
+            // settled lanes give their target on every step, so a full buffer of them stays valid
+            _valuesAreTargets = ! isSmoothing();
+            kernels.rampLanes (_current.data(), _target.data(), _step.data(), _countdown.data(), _values.data(), numLanes, _valuesAreTargets ? _values.size() / juce::jmax<size_t> (1, numLanes) : numSteps);
+        }
+
+        return _values.data();
+    }
+
+    template <typename SampleType>
+    Lowpass<SampleType>::Lowpass (size_t numInstances)
+        : _numInstances (numInstances),
+          _fc (numInstances, static_cast<SampleType> (-1.0))
+    {
+        jassert (numInstances > 0);
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert (spec.numChannels % _numInstances == 0);
+
+        const auto sampleRateChanged = spec.sampleRate != _fs;
+        const auto numLanes = static_cast<size_t> (spec.numChannels);
+
+        _channelsPerInstance = numLanes / _numInstances;
+
+        _b0.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _a1.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _zPole.assign (numLanes, 0.0);
+
+        _kernels = &SimdKernels::getKernels<SampleType>();
+        _samples.resize (batchLength * numLanes);
+
+        _fs = spec.sampleRate;
+
+        if (sampleRateChanged)
+            for (size_t k = 0; k < _numInstances; k++)
+                if (_fc[k] >= 0)
+                    setCutoffFrequency (k, _fc[k], true);
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::reset()
+    {
+        _b0.reset();
+        _a1.reset();
+        std::fill (_zPole.begin(), _zPole.end(), static_cast<SampleType> (0));
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::setCutoffFrequency (size_t instance, SampleType fc, bool force)
+    {
+        jassert (_fs > 0);
+        jassert (instance < _numInstances);
+
+        _fc[instance] = fc;
+        SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
+
+        for (auto lane = instance * _channelsPerInstance; lane < (instance + 1) * _channelsPerInstance; lane++)
+        {
+            if (force)
+            {
+                _a1.setCurrentAndTargetValue (lane, alpha);
+                _b0.setCurrentAndTargetValue (lane, static_cast<SampleType> (1.0 - alpha));
+            }
+            else
+            {
+                _a1.setTargetValue (lane, alpha);
+                _b0.setTargetValue (lane, static_cast<SampleType> (1.0 - alpha));
+            }
+        }
+    }
+
+    template <typename SampleType>
+    size_t Lowpass<SampleType>::getNumInstances() const
+    {
+        return _numInstances;
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    template <typename IOType>
+    void Lowpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
+    {
+        const auto numLanes = _zPole.size();
+        const auto numSamples = outputBlock.getNumSamples();
+
+        jassert (outputBlock.getNumChannels() == numLanes && inputBlock.getNumChannels() == numLanes);
+
+        for (size_t start = 0; start < numSamples; start += batchLength)
+        {
+            const auto length = juce::jmin (batchLength, numSamples - start);
+
+            interleave (inputBlock, start, length, _samples.data(), numLanes);
+
+            _kernels->onePoleLowpassLanes (_samples.data(), _b0.getNextValues (*_kernels, length), _a1.getNextValues (*_kernels, length), _zPole.data(), numLanes, length);
+
+            deinterleave (_samples.data(), numLanes, outputBlock, start, length);
+        }
+    }
+
+    template <typename SampleType>
+    Highpass<SampleType>::Highpass (size_t numInstances)
+        : _numInstances (numInstances),
+          _fc (numInstances, static_cast<SampleType> (-1.0))
+    {
+        jassert (numInstances > 0);
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert (spec.numChannels % _numInstances == 0);
+
+        const auto sampleRateChanged = spec.sampleRate != _fs;
+        const auto numLanes = static_cast<size_t> (spec.numChannels);
+
+        _channelsPerInstance = numLanes / _numInstances;
+
+        _b0.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _b1.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _a1.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _zPole.assign (numLanes, 0.0);
+        _zZero.assign (numLanes, 0.0);
+
+        _kernels = &SimdKernels::getKernels<SampleType>();
+        _samples.resize (batchLength * numLanes);
+
+        _fs = spec.sampleRate;
+
+        if (sampleRateChanged)
+            for (size_t k = 0; k < _numInstances; k++)
+                if (_fc[k] >= 0)
+                    setCutoffFrequency (k, _fc[k], true);
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::reset()
+    {
+        _b0.reset();
+        _b1.reset();
+        _a1.reset();
+        std::fill (_zPole.begin(), _zPole.end(), static_cast<SampleType> (0));
+        std::fill (_zZero.begin(), _zZero.end(), static_cast<SampleType> (0));
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::setCutoffFrequency (size_t instance, SampleType fc, bool force)
+    {
+        jassert (_fs > 0);
+        jassert (instance < _numInstances);
+
+        _fc[instance] = fc;
+        SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
+        SampleType b0 = static_cast<SampleType> ((1.0 + alpha) / 2.0);
+
+        for (auto lane = instance * _channelsPerInstance; lane < (instance + 1) * _channelsPerInstance; lane++)
+        {
+            if (force)
+            {
+                _a1.setCurrentAndTargetValue (lane, alpha);
+                _b0.setCurrentAndTargetValue (lane, b0);
+                _b1.setCurrentAndTargetValue (lane, -b0);
+            }
+            else
+            {
+                _a1.setTargetValue (lane, alpha);
+                _b0.setTargetValue (lane, b0);
+                _b1.setTargetValue (lane, -b0);
+            }
+        }
+    }
+
+    template <typename SampleType>
+    size_t Highpass<SampleType>::getNumInstances() const
+    {
+        return _numInstances;
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    template <typename IOType>
+    void Highpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
+    {
+        const auto numLanes = _zPole.size();
+        const auto numSamples = outputBlock.getNumSamples();
+
+        jassert (outputBlock.getNumChannels() == numLanes && inputBlock.getNumChannels() == numLanes);
+
+        for (size_t start = 0; start < numSamples; start += batchLength)
+        {
+            const auto length = juce::jmin (batchLength, numSamples - start);
+
+            interleave (inputBlock, start, length, _samples.data(), numLanes);
+
+            _kernels->onePoleHighpassLanes (_samples.data(),
+                                            _b0.getNextValues (*_kernels, length),
+                                            _b1.getNextValues (*_kernels, length),
+                                            _a1.getNextValues (*_kernels, length),
+                                            _zPole.data(),
+                                            _zZero.data(),
+                                            numLanes,
+                                            length);
+
+            deinterleave (_samples.data(), numLanes, outputBlock, start, length);
+        }
+    }
+
+    template <typename SampleType>
+    VariableDelayAllpass<SampleType>::VariableDelayAllpass (size_t numInstances, size_t maxDelayInSamples)
+        : _numInstances (numInstances),
+          _totalSize (juce::jmax<size_t> (4, maxDelayInSamples + 2))
+    {
+        jassert (numInstances > 0);
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert (spec.numChannels % _numInstances == 0);
+
+        const auto numLanes = static_cast<size_t> (spec.numChannels);
+
+        // the kernel indexes the buffer with 32 bit integers
+        jassert (_totalSize * numLanes <= static_cast<size_t> (std::numeric_limits<juce::int32>::max()));
+
+        _channelsPerInstance = numLanes / _numInstances;
+
+        _buffer.resize (_totalSize * numLanes);
+        _delayInSamples.prepare (numLanes, batchLength, spec.sampleRate, 0.05);
+        _gain.prepare (numLanes, 2 * batchLength, spec.sampleRate, 0.05);
+
+        _kernels = &SimdKernels::getKernels<SampleType>();
+        _samples.resize (batchLength * numLanes);
+        _taps.resize (numLanes);
+
+        reset();
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::reset()
+    {
+        std::fill (_buffer.begin(), _buffer.end(), static_cast<SampleType> (0));
+        _position = 0;
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::setDelayInSamples (size_t instance, SampleType newDelayInSamples, bool force)
+    {
+        jassert (instance < _numInstances);
+        jassert (newDelayInSamples < _totalSize - 2);
+
+        for (auto lane = instance * _channelsPerInstance; lane < (instance + 1) * _channelsPerInstance; lane++)
+        {
+            if (force)
+                _delayInSamples.setCurrentAndTargetValue (lane, newDelayInSamples);
+            else
+                _delayInSamples.setTargetValue (lane, newDelayInSamples);
+        }
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::setGain (size_t instance, SampleType newGain, bool force)
+    {
+        jassert (instance < _numInstances);
+
+        for (auto lane = instance * _channelsPerInstance; lane < (instance + 1) * _channelsPerInstance; lane++)
+        {
+            if (force)
+                _gain.setCurrentAndTargetValue (lane, newGain);
+            else
+                _gain.setTargetValue (lane, newGain);
+        }
+    }
+
+    template <typename SampleType>
+    size_t VariableDelayAllpass<SampleType>::getNumInstances() const
+    {
+        return _numInstances;
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    template <typename IOType>
+    void VariableDelayAllpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
+    {
+        const auto numLanes = _taps.size();
+        const auto numSamples = outputBlock.getNumSamples();
+        const auto maximumDelay = static_cast<SampleType> (_totalSize - 2);
+
+        jassert (outputBlock.getNumChannels() == numLanes && inputBlock.getNumChannels() == numLanes);
+
+        for (size_t start = 0; start < numSamples; start += batchLength)
+        {
+            const auto length = juce::jmin (batchLength, numSamples - start);
+
+            interleave (inputBlock, start, length, _samples.data(), numLanes);
+
+            const auto* delays = _delayInSamples.getNextValues (*_kernels, length);
+            const auto* gains = _gain.getNextValues (*_kernels, 2 * length);
+
+            _position = _kernels->allpassLanes (_samples.data(), _buffer.data(), _totalSize, _position, delays, gains, maximumDelay, _taps.data(), numLanes, length);
+
+            deinterleave (_samples.data(), numLanes, outputBlock, start, length);
+        }
+    }
+
+    template class SmoothedValues<float>;
+    template class SmoothedValues<double>;
+    template class Lowpass<float>;
+    template class Lowpass<double>;
+    template class Highpass<float>;
+    template class Highpass<double>;
+    template class VariableDelayAllpass<float>;
+    template class VariableDelayAllpass<double>;
+} // namespace Batched
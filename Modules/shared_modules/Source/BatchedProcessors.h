@@ -0,0 +1,151 @@
+#pragma once
+
+// Many instances of one processor, with the same topology but their own parameters and state,
+// advanced together: for a host running the same filter or allpass on dozens of tracks. Instance k
+// owns channels [k * C, (k + 1) * C) of the processed block, with C = spec.numChannels / numInstances,
+// and each of those channels is a lane. Samples, filter state, parameter ramps and delay memory are
+// interleaved by lane, [sample * numLanes + lane], so every step of a recursion is a vector operation
+// across the lanes instead of a serial loop per instance.
+//
+// Each lane performs the same arithmetic as the single instance processor, so the output is
+// bit-identical to that of numInstances OnePoleFilter or VariableDelayAllpass objects, ramps included.
+namespace Batched
+{
+    // One juce::LinearSmoothedValue per lane, stored as arrays so that the ramps of all lanes are
+    // advanced by a single kernel call. Once every lane has settled the values are filled with the
+    // targets only once, and reused until a parameter changes.
+    template <typename SampleType>
+    class SmoothedValues
+    {
+    public:
+        // new lanes start at zero, and every lane jumps to its target, as juce's reset() does
+        void prepare (size_t numLanes, size_t maximumSteps, double sampleRate, double rampLengthInSeconds);
+        void reset();
+
+        void setTargetValue (size_t lane, SampleType newValue);
+        void setCurrentAndTargetValue (size_t lane, SampleType newValue);
+        SampleType getTargetValue (size_t lane) const;
+        bool isSmoothing() const;
+
+        // numSteps getNextValue() calls per lane, laid out [step * numLanes + lane]
+        const SampleType* getNextValues (const SimdKernels::Kernels<SampleType>& kernels, size_t numSteps);
+
+    private:
+        std::vector<SampleType> _current;
+        std::vector<SampleType> _target;
+        std::vector<SampleType> _step;
+        std::vector<juce::int32> _countdown;
+        int _stepsToTarget = 0;
+
+        std::vector<SampleType> _values; // maximumSteps * numLanes
+        bool _valuesAreTargets = false;
+    };
+
+    template <typename SampleType = float>
+    class Lowpass : public MultiPrecisionProcessor
+    {
+    public:
+        explicit Lowpass (size_t numInstances);
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+        virtual void reset() override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+        void setCutoffFrequency (size_t instance, SampleType fc, bool force = false);
+
+        size_t getNumInstances() const;
+
+    private:
+        template <typename IOType>
+        void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+
+        size_t _numInstances;
+        size_t _channelsPerInstance = 0;
+
+        SmoothedValues<SampleType> _b0;
+        SmoothedValues<SampleType> _a1;
+        std::vector<SampleType> _zPole;
+        double _fs = 0.0;
+        std::vector<SampleType> _fc; // per instance, negative until a cutoff is set
+
+        const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+        std::vector<SampleType> _samples; // interleaved, batchLength samples of every lane
+    };
+
+    template <typename SampleType = float>
+    class Highpass : public MultiPrecisionProcessor
+    {
+    public:
+        explicit Highpass (size_t numInstances);
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+        virtual void reset() override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+        void setCutoffFrequency (size_t instance, SampleType fc, bool force = false);
+
+        size_t getNumInstances() const;
+
+    private:
+        template <typename IOType>
+        void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+
+        size_t _numInstances;
+        size_t _channelsPerInstance = 0;
+
+        SmoothedValues<SampleType> _b0;
+        SmoothedValues<SampleType> _b1;
+        SmoothedValues<SampleType> _a1;
+        std::vector<SampleType> _zPole;
+        std::vector<SampleType> _zZero;
+        double _fs = 0.0;
+        std::vector<SampleType> _fc;
+
+        const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+        std::vector<SampleType> _samples;
+    };
+
+    // Single tap VariableDelayAllpass instances sharing one interleaved delay buffer.
+    template <typename SampleType = float>
+    class VariableDelayAllpass : public MultiPrecisionProcessor
+    {
+    public:
+        VariableDelayAllpass (size_t numInstances, size_t maxDelayInSamples);
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+        virtual void reset() override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+        void setDelayInSamples (size_t instance, SampleType newDelayInSamples, bool force = false);
+        void setGain (size_t instance, SampleType newGain, bool force = false);
+
+        size_t getNumInstances() const;
+
+    private:
+        template <typename IOType>
+        void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+
+        size_t _numInstances;
+        size_t _channelsPerInstance = 0;
+        size_t _totalSize; // as in DelayBuffer, the maximum delay plus two
+
+        std::vector<SampleType> _buffer; // [position * numLanes + lane]
+        size_t _position = 0;
+
+        SmoothedValues<SampleType> _delayInSamples;
+        SmoothedValues<SampleType> _gain; // two values per sample, the gain is read twice
+
+        const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+        std::vector<SampleType> _samples;
+        std::vector<SampleType> _taps;
+    };
+} // namespace Batched
@@ -0,0 +1,84 @@
+#include "ChannelParallelProcessor.h"
+
+ChannelParallelProcessor::ChannelParallelProcessor (ProcessorFactory factory, size_t numThreads)
+    : _factory (std::move (factory)),
+      _workerPool (juce::jmax ((size_t) 1, numThreads) - 1)
+{
+}
+
+void ChannelParallelProcessor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    const auto numChannels = static_cast<size_t> (spec.numChannels);
+    const auto numGroups = juce::jmax ((size_t) 1, juce::jmin (_workerPool.getNumThreads(), numChannels));
+
+    _channelsPerGroup = (numChannels + numGroups - 1) / numGroups;
+
+    while (_processors.size() < numGroups)
+        _processors.push_back (_factory());
+
+    _processors.resize (numGroups);
+
+    for (size_t g = 0; g < numGroups; g++)
+    {
+        const auto firstChannel = g * _channelsPerGroup;
+        const auto groupChannels = juce::jmin (_channelsPerGroup, numChannels - juce::jmin (firstChannel, numChannels));
+
+        _processors[g]->prepare ({ spec.sampleRate, spec.maximumBlockSize, static_cast<juce::uint32> (juce::jmax ((size_t) 1, groupChannels)) });
+    }
+}
+
+void ChannelParallelProcessor::reset()
+{
+    for (auto& processor : _processors)
+        processor->reset();
+}
+
+void ChannelParallelProcessor::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    _currentBlock = context.getOutputBlock();
+
+    const auto numChannelSamples = _currentBlock.getNumChannels() * _currentBlock.getNumSamples();
+
+    if (_processors.size() == 1 || numChannelSamples < _parallelThreshold)
+    {
+        for (size_t g = 0; g < _processors.size(); g++)
+            processGroup (this, g);
+    }
+    else
+    {
+        _workerPool.run (&ChannelParallelProcessor::processGroup, this, _processors.size());
+    }
+}
+
+void ChannelParallelProcessor::setParallelThreshold (size_t numChannelSamples)
+{
+    _parallelThreshold = numChannelSamples;
+}
+
+size_t ChannelParallelProcessor::getNumGroups() const
+{
+    return _processors.size();
+}
+
+juce::dsp::ProcessorBase& ChannelParallelProcessor::getProcessor (size_t groupIndex)
+{
+    jassert (groupIndex < _processors.size());
+
+    return *_processors[groupIndex];
+}
+
+void ChannelParallelProcessor::processGroup (void* context, size_t groupIndex)
+{
+    auto& self = *static_cast<ChannelParallelProcessor*> (context);
+
+    const auto numChannels = self._currentBlock.getNumChannels();
+    const auto firstChannel = groupIndex * self._channelsPerGroup;
+
+    if (firstChannel >= numChannels)
+        return;
+
+    auto groupBlock = self._currentBlock.getSubsetChannelBlock (firstChannel, juce::jmin (self._channelsPerGroup, numChannels - firstChannel));
+    juce::dsp::ProcessContextReplacing<float> groupContext (groupBlock);
+
+    self._processors[groupIndex]->process (groupContext);
+}
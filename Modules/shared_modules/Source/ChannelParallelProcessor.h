@@ -0,0 +1,42 @@
+#pragma once
+
+class ChannelParallelProcessor : public juce::dsp::ProcessorBase
+{
+public:
+    using ProcessorFactory = std::function<std::unique_ptr<juce::dsp::ProcessorBase>()>;
+
+    // Splits the channels in up to numThreads groups, each one processed by its own processor
+    // instance created by the factory. Group 0 runs on the calling thread.
+    ChannelParallelProcessor (ProcessorFactory factory, size_t numThreads);
+
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+
+    // blocks with fewer channel samples than this are processed on the calling thread only
+    void setParallelThreshold (size_t numChannelSamples);
+
+    size_t getNumGroups() const;
+    juce::dsp::ProcessorBase& getProcessor (size_t groupIndex);
+
+    template <typename ProcessorType, typename Function>
+    void forEachProcessor (Function&& function)
+    {
+        for (auto& processor : _processors)
+        {
+            // the factory decides the type, so this only checks the caller asked for the right one
+            jassert (dynamic_cast<ProcessorType*> (processor.get()) != nullptr);
+            function (static_cast<ProcessorType&> (*processor));
+        }
+    }
+
+private:
+    static void processGroup (void* context, size_t groupIndex);
+
+    ProcessorFactory _factory;
+    RealtimeWorkerPool _workerPool;
+    std::vector<std::unique_ptr<juce::dsp::ProcessorBase>> _processors;
+    size_t _channelsPerGroup = 0;
+    size_t _parallelThreshold = 2048;
+    juce::dsp::AudioBlock<float> _currentBlock;
+};
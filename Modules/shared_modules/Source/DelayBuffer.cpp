@@ -0,0 +1,270 @@
+#include "DelayBuffer.h"
+
+namespace
+{
+    template <typename SampleType>
+    size_t getSamplesPerPage()
+    {
+        return juce::jmax<size_t> (1, ReservedMemory::getPageSize() / sizeof (SampleType));
+    }
+} // namespace
+
+template <typename SampleType>
+DelayBuffer<SampleType>::DelayBuffer (size_t maximumDelayInSamples, DelayMemory memory)
+    : _totalSize (juce::jmax<size_t> (4, maximumDelayInSamples + 2)),
+      _ringSize (memory == DelayMemory::reserved ? juce::jmin (_totalSize, getSamplesPerPage<SampleType>()) : _totalSize),
+      _stride (_totalSize),
+      _memory (memory)
+{
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    _numChannels = spec.numChannels;
+
+    if (_memory == DelayMemory::reserved)
+    {
+        const auto samplesPerPage = getSamplesPerPage<SampleType>();
+        _stride = (_totalSize + samplesPerPage - 1) / samplesPerPage * samplesPerPage;
+
+        const auto numBytes = _numChannels * _stride * sizeof (SampleType);
+
+        if ((_reservedBuffer.getSize() >= numBytes || _reservedBuffer.reserve (numBytes)) && commitRing (0, _ringSize))
+        {
+            _samples = static_cast<SampleType*> (_reservedBuffer.getData());
+        }
+        else
+        {
+            // out of address space or memory, keep working with the whole maximum allocated
+            jassertfalse;
+            _reservedBuffer.release();
+            _memory = DelayMemory::allocated;
+            _ringSize = _totalSize;
+            _stride = _totalSize;
+        }
+    }
+
+    if (_memory == DelayMemory::allocated)
+    {
+        // resize() keeps the capacity, so shrinking and growing back does not reallocate
+        _buffer.resize (_numChannels * _totalSize);
+        _samples = _buffer.data();
+    }
+
+    _writePos.resize (_numChannels);
+    _readPos.resize (_numChannels);
+    _kernels = &SimdKernels::getKernels<SampleType>();
+
+    reset();
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::reset()
+{
+    for (size_t ch = 0; ch < _numChannels; ch++)
+        std::fill (_samples + ch * _stride, _samples + ch * _stride + _ringSize, static_cast<SampleType> (0));
+
+    std::fill (_writePos.begin(), _writePos.end(), 0);
+    std::fill (_readPos.begin(), _readPos.end(), 0);
+}
+
+template <typename SampleType>
+bool DelayBuffer<SampleType>::commitDelay (size_t delayInSamples)
+{
+    // the interpolated read reaches one sample past the delay, and the ring keeps one free
+    if (delayInSamples + 2 <= _ringSize)
+        return true;
+
+    const auto samplesPerPage = getSamplesPerPage<SampleType>();
+    const auto newRingSize = juce::jmin (_totalSize, (delayInSamples + 2 + samplesPerPage - 1) / samplesPerPage * samplesPerPage);
+    const auto growth = newRingSize - _ringSize;
+
+    // nothing moves unless every channel has its pages, otherwise delays stay clamped to the old ring
+    if (! commitRing (_ringSize, newRingSize))
+        return false;
+
+    for (size_t ch = 0; ch < _numChannels; ch++)
+    {
+        auto* samples = _samples + ch * _stride;
+        auto& writePos = _writePos[ch];
+        auto& readPos = _readPos[ch];
+
+        // between blocks the read pointer is back where the next sample goes
+        jassert (readPos == writePos);
+
+        // the write pointer moves down, so the samples past it are the newest; they move to the end
+        // of the new ring to stay next to the write position, and the gap they leave reads as the
+        // silence before the oldest one
+        std::move_backward (samples + writePos + 1, samples + _ringSize, samples + newRingSize);
+        std::fill (samples + writePos + 1, samples + writePos + 1 + growth, static_cast<SampleType> (0));
+
+        if (readPos >= writePos)
+            readPos += growth;
+
+        writePos += growth;
+    }
+
+    _ringSize = newRingSize;
+
+    return true;
+}
+
+template <typename SampleType>
+bool DelayBuffer<SampleType>::commitRing (size_t begin, size_t end)
+{
+    for (size_t ch = 0; ch < _numChannels; ch++)
+        if (! _reservedBuffer.commit ((ch * _stride + begin) * sizeof (SampleType), (end - begin) * sizeof (SampleType)))
+            return false;
+
+    return true;
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::pushSample (size_t channel, SampleType sample)
+{
+    jassert (channel < _numChannels);
+
+    auto& writePos = _writePos[channel];
+    _samples[channel * _stride + writePos] = sample;
+    writePos = (writePos == 0 ? _ringSize : writePos) - 1;
+}
+
+template <typename SampleType>
+SampleType DelayBuffer<SampleType>::popSample (size_t channel, SampleType delayInSamples, bool updateReadPointer)
+{
+    jassert (channel < _numChannels);
+
+    const auto delay = juce::jlimit (static_cast<SampleType> (0), static_cast<SampleType> (getCommittedDelayInSamples()), delayInSamples);
+    // not negative after the clamp, so truncation is floor without the libm call
+    const auto delayInt = static_cast<size_t> (delay);
+    const auto delayFrac = delay - static_cast<SampleType> (delayInt);
+
+    auto& readPos = _readPos[channel];
+
+    // readPos + delayInt < 2 * ringSize, so a single subtraction wraps both indices
+    auto index1 = readPos + delayInt;
+    auto index2 = index1 + 1;
+
+    if (index2 >= _ringSize)
+    {
+        index2 -= _ringSize;
+
+        if (index1 >= _ringSize)
+            index1 -= _ringSize;
+    }
+
+    const auto* samples = _samples + channel * _stride;
+    const auto value1 = samples[index1];
+    const auto value2 = samples[index2];
+
+    if (updateReadPointer)
+        readPos = (readPos == 0 ? _ringSize : readPos) - 1;
+
+    return value1 + delayFrac * (value2 - value1);
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::pushBlock (size_t channel, const SampleType* samples, size_t numSamples)
+{
+    jassert (channel < _numChannels);
+
+    auto* buffer = _samples + channel * _stride;
+    auto writePos = _writePos[channel];
+
+    for (size_t i = 0; i < numSamples; i++)
+    {
+        buffer[writePos] = samples[i];
+        writePos = (writePos == 0 ? _ringSize : writePos) - 1;
+    }
+
+    _writePos[channel] = writePos;
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::readBlock (size_t channel, const SampleType* delays, SampleType* output, size_t numSamples) const
+{
+    jassert (channel < _numChannels);
+    jassert (numSamples < _ringSize);
+
+    _kernels->readInterpolated (_samples + channel * _stride, _ringSize, _readPos[channel], delays, static_cast<SampleType> (getCommittedDelayInSamples()), output, numSamples);
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::advanceReadPointer (size_t channel, size_t numSamples)
+{
+    jassert (channel < _numChannels);
+    jassert (numSamples < _ringSize);
+
+    auto& readPos = _readPos[channel];
+    readPos = readPos >= numSamples ? readPos - numSamples : readPos + _ringSize - numSamples;
+}
+
+template <typename SampleType>
+size_t DelayBuffer<SampleType>::getMaximumDelayInSamples() const
+{
+    return _totalSize - 2;
+}
+
+template <typename SampleType>
+size_t DelayBuffer<SampleType>::getCommittedDelayInSamples() const
+{
+    return _ringSize - 2;
+}
+
+template <typename SampleType>
+size_t DelayBuffer<SampleType>::getResidentBytes() const
+{
+    if (_memory == DelayMemory::allocated)
+        return _numChannels * _totalSize * sizeof (SampleType);
+
+    return _reservedBuffer.getResidentBytes (0, _numChannels * _stride * sizeof (SampleType));
+}
+
+template <typename SampleType>
+size_t DelayBuffer<SampleType>::getNumChannels() const
+{
+    return _numChannels;
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::saveState (StateWriter& writer) const
+{
+    writer.writeTag ("DBUF");
+    writer.write (static_cast<juce::uint64> (_totalSize));
+    writer.write (static_cast<juce::uint64> (_ringSize));
+
+    for (size_t ch = 0; ch < _numChannels; ch++)
+        writer.writeArray (_samples + ch * _stride, _ringSize);
+
+    writer.writeArray (_writePos);
+    writer.writeArray (_readPos);
+}
+
+template <typename SampleType>
+bool DelayBuffer<SampleType>::restoreState (StateReader& reader)
+{
+    juce::uint64 totalSize = 0;
+    juce::uint64 ringSize = 0;
+
+    if (! reader.readTag ("DBUF") || ! reader.read (totalSize) || totalSize != _totalSize || ! reader.read (ringSize))
+        return false;
+
+    // a reserved ring takes whatever length was saved, an allocated one is always the whole maximum
+    if (ringSize < 4 || ringSize > _totalSize || (_memory == DelayMemory::allocated && ringSize != _ringSize))
+        return false;
+
+    if (ringSize > _ringSize && ! commitRing (_ringSize, static_cast<size_t> (ringSize)))
+        return false;
+
+    _ringSize = static_cast<size_t> (ringSize);
+
+    for (size_t ch = 0; ch < _numChannels; ch++)
+        if (! reader.readArray (_samples + ch * _stride, _ringSize))
+            return false;
+
+    return reader.readArray (_writePos) && reader.readArray (_readPos);
+}
+
+template class DelayBuffer<float>;
+template class DelayBuffer<double>;
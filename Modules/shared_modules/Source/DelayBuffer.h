@@ -0,0 +1,70 @@
+#pragma once
+
+// Multichannel circular buffer with the exact sample-by-sample behaviour of
+// juce::dsp::DelayLine<SampleType, Linear>, used by the delay processors. Memory is only allocated
+// by prepare() and only when the new spec needs more than is already there, so hosts can re-prepare
+// hundreds of instances without touching the allocator. Wrapping uses compares instead of modulo.
+//
+// With DelayMemory::reserved the maximum is only reserved as address space. The buffer then wraps
+// around a ring just long enough for the delays committed with commitDelay(), and the pages past it
+// are never touched, so resident memory follows the delays in use rather than the maximum. Growing
+// the ring keeps the samples it held, so a delay that ramps up by at most a sample per sample reads
+// exactly what an allocated buffer would. A delay that jumps further back reads silence until the
+// line has filled up to it.
+enum class DelayMemory
+{
+    allocated,
+    reserved,
+};
+
+template <typename SampleType = float>
+class DelayBuffer
+{
+public:
+    explicit DelayBuffer (size_t maximumDelayInSamples, DelayMemory memory = DelayMemory::allocated);
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void pushSample (size_t channel, SampleType sample);
+    // the delay is clamped to [0, getMaximumDelayInSamples()]
+    SampleType popSample (size_t channel, SampleType delayInSamples, bool updateReadPointer = true);
+
+    // Block versions of the above, equivalent to numSamples single-sample calls as long as the
+    // caller keeps every read clear of the samples written in the same block. readBlock() does not
+    // move the read pointer, delays[i] is the delay of the i-th sample.
+    void pushBlock (size_t channel, const SampleType* samples, size_t numSamples);
+    void readBlock (size_t channel, const SampleType* delays, SampleType* output, size_t numSamples) const;
+    void advanceReadPointer (size_t channel, size_t numSamples);
+
+    // Makes delays up to delayInSamples readable. Only reserved memory needs it: the ring grows,
+    // never shrinks, and the pages it grows into are committed and written here rather than on first
+    // use. That is a system call and a pass over the ring, so like prepare() it belongs on the message
+    // thread while nothing is processing. Returns false, leaving the ring as it was, if the memory
+    // cannot be committed; longer delays are then clamped.
+    bool commitDelay (size_t delayInSamples);
+
+    size_t getMaximumDelayInSamples() const;
+    // the longest delay read without clamping, getMaximumDelayInSamples() unless the memory is reserved
+    size_t getCommittedDelayInSamples() const;
+    size_t getResidentBytes() const;
+    size_t getNumChannels() const;
+
+    void saveState (StateWriter& writer) const;
+    bool restoreState (StateReader& reader);
+
+private:
+    bool commitRing (size_t begin, size_t end);
+
+    size_t _totalSize;
+    size_t _ringSize; // the part of each channel in use, all of it unless the memory is reserved
+    size_t _stride;   // between channels, whole pages when reserved
+    DelayMemory _memory;
+    size_t _numChannels = 0;
+    std::vector<SampleType> _buffer;
+    ReservedMemory _reservedBuffer;
+    SampleType* _samples = nullptr; // [channel * stride + index], in one of the two above
+    std::vector<size_t> _writePos;
+    std::vector<size_t> _readPos;
+    const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+};
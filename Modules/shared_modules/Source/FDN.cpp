@@ -0,0 +1,279 @@
+#include "FDN.h"
+
+template <size_t N, typename SampleType>
+FDN<N, SampleType>::FDN (size_t maxDelayInSamples, size_t modulationUpdateRate)
+    : _modulationUpdateRate (modulationUpdateRate)
+{
+    _lines.reserve (N);
+    _modulators.reserve (N);
+
+    for (size_t n = 0; n < N; n++)
+    {
+        _lines.emplace_back (maxDelayInSamples);
+        _delayInSamples[n] = static_cast<SampleType> ((maxDelayInSamples - 1) * (N + n) / (4 * N));
+
+        _modulators.emplace_back (_oscillators[n], modulationUpdateRate);
+        _modulators[n].setModulationWaveform (OscillatorWrapper::Sine);
+        _modulators[n].setModulationTarget ([this, n] (SampleType value)
+                                            {
+                                                if (_modulationFrequency != 0.0f && _modulationDepth > 0)
+                                                    _lines[n].setDelayInSamples (value);
+                                            });
+    }
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    // every line is a single channel delay; the modulators never touch audio
+    juce::dsp::ProcessSpec lineSpec{ spec.sampleRate, spec.maximumBlockSize, 1 };
+
+    for (size_t n = 0; n < N; n++)
+    {
+        _lines[n].prepare (lineSpec);
+        _lines[n].setDelayInSamples (_delayInSamples[n], 0, true);
+        _modulators[n].prepare (lineSpec);
+    }
+
+    _damping.prepare ({ spec.sampleRate, spec.maximumBlockSize, static_cast<juce::uint32> (N) });
+    _feedback.reset (spec.sampleRate, 0.05);
+    _outputMix.prepare (spec.sampleRate);
+
+    _sampleRate = spec.sampleRate;
+    setDampingFrequency (_dampingFrequency, true);
+
+    // channel c reads the lines through row c + 1 of the Hadamard matrix, skipping the all-ones row
+    _outputGains.resize (spec.numChannels);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+    {
+        const auto row = ch % (N - 1) + 1;
+
+        for (size_t n = 0; n < N; n++)
+            _outputGains[ch][n] = static_cast<SampleType> ((juce::countNumberOfBits (static_cast<juce::uint32> (row & n)) % 2 == 0 ? 1.0 : -1.0) / std::sqrt (static_cast<double> (N)));
+    }
+
+    reset();
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::reset()
+{
+    for (size_t n = 0; n < N; n++)
+    {
+        _lines[n].reset();
+        _modulators[n].reset();
+    }
+
+    _damping.reset();
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <size_t N, typename SampleType>
+OutputMix<SampleType>& FDN<N, SampleType>::getOutputMix()
+{
+    return _outputMix;
+}
+
+template <size_t N, typename SampleType>
+template <typename IOType>
+void FDN<N, SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
+{
+    const auto numSamples = outputBlock.getNumSamples();
+
+    jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels() && inputBlock.getNumSamples() == numSamples);
+
+    _outputMix.beginBlock (numSamples);
+
+    // the modulators are clocked alongside the audio, so delays move at their update rate
+    for (size_t pos = 0; pos < numSamples; pos += _modulationUpdateRate)
+    {
+        const auto length = juce::jmin (_modulationUpdateRate, numSamples - pos);
+        auto subBlock = outputBlock.getSubBlock (pos, length);
+
+        processSubBlock (inputBlock.getSubBlock (pos, length), subBlock, pos);
+
+        for (auto& modulator : _modulators)
+            modulator.process (juce::dsp::ProcessContextReplacing<IOType> (subBlock));
+    }
+}
+
+template <size_t N, typename SampleType>
+template <typename IOType>
+void FDN<N, SampleType>::processSubBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock, size_t offset)
+{
+    const auto numChannels = outputBlock.getNumChannels();
+    const auto numSamples = outputBlock.getNumSamples();
+    const auto inputGain = static_cast<SampleType> (1.0 / static_cast<double> (numChannels));
+
+    std::array<SampleType, N> lines;
+
+    for (size_t i = 0; i < numSamples; i++)
+    {
+        SampleType input = 0;
+
+        for (size_t ch = 0; ch < numChannels; ch++)
+            input += static_cast<SampleType> (inputBlock.getChannelPointer (ch)[i]);
+
+        input *= inputGain;
+
+        for (size_t n = 0; n < N; n++)
+            lines[n] = _damping.processSample (n, _lines[n].popSample (0));
+
+        for (size_t ch = 0; ch < numChannels; ch++)
+        {
+            SampleType out = 0;
+
+            for (size_t n = 0; n < N; n++)
+                out += _outputGains[ch][n] * lines[n];
+
+            outputBlock.getChannelPointer (ch)[i] = _outputMix.mixSample (inputBlock.getChannelPointer (ch)[i], out, offset + i);
+        }
+
+        const auto feedback = _feedback.getNextValue();
+
+        applyMixingMatrix (_mixingMatrix, lines);
+
+        for (size_t n = 0; n < N; n++)
+            _lines[n].pushSample (0, input + feedback * lines[n]);
+    }
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::applyMixingMatrix (MixingMatrix matrix, std::array<SampleType, N>& lines)
+{
+    if (matrix == MixingMatrix::Hadamard)
+    {
+        // fast Walsh-Hadamard transform: N log2(N) additions on values that stay in registers
+        for (size_t h = 1; h < N; h *= 2)
+            for (size_t i = 0; i < N; i += 2 * h)
+                for (size_t j = i; j < i + h; j++)
+                {
+                    const auto a = lines[j];
+                    const auto b = lines[j + h];
+                    lines[j] = a + b;
+                    lines[j + h] = a - b;
+                }
+
+        const auto scale = static_cast<SampleType> (1.0 / std::sqrt (static_cast<double> (N)));
+
+        for (auto& line : lines)
+            line *= scale;
+    }
+    else
+    {
+        // I - 2/N * ones, a reflection about the all-ones vector
+        SampleType sum = 0;
+
+        for (auto& line : lines)
+            sum += line;
+
+        sum *= static_cast<SampleType> (2.0 / N);
+
+        for (auto& line : lines)
+            line -= sum;
+    }
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setDelayInSamples (SampleType newDelayInSamples, size_t lineIndex, bool force)
+{
+    jassert (lineIndex < N);
+    jassert (newDelayInSamples - _modulationDepth >= 1);
+    jassert (newDelayInSamples + _modulationDepth < _lines[lineIndex].getMaximumDelayInSamples());
+
+    _delayInSamples[lineIndex] = newDelayInSamples;
+    _lines[lineIndex].setDelayInSamples (newDelayInSamples, 0, force);
+
+    updateModulationRange (lineIndex);
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setFeedback (SampleType newFeedback, bool force)
+{
+    jassert (std::abs (newFeedback) <= 1);
+
+    if (force)
+        _feedback.setCurrentAndTargetValue (newFeedback);
+    else
+        _feedback.setTargetValue (newFeedback);
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setDampingFrequency (SampleType newFrequency, bool force)
+{
+    _dampingFrequency = newFrequency;
+
+    if (_sampleRate > 0)
+        _damping.setCutoffFrequency (newFrequency, force);
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setModulation (float newFrequency, SampleType newDepthInSamples)
+{
+    _modulationFrequency = newFrequency;
+    _modulationDepth = newDepthInSamples;
+
+    for (size_t n = 0; n < N; n++)
+    {
+        _modulators[n].setModulationFrequency (newFrequency * (0.75f + 0.5f * static_cast<float> (n) / (N - 1)));
+        updateModulationRange (n);
+
+        if (newFrequency == 0.0f || newDepthInSamples <= 0)
+            _lines[n].setDelayInSamples (_delayInSamples[n]);
+    }
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setMixingMatrix (MixingMatrix newMatrix)
+{
+    _mixingMatrix = newMatrix;
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::setParameters (const Parameters& parameters, bool force)
+{
+    setModulation (parameters.modulationFrequency, parameters.modulationDepthInSamples);
+
+    for (size_t n = 0; n < N; n++)
+        setDelayInSamples (parameters.delayInSamples[n], n, force);
+
+    setFeedback (parameters.feedback, force);
+    setDampingFrequency (parameters.dampingFrequency, force);
+}
+
+template <size_t N, typename SampleType>
+void FDN<N, SampleType>::updateModulationRange (size_t lineIndex)
+{
+    _modulators[lineIndex].setModulationRange ({ _delayInSamples[lineIndex] - _modulationDepth, _delayInSamples[lineIndex] + _modulationDepth });
+}
+
+template class FDN<4, float>;
+template class FDN<4, double>;
+template class FDN<8, float>;
+template class FDN<8, double>;
+template class FDN<16, float>;
+template class FDN<16, double>;
@@ -0,0 +1,80 @@
+#pragma once
+
+// Feedback delay network with N lines. The input is summed to mono and fed to every line; each
+// output channel reads the lines through its own row of signs, so channels are decorrelated.
+// Every line is a VariableDelayLine with a one-pole lowpass in its feedback path and an LFO
+// from a ProcessorModulator swinging its delay around the base value.
+template <size_t N, typename SampleType = float>
+class FDN : public MultiPrecisionProcessor
+{
+public:
+    static_assert (N == 4 || N == 8 || N == 16, "FDN supports 4, 8 or 16 lines");
+
+    enum class MixingMatrix
+    {
+        Hadamard,
+        Householder
+    };
+
+    struct Parameters
+    {
+        std::array<SampleType, N> delayInSamples{};
+        SampleType feedback = 0.0;
+        SampleType dampingFrequency = 8000.0;
+        float modulationFrequency = 0.0f;
+        SampleType modulationDepthInSamples = 0.0;
+    };
+
+    FDN (size_t maxDelayInSamples, size_t modulationUpdateRate = 32);
+
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+    // delays must be at least one sample, plus the modulation depth
+    void setDelayInSamples (SampleType newDelayInSamples, size_t lineIndex, bool force = false);
+    void setFeedback (SampleType newFeedback, bool force = false);
+    void setDampingFrequency (SampleType newFrequency, bool force = false);
+    // each line runs at a slightly different rate around newFrequency
+    void setModulation (float newFrequency, SampleType newDepthInSamples);
+    void setMixingMatrix (MixingMatrix newMatrix);
+    void setParameters (const Parameters& parameters, bool force = false);
+
+    // dry/wet and output gain, applied as the network output is written; the dry signal is each
+    // channel's own input
+    OutputMix<SampleType>& getOutputMix();
+
+    // orthogonal, so the network is lossless with feedback 1 and no damping
+    static void applyMixingMatrix (MixingMatrix matrix, std::array<SampleType, N>& lines);
+
+private:
+    template <typename IOType>
+    void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+
+    // offset is the sub-block's position in the block
+    template <typename IOType>
+    void processSubBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock, size_t offset);
+
+    void updateModulationRange (size_t lineIndex);
+
+    std::vector<VariableDelayLine<SampleType>> _lines;
+    std::array<OscillatorWrapper, N> _oscillators;
+    std::vector<ProcessorModulator<SampleType>> _modulators;
+    OnePoleFilter::Lowpass<SampleType> _damping;
+    juce::LinearSmoothedValue<SampleType> _feedback;
+    std::vector<std::array<SampleType, N>> _outputGains;
+    OutputMix<SampleType> _outputMix;
+
+    std::array<SampleType, N> _delayInSamples{};
+    SampleType _dampingFrequency = 8000.0;
+    float _modulationFrequency = 0.0f;
+    SampleType _modulationDepth = 0.0;
+    MixingMatrix _mixingMatrix = MixingMatrix::Hadamard;
+    size_t _modulationUpdateRate;
+    double _sampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE (FDN)
+};
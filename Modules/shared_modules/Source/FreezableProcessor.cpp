@@ -0,0 +1,273 @@
+#include "FreezableProcessor.h"
+
+namespace
+{
+    // -120 dB
+    constexpr float silenceThreshold = 1.0e-6f;
+} // namespace
+
+FreezableProcessor::FreezableProcessor (ProcessorFactory factory, size_t maxImpulseResponseLength, size_t partitionSize)
+    : _factory (std::move (factory)),
+      _live (_factory()),
+      _maxImpulseResponseLength (maxImpulseResponseLength),
+      _partitionSize (partitionSize)
+{
+    jassert (_maxImpulseResponseLength > 0);
+}
+
+FreezableProcessor::~FreezableProcessor()
+{
+    delete _active;
+    delete _pending.exchange (nullptr);
+    delete _retired.exchange (nullptr);
+}
+
+void FreezableProcessor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    _spec = spec;
+    _live->prepare (spec);
+
+    _frozen = false;
+    delete _active;
+    _active = nullptr;
+    _retiring = false;
+    releaseUnusedConvolvers();
+
+    _input.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize), false, false, true);
+    _wet.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize), false, false, true);
+    _mixStep = static_cast<float> (1.0 / juce::jmax (1.0, _crossfadeTime * spec.sampleRate));
+
+    reset();
+}
+
+void FreezableProcessor::reset()
+{
+    _live->reset();
+    _liveRunning = true;
+
+    if (_active != nullptr)
+    {
+        _active->reset();
+        _warmUpRemaining = _retiring ? 0 : _active->getImpulseResponseLength();
+    }
+
+    _tailRemaining = 0;
+
+    _mix = 0.0f;
+}
+
+void FreezableProcessor::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = block.getNumChannels();
+    const auto frozen = _frozen.load();
+
+    if (_active != nullptr && ! _retiring && (! frozen || _pending.load() != nullptr))
+        beginRetiring();
+
+    if (_active == nullptr && frozen)
+    {
+        if (auto* next = _pending.exchange (nullptr))
+        {
+            _active = next;
+            _active->reset();
+            _warmUpRemaining = _active->getImpulseResponseLength();
+            _mix = 0.0f;
+        }
+    }
+
+    if (_active == nullptr)
+    {
+        if (! _liveRunning)
+            _live->reset();
+
+        _liveRunning = true;
+        _live->process (context);
+        return;
+    }
+
+    jassert (numChannels == _active->getNumChannels());
+
+    auto input = juce::dsp::AudioBlock<float> (_input).getSubsetChannelBlock (0, numChannels).getSubBlock (0, numSamples);
+    auto wet = juce::dsp::AudioBlock<float> (_wet).getSubsetChannelBlock (0, numChannels).getSubBlock (0, numSamples);
+
+    if (_retiring)
+    {
+        // the live processor only hears what came after the unfreeze, the convolver adds the tail of
+        // what came before, so together they continue the frozen output
+        _live->process (context);
+
+        if (_tailRemaining > 0)
+        {
+            input.clear();
+            _active->process (input, wet);
+            block.add (wet);
+            _tailRemaining -= juce::jmin (_tailRemaining, numSamples);
+        }
+
+        if (_tailRemaining == 0)
+            retireActiveConvolver();
+
+        return;
+    }
+
+    const auto runLive = _warmUpRemaining > 0 || _mix < 1.0f;
+
+    if (runLive && ! _liveRunning)
+        _live->reset();
+
+    _liveRunning = runLive;
+
+    input.copyFrom (block);
+    _active->process (input, wet);
+
+    if (! runLive)
+    {
+        block.copyFrom (wet);
+        return;
+    }
+
+    _live->process (context);
+
+    if (_warmUpRemaining > 0)
+    {
+        _warmUpRemaining -= juce::jmin (_warmUpRemaining, numSamples);
+        return;
+    }
+
+    auto mix = _mix;
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        auto* out = block.getChannelPointer (ch);
+        const auto* frozenOut = wet.getChannelPointer (ch);
+        mix = _mix;
+
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            mix = juce::jmin (1.0f, mix + _mixStep);
+            out[i] += mix * (frozenOut[i] - out[i]);
+        }
+    }
+
+    _mix = mix;
+}
+
+void FreezableProcessor::freeze()
+{
+    jassert (_spec.sampleRate > 0.0);
+
+    releaseUnusedConvolvers();
+
+    _impulseResponse = captureImpulseResponse();
+
+    delete _pending.exchange (new PartitionedConvolver (_impulseResponse, _spec.numChannels, _partitionSize));
+    _frozen = true;
+}
+
+void FreezableProcessor::unfreeze()
+{
+    _frozen = false;
+}
+
+bool FreezableProcessor::isFrozen() const
+{
+    return _frozen;
+}
+
+void FreezableProcessor::setCrossfadeTime (double seconds)
+{
+    // takes effect on the next prepare
+    _crossfadeTime = seconds;
+}
+
+void FreezableProcessor::releaseUnusedConvolvers()
+{
+    delete _retired.exchange (nullptr);
+
+    if (! _frozen)
+        delete _pending.exchange (nullptr);
+}
+
+juce::dsp::ProcessorBase& FreezableProcessor::getLiveProcessor()
+{
+    return *_live;
+}
+
+const juce::AudioBuffer<float>& FreezableProcessor::getImpulseResponse() const
+{
+    return _impulseResponse;
+}
+
+juce::AudioBuffer<float> FreezableProcessor::captureImpulseResponse()
+{
+    auto capture = _factory();
+    capture->prepare (_spec);
+
+    const auto numChannels = static_cast<int> (_spec.numChannels);
+    const auto length = static_cast<int> (_maxImpulseResponseLength);
+    const auto blockSize = static_cast<int> (juce::jmax<juce::uint32> (1, _spec.maximumBlockSize));
+
+    juce::AudioBuffer<float> impulseResponse (numChannels, length);
+    impulseResponse.clear();
+
+    for (auto ch = 0; ch < numChannels; ch++)
+        impulseResponse.setSample (ch, 0, 1.0f);
+
+    for (auto start = 0; start < length; start += blockSize)
+    {
+        auto block = juce::dsp::AudioBlock<float> (impulseResponse).getSubBlock (static_cast<size_t> (start), static_cast<size_t> (juce::jmin (blockSize, length - start)));
+        capture->process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+
+    auto trimmedLength = 1;
+
+    for (auto ch = 0; ch < numChannels; ch++)
+    {
+        const auto* samples = impulseResponse.getReadPointer (ch);
+
+        for (auto i = length - 1; i >= trimmedLength; i--)
+            if (std::abs (samples[i]) > silenceThreshold)
+            {
+                trimmedLength = i + 1;
+                break;
+            }
+    }
+
+    impulseResponse.setSize (numChannels, trimmedLength, true);
+
+    return impulseResponse;
+}
+
+void FreezableProcessor::beginRetiring()
+{
+    _retiring = true;
+    _warmUpRemaining = 0;
+
+    // While the live processor still runs it has heard all the input and its output matches the
+    // convolver's, so the convolver can go at once. Otherwise the live processor starts from silence
+    // and the convolver, fed silence from now on, plays out the response to what it has heard.
+    if (_liveRunning)
+    {
+        _tailRemaining = 0;
+    }
+    else
+    {
+        _live->reset();
+        _liveRunning = true;
+        _tailRemaining = _active->getImpulseResponseLength();
+    }
+}
+
+void FreezableProcessor::retireActiveConvolver()
+{
+    // if the message thread has not released the previous one yet, try again on the next block
+    PartitionedConvolver* expected = nullptr;
+
+    if (! _retired.compare_exchange_strong (expected, _active))
+        return;
+
+    _active = nullptr;
+    _retiring = false;
+}
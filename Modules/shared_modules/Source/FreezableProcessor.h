@@ -0,0 +1,70 @@
+#pragma once
+
+// Runs a live processor until freeze() captures its impulse response, then crossfades to a
+// PartitionedConvolver playing that response back. Meant for static, unmodulated settings, where the
+// network is a fixed linear time invariant system and convolution costs the same whatever it models.
+// Each output channel is assumed to depend only on the same input channel.
+//
+// freeze() renders and builds the convolver on the calling (message) thread and hands it to the audio
+// thread without locking. The convolver is warmed up alongside the live processor for the length of
+// the response before the crossfade, so the swap is inaudible. unfreeze() can be called from any
+// thread, e.g. when a parameter moves: the live processor takes over from silence while the convolver
+// plays out the tail of what it has heard, so nothing is cut off.
+class FreezableProcessor : public juce::dsp::ProcessorBase
+{
+public:
+    using ProcessorFactory = std::function<std::unique_ptr<juce::dsp::ProcessorBase>()>;
+
+    // The factory creates the live processor once, and a fresh capture instance on every freeze(),
+    // so it must hand out processors with the current settings applied.
+    FreezableProcessor (ProcessorFactory factory, size_t maxImpulseResponseLength, size_t partitionSize = 256);
+    ~FreezableProcessor() override;
+
+    // drops any frozen state
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+
+    void freeze();
+    void unfreeze();
+    bool isFrozen() const;
+
+    void setCrossfadeTime (double seconds);
+    // frees convolvers the audio thread is done with, call it from the message thread
+    void releaseUnusedConvolvers();
+
+    juce::dsp::ProcessorBase& getLiveProcessor();
+    // the last captured response, trimmed to where it falls below the silence threshold
+    const juce::AudioBuffer<float>& getImpulseResponse() const;
+
+private:
+    juce::AudioBuffer<float> captureImpulseResponse();
+    void beginRetiring();
+    void retireActiveConvolver();
+
+    ProcessorFactory _factory;
+    std::unique_ptr<juce::dsp::ProcessorBase> _live;
+    size_t _maxImpulseResponseLength;
+    size_t _partitionSize;
+    juce::dsp::ProcessSpec _spec{ 0.0, 0, 0 };
+    juce::AudioBuffer<float> _impulseResponse;
+
+    std::atomic<PartitionedConvolver*> _pending{ nullptr };
+    std::atomic<PartitionedConvolver*> _retired{ nullptr };
+    std::atomic<bool> _frozen{ false };
+
+    // audio thread state
+    PartitionedConvolver* _active = nullptr;
+    bool _retiring = false;
+    bool _liveRunning = true;
+    size_t _warmUpRemaining = 0;
+    size_t _tailRemaining = 0;
+    float _mix = 0.0f;
+    float _mixStep = 0.0f;
+    double _crossfadeTime = 0.05;
+
+    juce::AudioBuffer<float> _input;
+    juce::AudioBuffer<float> _wet;
+
+    JUCE_DECLARE_NON_COPYABLE (FreezableProcessor)
+};
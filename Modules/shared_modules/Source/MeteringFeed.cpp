@@ -0,0 +1,172 @@
+#include "MeteringFeed.h"
+
+MeteringFeed::MeteringFeed (size_t capacity)
+    : _frames (capacity + 1),
+      _fifo (static_cast<int> (capacity) + 1) // an AbstractFifo holds one item less than its size
+{
+    jassert (capacity > 0);
+}
+
+void MeteringFeed::prepare (double sampleRate, size_t numChannels, size_t numTaps, double framesPerSecond)
+{
+    jassert (framesPerSecond > 0);
+
+    _numChannels = numChannels;
+    _numTaps = numTaps;
+    _samplesPerFrame = juce::jmax (static_cast<size_t> (1), static_cast<size_t> (sampleRate / framesPerSecond));
+
+    const auto size = numChannels * numTaps;
+
+    for (auto& frame : _frames)
+    {
+        frame.numTaps = numTaps;
+        frame.peak.assign (size, 0.0f);
+        frame.rms.assign (size, 0.0f);
+        frame.delayInSamples.assign (size, 0.0f);
+    }
+
+    _peak.assign (size, 0.0f);
+    _sumOfSquares.assign (size, 0.0);
+    _delayInSamples.assign (size, 0.0f);
+    _modulation = 0.0f;
+    _samplesInFrame = 0;
+    _sampleCount = 0;
+
+    _fifo.reset();
+    _numDroppedFrames = 0;
+}
+
+template <typename SampleType>
+void MeteringFeed::addTapBlock (size_t channel, size_t tap, const SampleType* samples, size_t numSamples)
+{
+    if (channel >= _numChannels || tap >= _numTaps)
+        return;
+
+    const auto index = channel * _numTaps + tap;
+    auto peak = _peak[index];
+    auto sumOfSquares = _sumOfSquares[index];
+
+    for (size_t i = 0; i < numSamples; i++)
+    {
+        const auto sample = static_cast<double> (samples[i]);
+
+        peak = juce::jmax (peak, static_cast<float> (std::abs (sample)));
+        sumOfSquares += sample * sample;
+    }
+
+    _peak[index] = peak;
+    _sumOfSquares[index] = sumOfSquares;
+}
+
+void MeteringFeed::setDelayInSamples (size_t channel, size_t tap, float delayInSamples)
+{
+    if (channel < _numChannels && tap < _numTaps)
+        _delayInSamples[channel * _numTaps + tap] = delayInSamples;
+}
+
+void MeteringFeed::setModulation (float value)
+{
+    _modulation = value;
+}
+
+void MeteringFeed::endBlock (size_t numSamples)
+{
+    _samplesInFrame += numSamples;
+    _sampleCount += numSamples;
+
+    if (_samplesInFrame >= _samplesPerFrame)
+        publish();
+}
+
+MeteringFeed::Frame MeteringFeed::makeFrame() const
+{
+    // not a copy of a slot, the audio thread may be writing any of them
+    const auto size = _numChannels * _numTaps;
+
+    Frame frame;
+    frame.numTaps = _numTaps;
+    frame.peak.assign (size, 0.0f);
+    frame.rms.assign (size, 0.0f);
+    frame.delayInSamples.assign (size, 0.0f);
+
+    return frame;
+}
+
+bool MeteringFeed::pop (Frame& frame)
+{
+    int start1, size1, start2, size2;
+    _fifo.prepareToRead (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    const auto& source = _frames[static_cast<size_t> (start1)];
+
+    frame.endSample = source.endSample;
+    frame.modulation = source.modulation;
+    frame.numTaps = source.numTaps;
+    frame.peak.assign (source.peak.begin(), source.peak.end());
+    frame.rms.assign (source.rms.begin(), source.rms.end());
+    frame.delayInSamples.assign (source.delayInSamples.begin(), source.delayInSamples.end());
+
+    _fifo.finishedRead (1);
+
+    return true;
+}
+
+bool MeteringFeed::popLatest (Frame& frame)
+{
+    const auto numReady = _fifo.getNumReady();
+
+    if (numReady == 0)
+        return false;
+
+    _fifo.finishedRead (numReady - 1);
+
+    return pop (frame);
+}
+
+juce::uint32 MeteringFeed::getNumDroppedFrames() const
+{
+    return _numDroppedFrames.load();
+}
+
+void MeteringFeed::publish()
+{
+    int start1, size1, start2, size2;
+    _fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        _numDroppedFrames++;
+    }
+    else
+    {
+        auto& frame = _frames[static_cast<size_t> (start1)];
+        const auto numSamples = static_cast<double> (_samplesInFrame);
+
+        frame.endSample = _sampleCount;
+        frame.modulation = _modulation;
+
+        for (size_t i = 0; i < _peak.size(); i++)
+        {
+            frame.peak[i] = _peak[i];
+            frame.rms[i] = static_cast<float> (std::sqrt (_sumOfSquares[i] / numSamples));
+            frame.delayInSamples[i] = _delayInSamples[i];
+        }
+
+        _fifo.finishedWrite (1);
+    }
+
+    clearAccumulators();
+}
+
+void MeteringFeed::clearAccumulators()
+{
+    std::fill (_peak.begin(), _peak.end(), 0.0f);
+    std::fill (_sumOfSquares.begin(), _sumOfSquares.end(), 0.0);
+    _samplesInFrame = 0;
+}
+
+template void MeteringFeed::addTapBlock<float> (size_t, size_t, const float*, size_t);
+template void MeteringFeed::addTapBlock<double> (size_t, size_t, const double*, size_t);
@@ -0,0 +1,75 @@
+#pragma once
+
+// Carries metering from the audio thread to one reader, usually the GUI, without locks. Processors
+// given a feed reduce each block they process to a peak and a sum of squares per tap, and record the
+// current delay of every tap; a ProcessorModulator records its latest output. endBlock() closes a
+// frame every 1 / framesPerSecond seconds and pushes it to a FIFO of preallocated frames. A full FIFO
+// drops the frame rather than wait for the reader. Processors sharing a feed report to separate
+// ranges of its taps, prepare it with enough taps for all of them.
+//
+// This replaces reading getTapOutBuffer() from another thread, which races with the audio thread
+// overwriting the buffer.
+class MeteringFeed
+{
+public:
+    struct Frame
+    {
+        float getPeak (size_t channel, size_t tap) const { return peak[channel * numTaps + tap]; }
+        float getRms (size_t channel, size_t tap) const { return rms[channel * numTaps + tap]; }
+        float getDelayInSamples (size_t channel, size_t tap) const { return delayInSamples[channel * numTaps + tap]; }
+
+        juce::uint64 endSample = 0; // samples since prepare at the end of the frame
+        float modulation = 0.0f;
+        size_t numTaps = 0;
+
+        // [channel * numTaps + tap]
+        std::vector<float> peak;
+        std::vector<float> rms;
+        std::vector<float> delayInSamples;
+    };
+
+    explicit MeteringFeed (size_t capacity = 32);
+
+    // not while the audio thread uses the feed
+    void prepare (double sampleRate, size_t numChannels, size_t numTaps, double framesPerSecond = 30.0);
+
+    // audio thread. Channels and taps beyond the prepared ones are ignored.
+    template <typename SampleType>
+    void addTapBlock (size_t channel, size_t tap, const SampleType* samples, size_t numSamples);
+    void setDelayInSamples (size_t channel, size_t tap, float delayInSamples);
+    void setModulation (float value);
+    // call once per block, after every processor reporting to the feed has processed it
+    void endBlock (size_t numSamples);
+
+    // reader thread. A frame from makeFrame() is sized so that popping into it doesn't allocate.
+    Frame makeFrame() const;
+    bool pop (Frame& frame);
+    // skips to the newest frame, for readers that only draw the latest state
+    bool popLatest (Frame& frame);
+
+    // any thread
+    juce::uint32 getNumDroppedFrames() const;
+
+private:
+    void publish();
+    void clearAccumulators();
+
+    std::vector<Frame> _frames;
+    juce::AbstractFifo _fifo;
+
+    size_t _numChannels = 0;
+    size_t _numTaps = 0;
+    size_t _samplesPerFrame = 1;
+
+    // audio thread state of the frame being accumulated
+    std::vector<float> _peak;
+    std::vector<double> _sumOfSquares;
+    std::vector<float> _delayInSamples;
+    float _modulation = 0.0f;
+    size_t _samplesInFrame = 0;
+    juce::uint64 _sampleCount = 0;
+
+    std::atomic<juce::uint32> _numDroppedFrames{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (MeteringFeed)
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+// juce::dsp::ProcessorBase only declares a float process(). Processors templated on their internal
+// SampleType derive from this instead, so they can also run directly on double buses.
+//
+// Out of place processing defaults to copying the input to the output and processing that in place.
+// Processors that read their input into scratch buffers anyway override it to read the input block
+// directly, which saves the copy.
+class MultiPrecisionProcessor : public juce::dsp::ProcessorBase
+{
+public:
+    using juce::dsp::ProcessorBase::process;
+
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) = 0;
+
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processViaCopy (context);
+    }
+
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processViaCopy (context);
+    }
+
+private:
+    template <typename IOType>
+    void processViaCopy (const juce::dsp::ProcessContextNonReplacing<IOType>& context)
+    {
+        auto& outputBlock = context.getOutputBlock();
+
+        jassert (context.getInputBlock().getNumChannels() == outputBlock.getNumChannels());
+        jassert (context.getInputBlock().getNumSamples() == outputBlock.getNumSamples());
+
+        outputBlock.copyFrom (context.getInputBlock());
+        process (juce::dsp::ProcessContextReplacing<IOType> (outputBlock));
+    }
+};
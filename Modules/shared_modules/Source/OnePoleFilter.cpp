@@ -2,45 +2,59 @@
 
 namespace OnePoleFilter
 {
-    void Lowpass::prepare (const juce::dsp::ProcessSpec& spec)
+    template <typename SampleType>
+    void Lowpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
     {
+        const auto sampleRateChanged = spec.sampleRate != _fs;
+
         _b0.resize (spec.numChannels);
         _a1.resize (spec.numChannels);
+        _zPole.assign (spec.numChannels, 0.0);
 
-        _zPole.clear();
+        _kernels = &SimdKernels::getKernels<SampleType>();
+        _samples.resize (spec.maximumBlockSize);
+        _b0Values.resize (spec.maximumBlockSize);
+        _a1Values.resize (spec.maximumBlockSize);
 
         _fs = spec.sampleRate;
+        _outputMix.prepare (spec.sampleRate);
 
         for (size_t ch = 0; ch < spec.numChannels; ch++)
         {
             _b0[ch].reset (spec.sampleRate, 0.05);
             _a1[ch].reset (spec.sampleRate, 0.05);
-            _zPole.emplace_back (0.0);
         }
+
+        // the coefficients depend on the sample rate, keep the cutoff where it was
+        if (sampleRateChanged && _fc >= 0)
+            setCutoffFrequency (_fc, true);
     }
 
-    void Lowpass::reset()
+    template <typename SampleType>
+    void Lowpass<SampleType>::reset()
     {
         for (size_t ch = 0; ch < _b0.size(); ch++)
         {
             _b0[ch].reset (_fs, 0.05);
             _a1[ch].reset (_fs, 0.05);
-            _zPole[ch] = 0.0f;
+            _zPole[ch] = 0.0;
         }
     }
 
-    void Lowpass::setCutoffFrequency (float fc, bool force)
+    template <typename SampleType>
+    void Lowpass<SampleType>::setCutoffFrequency (SampleType fc, bool force)
     {
         jassert (_fs > 0);
 
-        float alpha = std::exp (-2.0 * M_PI * fc / _fs);
+        _fc = fc;
+        SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
 
         if (force)
         {
             for (size_t ch = 0; ch < _b0.size(); ch++)
             {
                 _a1[ch].setCurrentAndTargetValue (alpha);
-                _b0[ch].setCurrentAndTargetValue (1.0 - alpha);
+                _b0[ch].setCurrentAndTargetValue (static_cast<SampleType> (1.0 - alpha));
             }
         }
         else
@@ -48,68 +62,186 @@ namespace OnePoleFilter
             for (size_t ch = 0; ch < _b0.size(); ch++)
             {
                 _a1[ch].setTargetValue (alpha);
-                _b0[ch].setTargetValue (1.0 - alpha);
+                _b0[ch].setTargetValue (static_cast<SampleType> (1.0 - alpha));
             }
         }
     }
 
-    void Lowpass::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    template <typename SampleType>
+    void Lowpass<SampleType>::setParameters (const Parameters& parameters, bool force)
+    {
+        setCutoffFrequency (parameters.cutoffFrequency, force);
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::setBlockScan (bool shouldUseBlockScan)
+    {
+        _blockScan = shouldUseBlockScan;
+    }
+
+    template <typename SampleType>
+    SampleType Lowpass<SampleType>::processSample (size_t channel, SampleType input)
+    {
+        _zPole[channel] = input * _b0[channel].getNextValue() + _zPole[channel] * _a1[channel].getNextValue();
+
+        return _zPole[channel];
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    OutputMix<SampleType>& Lowpass<SampleType>::getOutputMix()
+    {
+        return _outputMix;
+    }
+
+    template <typename SampleType>
+    template <typename IOType>
+    void Lowpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
     {
-        auto& outputBlock = context.getOutputBlock();
         const auto numChannels = outputBlock.getNumChannels();
         const auto numSamples = outputBlock.getNumSamples();
 
+        const auto maxBlockSize = _samples.size();
+
+        jassert (maxBlockSize > 0);
+        jassert (inputBlock.getNumChannels() == numChannels && inputBlock.getNumSamples() == numSamples);
+
+        _outputMix.beginBlock (numSamples);
+
         for (size_t ch = 0; ch < numChannels; ch++)
         {
-            auto* samples = outputBlock.getChannelPointer (ch);
-
-            for (size_t i = 0; i < numSamples; i++)
+            for (size_t start = 0; start < numSamples; start += maxBlockSize)
             {
-                _zPole[ch] = samples[i] * _b0[ch].getNextValue() + _zPole[ch] * _a1[ch].getNextValue();
-                samples[i] = _zPole[ch];
+                const auto blockSize = juce::jmin (maxBlockSize, numSamples - start);
+                const auto* input = inputBlock.getChannelPointer (ch) + start;
+                auto* output = outputBlock.getChannelPointer (ch) + start;
+
+                if (_b0[ch].isSmoothing() || _a1[ch].isSmoothing())
+                {
+                    for (size_t i = 0; i < blockSize; i++)
+                        _samples[i] = processSample (ch, static_cast<SampleType> (input[i]));
+
+                    _outputMix.write (input, _samples.data(), output, start, blockSize);
+                    continue;
+                }
+
+                if constexpr (std::is_same_v<IOType, SampleType>)
+                {
+                    // the kernel can write the output block itself unless the dry signal is mixed back in
+                    if (! _outputMix.isActive())
+                    {
+                        processSettled (ch, input, output, blockSize);
+                        continue;
+                    }
+
+                    processSettled (ch, input, _samples.data(), blockSize);
+                }
+                else
+                {
+                    for (size_t i = 0; i < blockSize; i++)
+                        _samples[i] = static_cast<SampleType> (input[i]);
+
+                    processSettled (ch, _samples.data(), _samples.data(), blockSize);
+                }
+
+                _outputMix.write (input, _samples.data(), output, start, blockSize);
             }
         }
     }
 
-    void Highpass::prepare (const juce::dsp::ProcessSpec& spec)
+    template <typename SampleType>
+    void Lowpass<SampleType>::processSettled (size_t channel, const SampleType* input, SampleType* output, size_t numSamples)
+    {
+        const auto b0 = _b0[channel].getTargetValue();
+        const auto a1 = _a1[channel].getTargetValue();
+
+        if (_blockScan)
+        {
+            _kernels->onePoleLowpassScan (input, output, b0, a1, _zPole[channel], numSamples);
+            return;
+        }
+
+        _kernels->fill (_b0Values.data(), b0, numSamples);
+        _kernels->fill (_a1Values.data(), a1, numSamples);
+        _kernels->onePoleLowpass (input, output, _b0Values.data(), _a1Values.data(), _zPole[channel], numSamples);
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
     {
+        const auto sampleRateChanged = spec.sampleRate != _fs;
+
         _b0.resize (spec.numChannels);
         _b1.resize (spec.numChannels);
         _a1.resize (spec.numChannels);
+        _zPole.assign (spec.numChannels, 0.0);
+        _zZero.assign (spec.numChannels, 0.0);
 
-        _zPole.clear();
-        _zZero.clear();
+        _kernels = &SimdKernels::getKernels<SampleType>();
+        _input.resize (spec.maximumBlockSize);
+        _output.resize (spec.maximumBlockSize);
+        _b0Values.resize (spec.maximumBlockSize);
+        _b1Values.resize (spec.maximumBlockSize);
+        _a1Values.resize (spec.maximumBlockSize);
 
         _fs = spec.sampleRate;
+        _outputMix.prepare (spec.sampleRate);
 
         for (size_t ch = 0; ch < spec.numChannels; ch++)
         {
             _b0[ch].reset (spec.sampleRate, 0.05);
             _b1[ch].reset (spec.sampleRate, 0.05);
             _a1[ch].reset (spec.sampleRate, 0.05);
-            _zPole.emplace_back (0.0);
-            _zZero.emplace_back (0.0);
         }
+
+        if (sampleRateChanged && _fc >= 0)
+            setCutoffFrequency (_fc, true);
     }
 
-    void Highpass::reset()
+    template <typename SampleType>
+    void Highpass<SampleType>::reset()
     {
         for (size_t ch = 0; ch < _b0.size(); ch++)
         {
             _b0[ch].reset (_fs, 0.05);
             _b1[ch].reset (_fs, 0.05);
             _a1[ch].reset (_fs, 0.05);
-            _zPole[ch] = 0.0f;
-            _zZero[ch] = 0.0f;
+            _zPole[ch] = 0.0;
+            _zZero[ch] = 0.0;
         }
     }
 
-    void Highpass::setCutoffFrequency (float fc, bool force)
+    template <typename SampleType>
+    void Highpass<SampleType>::setCutoffFrequency (SampleType fc, bool force)
     {
         jassert (_fs > 0);
 
-        float alpha = std::exp (-2.0 * M_PI * fc / _fs);
-        float b0 = (1.0 + alpha) / 2.0;
+        _fc = fc;
+        SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
+        SampleType b0 = static_cast<SampleType> ((1.0 + alpha) / 2.0);
 
         if (force)
         {
@@ -131,22 +263,155 @@ namespace OnePoleFilter
         }
     }
 
-    void Highpass::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    template <typename SampleType>
+    void Highpass<SampleType>::setParameters (const Parameters& parameters, bool force)
+    {
+        setCutoffFrequency (parameters.cutoffFrequency, force);
+    }
+
+    template <typename SampleType>
+    SampleType Highpass<SampleType>::processSample (size_t channel, SampleType input)
+    {
+        _zPole[channel] = input * _b0[channel].getNextValue() + _zZero[channel] * _b1[channel].getNextValue() + _zPole[channel] * _a1[channel].getNextValue();
+        _zZero[channel] = input;
+
+        return _zPole[channel];
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock());
+    }
+
+    template <typename SampleType>
+    OutputMix<SampleType>& Highpass<SampleType>::getOutputMix()
+    {
+        return _outputMix;
+    }
+
+    template <typename SampleType>
+    template <typename IOType>
+    void Highpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
     {
-        auto& outputBlock = context.getOutputBlock();
         const auto numChannels = outputBlock.getNumChannels();
         const auto numSamples = outputBlock.getNumSamples();
 
+        const auto maxBlockSize = _input.size();
+
+        jassert (maxBlockSize > 0);
+        jassert (inputBlock.getNumChannels() == numChannels && inputBlock.getNumSamples() == numSamples);
+
+        _outputMix.beginBlock (numSamples);
+
         for (size_t ch = 0; ch < numChannels; ch++)
         {
-            auto* samples = outputBlock.getChannelPointer (ch);
-
-            for (size_t i = 0; i < numSamples; i++)
+            for (size_t start = 0; start < numSamples; start += maxBlockSize)
             {
-                _zPole[ch] = samples[i] * _b0[ch].getNextValue() + _zZero[ch] * _b1[ch].getNextValue() + _zPole[ch] * _a1[ch].getNextValue();
-                _zZero[ch] = samples[i];
-                samples[i] = _zPole[ch];
+                const auto blockSize = juce::jmin (maxBlockSize, numSamples - start);
+                const auto* input = inputBlock.getChannelPointer (ch) + start;
+                auto* output = outputBlock.getChannelPointer (ch) + start;
+
+                if (_b0[ch].isSmoothing() || _b1[ch].isSmoothing() || _a1[ch].isSmoothing())
+                {
+                    for (size_t i = 0; i < blockSize; i++)
+                        _output[i] = processSample (ch, static_cast<SampleType> (input[i]));
+
+                    _outputMix.write (input, _output.data(), output, start, blockSize);
+                    continue;
+                }
+
+                _kernels->fill (_b0Values.data(), _b0[ch].getTargetValue(), blockSize);
+                _kernels->fill (_b1Values.data(), _b1[ch].getTargetValue(), blockSize);
+                _kernels->fill (_a1Values.data(), _a1[ch].getTargetValue(), blockSize);
+
+                // the kernel reads back the previous input sample, so it never writes the output block directly
+                const SampleType* kernelInput = _input.data();
+
+                if constexpr (std::is_same_v<IOType, SampleType>)
+                {
+                    kernelInput = input;
+                }
+                else
+                {
+                    for (size_t i = 0; i < blockSize; i++)
+                        _input[i] = static_cast<SampleType> (input[i]);
+                }
+
+                _kernels->onePoleHighpass (kernelInput, _output.data(), _b0Values.data(), _b1Values.data(), _a1Values.data(), _zPole[ch], _zZero[ch], blockSize);
+
+                _outputMix.write (input, _output.data(), output, start, blockSize);
             }
         }
     }
+
+    template <typename SampleType>
+    void Lowpass<SampleType>::saveState (StateWriter& writer) const
+    {
+        writer.writeTag ("OPLP");
+        writer.write (_fs);
+        writer.write (_fc);
+        writer.writeArray (_b0);
+        writer.writeArray (_a1);
+        writer.writeArray (_zPole);
+    }
+
+    template <typename SampleType>
+    bool Lowpass<SampleType>::restoreState (StateReader& reader)
+    {
+        double fs = 0.0;
+
+        if (! reader.readTag ("OPLP") || ! reader.read (fs) || fs != _fs)
+            return false;
+
+        return reader.read (_fc) && reader.readArray (_b0) && reader.readArray (_a1) && reader.readArray (_zPole);
+    }
+
+    template <typename SampleType>
+    void Highpass<SampleType>::saveState (StateWriter& writer) const
+    {
+        writer.writeTag ("OPHP");
+        writer.write (_fs);
+        writer.write (_fc);
+        writer.writeArray (_b0);
+        writer.writeArray (_b1);
+        writer.writeArray (_a1);
+        writer.writeArray (_zPole);
+        writer.writeArray (_zZero);
+    }
+
+    template <typename SampleType>
+    bool Highpass<SampleType>::restoreState (StateReader& reader)
+    {
+        double fs = 0.0;
+
+        if (! reader.readTag ("OPHP") || ! reader.read (fs) || fs != _fs)
+            return false;
+
+        return reader.read (_fc) && reader.readArray (_b0) && reader.readArray (_b1) && reader.readArray (_a1)
+               && reader.readArray (_zPole) && reader.readArray (_zZero);
+    }
+
+    template class Lowpass<float>;
+    template class Lowpass<double>;
+    template class Highpass<float>;
+    template class Highpass<double>;
 } // namespace OnePoleFilter
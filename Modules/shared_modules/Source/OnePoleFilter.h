@@ -2,37 +2,104 @@
 
 namespace OnePoleFilter
 {
-    class Lowpass : public juce::dsp::ProcessorBase
+    template <typename SampleType = float>
+    class Lowpass : public MultiPrecisionProcessor
     {
     public:
+        struct Parameters
+        {
+            SampleType cutoffFrequency = 1000.0;
+        };
+
         virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
         virtual void reset() override;
         virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+        void setCutoffFrequency (SampleType fc, bool force = false);
+        void setParameters (const Parameters& parameters, bool force = false);
+
+        // While the cutoff is settled, runs the recursion eight samples per step with
+        // SimdKernels::Kernels::onePoleLowpassScan, which pays off when there are too few channels to
+        // keep the serial loop busy. The output then differs from processSample() by rounding.
+        void setBlockScan (bool shouldUseBlockScan);
+
+        SampleType processSample (size_t channel, SampleType input);
 
-        void setCutoffFrequency (float fc, bool force = false);
+        // dry/wet and output gain, applied as the filter output is written
+        OutputMix<SampleType>& getOutputMix();
+
+        void saveState (StateWriter& writer) const;
+        bool restoreState (StateReader& reader);
 
     private:
-        std::vector<juce::LinearSmoothedValue<float>> _b0;
-        std::vector<juce::LinearSmoothedValue<float>> _a1;
-        std::vector<float> _zPole;
-        float _fs = 0.0f;
+        template <typename IOType>
+        void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+        // the settled coefficients over numSamples, input and output may be the same buffer
+        void processSettled (size_t channel, const SampleType* input, SampleType* output, size_t numSamples);
+
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _a1;
+        std::vector<SampleType> _zPole;
+        double _fs = 0.0;
+        SampleType _fc = -1.0; // negative until a cutoff is set
+        bool _blockScan = false;
+        OutputMix<SampleType> _outputMix;
+
+        // per block coefficient values for the kernels, maximumBlockSize long
+        const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+        std::vector<SampleType> _samples;
+        std::vector<SampleType> _b0Values;
+        std::vector<SampleType> _a1Values;
     };
 
-    class Highpass : public juce::dsp::ProcessorBase
+    template <typename SampleType = float>
+    class Highpass : public MultiPrecisionProcessor
     {
     public:
+        struct Parameters
+        {
+            SampleType cutoffFrequency = 1000.0;
+        };
+
         virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
         virtual void reset() override;
         virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+        virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+        void setCutoffFrequency (SampleType fc, bool force = false);
+        void setParameters (const Parameters& parameters, bool force = false);
+
+        SampleType processSample (size_t channel, SampleType input);
 
-        void setCutoffFrequency (float fc, bool force = false);
+        // dry/wet and output gain, applied as the filter output is written
+        OutputMix<SampleType>& getOutputMix();
+
+        void saveState (StateWriter& writer) const;
+        bool restoreState (StateReader& reader);
 
     private:
-        std::vector<juce::LinearSmoothedValue<float>> _b0;
-        std::vector<juce::LinearSmoothedValue<float>> _b1;
-        std::vector<juce::LinearSmoothedValue<float>> _a1;
-        std::vector<float> _zPole;
-        std::vector<float> _zZero;
-        float _fs = 0.0f;
+        template <typename IOType>
+        void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b1;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _a1;
+        std::vector<SampleType> _zPole;
+        std::vector<SampleType> _zZero;
+        double _fs = 0.0;
+        SampleType _fc = -1.0; // negative until a cutoff is set
+        OutputMix<SampleType> _outputMix;
+
+        const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+        std::vector<SampleType> _input;
+        std::vector<SampleType> _output;
+        std::vector<SampleType> _b0Values;
+        std::vector<SampleType> _b1Values;
+        std::vector<SampleType> _a1Values;
     };
 } // namespace OnePoleFilter
@@ -0,0 +1,129 @@
+#pragma once
+
+// Dry/wet and output gain stage that processors apply in the loop writing their output, so a mixed
+// insert needs neither a copy of the dry signal nor a mixing pass of its own. beginBlock() advances
+// the smoothed levels once per block; within the block they ramp linearly towards where the smoothers
+// ended up. At the defaults (dry 0, wet 1, gain 1) the output is written exactly as it was computed.
+template <typename SampleType = float>
+class OutputMix
+{
+public:
+    OutputMix()
+    {
+        _wetGain.setCurrentAndTargetValue (1);
+    }
+
+    void prepare (double sampleRate)
+    {
+        _dryGain.reset (sampleRate, 0.05);
+        _wetGain.reset (sampleRate, 0.05);
+    }
+
+    void setDryLevel (SampleType newDryLevel, bool force = false)
+    {
+        _dryLevel = newDryLevel;
+        updateTargets (force);
+    }
+
+    void setWetLevel (SampleType newWetLevel, bool force = false)
+    {
+        _wetLevel = newWetLevel;
+        updateTargets (force);
+    }
+
+    void setOutputGain (SampleType newOutputGain, bool force = false)
+    {
+        _outputGain = newOutputGain;
+        updateTargets (force);
+    }
+
+    void beginBlock (size_t numSamples)
+    {
+        _active = _dryGain.isSmoothing() || _wetGain.isSmoothing() || _dryGain.getTargetValue() != 0 || _wetGain.getTargetValue() != 1;
+
+        if (! _active || numSamples == 0)
+            return;
+
+        const auto steps = static_cast<SampleType> (numSamples);
+
+        _dryStart = _dryGain.getCurrentValue();
+        _dryStep = (_dryGain.skip (static_cast<int> (numSamples)) - _dryStart) / steps;
+        _wetStart = _wetGain.getCurrentValue();
+        _wetStep = (_wetGain.skip (static_cast<int> (numSamples)) - _wetStart) / steps;
+    }
+
+    bool isActive() const
+    {
+        return _active;
+    }
+
+    // index is the sample's position in the block passed to beginBlock()
+    template <typename IOType>
+    IOType mixSample (IOType dry, SampleType wet, size_t index) const
+    {
+        if (! _active)
+            return static_cast<IOType> (wet);
+
+        const auto ramp = static_cast<SampleType> (index + 1);
+
+        return static_cast<IOType> ((_wetStart + ramp * _wetStep) * wet + (_dryStart + ramp * _dryStep) * static_cast<SampleType> (dry));
+    }
+
+    // numSamples samples from offset within the block; dry and out may be the same buffer
+    template <typename IOType>
+    void write (const IOType* dry, const SampleType* wet, IOType* out, size_t offset, size_t numSamples) const
+    {
+        if (! _active)
+        {
+            for (size_t i = 0; i < numSamples; i++)
+                out[i] = static_cast<IOType> (wet[i]);
+
+            return;
+        }
+
+        if (_dryStep == 0 && _wetStep == 0)
+        {
+            for (size_t i = 0; i < numSamples; i++)
+                out[i] = static_cast<IOType> (_wetStart * wet[i] + _dryStart * static_cast<SampleType> (dry[i]));
+
+            return;
+        }
+
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            const auto ramp = static_cast<SampleType> (offset + i + 1);
+
+            out[i] = static_cast<IOType> ((_wetStart + ramp * _wetStep) * wet[i] + (_dryStart + ramp * _dryStep) * static_cast<SampleType> (dry[i]));
+        }
+    }
+
+private:
+    void updateTargets (bool force)
+    {
+        if (force)
+        {
+            _dryGain.setCurrentAndTargetValue (_dryLevel * _outputGain);
+            _wetGain.setCurrentAndTargetValue (_wetLevel * _outputGain);
+        }
+        else
+        {
+            _dryGain.setTargetValue (_dryLevel * _outputGain);
+            _wetGain.setTargetValue (_wetLevel * _outputGain);
+        }
+    }
+
+    SampleType _dryLevel = 0;
+    SampleType _wetLevel = 1;
+    SampleType _outputGain = 1;
+
+    // the levels times the output gain
+    juce::LinearSmoothedValue<SampleType> _dryGain;
+    juce::LinearSmoothedValue<SampleType> _wetGain;
+
+    // this block's ramps
+    bool _active = false;
+    SampleType _dryStart = 0;
+    SampleType _dryStep = 0;
+    SampleType _wetStart = 1;
+    SampleType _wetStep = 0;
+};
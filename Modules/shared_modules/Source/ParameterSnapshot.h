@@ -0,0 +1,70 @@
+#pragma once
+
+// Lock-free triple buffer carrying whole parameter snapshots from one writer thread (usually the
+// message thread) to the audio thread. The writer fills getWriteSnapshot() and calls publish();
+// the audio thread calls acquire() once per block and, when a newer snapshot is available, applies
+// all of it in one pass. Neither side ever blocks or allocates, so long as copying Snapshot doesn't;
+// the processors' Parameters structs have a fixed size, so snapshots made of them never do.
+template <typename Snapshot>
+class ParameterSnapshot
+{
+public:
+    ParameterSnapshot() = default;
+
+    ParameterSnapshot (const Snapshot& initialSnapshot)
+    {
+        _snapshots.fill (initialSnapshot);
+    }
+
+    // writer thread
+    Snapshot& getWriteSnapshot()
+    {
+        return _snapshots[_writeIndex];
+    }
+
+    void publish()
+    {
+        const auto publishedIndex = _writeIndex;
+
+        auto previousMiddle = _middle.exchange (static_cast<juce::uint8> (publishedIndex | newDataFlag), std::memory_order_acq_rel);
+        _writeIndex = previousMiddle & indexMask;
+
+        // the published snapshot is only ever read from now on, so it can be copied into the next
+        // write snapshot while the audio thread reads it too; this lets callers edit single fields
+        _snapshots[_writeIndex] = _snapshots[publishedIndex];
+    }
+
+    void publish (const Snapshot& newSnapshot)
+    {
+        getWriteSnapshot() = newSnapshot;
+        publish();
+    }
+
+    // audio thread: returns the latest snapshot if one was published since the previous call,
+    // nullptr otherwise
+    const Snapshot* acquire()
+    {
+        if ((_middle.load (std::memory_order_relaxed) & newDataFlag) == 0)
+            return nullptr;
+
+        auto previousMiddle = _middle.exchange (_readIndex, std::memory_order_acq_rel);
+        _readIndex = previousMiddle & indexMask;
+
+        return &_snapshots[_readIndex];
+    }
+
+    // audio thread: the snapshot returned by the last successful acquire()
+    const Snapshot& getCurrentSnapshot() const
+    {
+        return _snapshots[_readIndex];
+    }
+
+private:
+    static constexpr juce::uint8 indexMask = 0x3;
+    static constexpr juce::uint8 newDataFlag = 0x4;
+
+    std::array<Snapshot, 3> _snapshots{};
+    std::atomic<juce::uint8> _middle{ 1 };
+    juce::uint8 _writeIndex = 0;
+    juce::uint8 _readIndex = 2;
+};
@@ -0,0 +1,177 @@
+#include "PartitionedConvolver.h"
+
+PartitionedConvolver::PartitionedConvolver (const juce::AudioBuffer<float>& impulseResponse, size_t numChannels, size_t partitionSize)
+    : _partitionSize (partitionSize),
+      _numPartitions (juce::jmax<size_t> (1, (static_cast<size_t> (impulseResponse.getNumSamples()) + partitionSize - 1) / partitionSize)),
+      _numBins (partitionSize + 1),
+      _impulseResponseLength (static_cast<size_t> (impulseResponse.getNumSamples())),
+      _fft (juce::roundToInt (std::log2 (2 * partitionSize)))
+{
+    jassert (juce::isPowerOfTwo (partitionSize));
+    jassert (impulseResponse.getNumChannels() > 0);
+
+    const auto fftSize = 2 * partitionSize;
+    const auto spectrumSize = 2 * _numBins;
+
+    _fftBuffer.resize (2 * fftSize);
+    _accumulator.resize (spectrumSize);
+
+    // JUCE's FFT engines differ in how they scale the inverse transform, so measure it
+    std::fill (_fftBuffer.begin(), _fftBuffer.end(), 0.0f);
+    _fftBuffer[0] = 1.0f;
+    _fft.performRealOnlyForwardTransform (_fftBuffer.data(), true);
+    _fft.performRealOnlyInverseTransform (_fftBuffer.data());
+    _inverseScale = 1.0f / _fftBuffer[0];
+
+    _head.resize (numChannels);
+    _filterSpectra.resize (numChannels);
+    _inputSpectra.resize (numChannels);
+    _inputHistory.resize (numChannels);
+    _tailOutput.resize (numChannels);
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        const auto* ir = impulseResponse.getReadPointer (static_cast<int> (ch % static_cast<size_t> (impulseResponse.getNumChannels())));
+
+        _head[ch].assign (partitionSize, 0.0f);
+
+        for (size_t i = 0; i < juce::jmin (partitionSize, _impulseResponseLength); i++)
+            _head[ch][partitionSize - 1 - i] = ir[i];
+
+        _filterSpectra[ch].assign ((_numPartitions - 1) * spectrumSize, 0.0f);
+
+        for (size_t k = 1; k < _numPartitions; k++)
+        {
+            std::fill (_fftBuffer.begin(), _fftBuffer.end(), 0.0f);
+
+            const auto start = k * partitionSize;
+            std::copy (ir + start, ir + juce::jmin (start + partitionSize, _impulseResponseLength), _fftBuffer.begin());
+
+            _fft.performRealOnlyForwardTransform (_fftBuffer.data(), true);
+            std::copy (_fftBuffer.begin(), _fftBuffer.begin() + static_cast<std::ptrdiff_t> (spectrumSize), _filterSpectra[ch].begin() + static_cast<std::ptrdiff_t> ((k - 1) * spectrumSize));
+        }
+
+        _inputSpectra[ch].resize ((_numPartitions - 1) * spectrumSize);
+        _inputHistory[ch].resize (2 * partitionSize);
+        _tailOutput[ch].resize (partitionSize);
+    }
+
+    reset();
+}
+
+void PartitionedConvolver::reset()
+{
+    for (size_t ch = 0; ch < _head.size(); ch++)
+    {
+        std::fill (_inputSpectra[ch].begin(), _inputSpectra[ch].end(), 0.0f);
+        std::fill (_inputHistory[ch].begin(), _inputHistory[ch].end(), 0.0f);
+        std::fill (_tailOutput[ch].begin(), _tailOutput[ch].end(), 0.0f);
+    }
+
+    _position = 0;
+    _newestSpectrum = 0;
+}
+
+void PartitionedConvolver::process (const juce::dsp::AudioBlock<const float>& input, const juce::dsp::AudioBlock<float>& output)
+{
+    jassert (input.getNumChannels() == _head.size() && output.getNumChannels() == _head.size());
+    jassert (input.getNumSamples() == output.getNumSamples());
+
+    const auto numSamples = input.getNumSamples();
+
+    for (size_t done = 0; done < numSamples;)
+    {
+        const auto numToProcess = juce::jmin (numSamples - done, _partitionSize - _position);
+
+        for (size_t ch = 0; ch < _head.size(); ch++)
+        {
+            const auto* in = input.getChannelPointer (ch) + done;
+            auto* out = output.getChannelPointer (ch) + done;
+            const auto* head = _head[ch].data();
+            auto* history = _inputHistory[ch].data();
+            const auto* tail = _tailOutput[ch].data() + _position;
+
+            for (size_t i = 0; i < numToProcess; i++)
+            {
+                const auto pos = _position + i;
+                history[_partitionSize + pos] = in[i];
+
+                // the newest partitionSize input samples end at history[partitionSize + pos]
+                const auto* x = history + pos + 1;
+                float sum = 0.0f;
+
+                for (size_t j = 0; j < _partitionSize; j++)
+                    sum += head[j] * x[j];
+
+                out[i] = sum + tail[i];
+            }
+        }
+
+        _position += numToProcess;
+        done += numToProcess;
+
+        if (_position == _partitionSize)
+        {
+            if (_numPartitions > 1)
+                _newestSpectrum = (_newestSpectrum + 1) % (_numPartitions - 1);
+
+            for (size_t ch = 0; ch < _head.size(); ch++)
+                processPartitionBoundary (ch);
+
+            _position = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processPartitionBoundary (size_t channel)
+{
+    auto& history = _inputHistory[channel];
+
+    if (_numPartitions > 1)
+    {
+        const auto spectrumSize = 2 * _numBins;
+        const auto numSlots = _numPartitions - 1;
+
+        // spectrum of the block just completed together with the one before it (overlap-save)
+        std::copy (history.begin(), history.end(), _fftBuffer.begin());
+        std::fill (_fftBuffer.begin() + static_cast<std::ptrdiff_t> (history.size()), _fftBuffer.end(), 0.0f);
+        _fft.performRealOnlyForwardTransform (_fftBuffer.data(), true);
+        std::copy (_fftBuffer.begin(), _fftBuffer.begin() + static_cast<std::ptrdiff_t> (spectrumSize), _inputSpectra[channel].begin() + static_cast<std::ptrdiff_t> (_newestSpectrum * spectrumSize));
+
+        // partition k of the response meets the input block from k blocks before the next one
+        std::fill (_accumulator.begin(), _accumulator.end(), 0.0f);
+
+        for (size_t k = 1; k < _numPartitions; k++)
+        {
+            const auto slot = (_newestSpectrum + numSlots - (k - 1)) % numSlots;
+            const auto* x = _inputSpectra[channel].data() + slot * spectrumSize;
+            const auto* h = _filterSpectra[channel].data() + (k - 1) * spectrumSize;
+            auto* acc = _accumulator.data();
+
+            for (size_t b = 0; b < spectrumSize; b += 2)
+            {
+                acc[b] += x[b] * h[b] - x[b + 1] * h[b + 1];
+                acc[b + 1] += x[b] * h[b + 1] + x[b + 1] * h[b];
+            }
+        }
+
+        std::copy (_accumulator.begin(), _accumulator.end(), _fftBuffer.begin());
+        std::fill (_fftBuffer.begin() + static_cast<std::ptrdiff_t> (spectrumSize), _fftBuffer.end(), 0.0f);
+        _fft.performRealOnlyInverseTransform (_fftBuffer.data());
+
+        for (size_t i = 0; i < _partitionSize; i++)
+            _tailOutput[channel][i] = _fftBuffer[_partitionSize + i] * _inverseScale;
+    }
+
+    std::copy (history.begin() + static_cast<std::ptrdiff_t> (_partitionSize), history.end(), history.begin());
+}
+
+size_t PartitionedConvolver::getImpulseResponseLength() const
+{
+    return _impulseResponseLength;
+}
+
+size_t PartitionedConvolver::getNumChannels() const
+{
+    return _head.size();
+}
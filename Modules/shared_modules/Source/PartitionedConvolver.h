@@ -0,0 +1,41 @@
+#pragma once
+
+// Zero latency convolution with a fixed multichannel impulse response. The first partition of the
+// response is applied directly in the time domain; the rest uses uniformly partitioned overlap-save
+// FFT convolution, which costs one forward and one inverse FFT plus a complex multiply-accumulate per
+// partition, once every partitionSize samples, whatever the host block size.
+// Everything is allocated in the constructor, so build it off the audio thread.
+class PartitionedConvolver
+{
+public:
+    // impulse response channels are reused cyclically when there are fewer than numChannels
+    PartitionedConvolver (const juce::AudioBuffer<float>& impulseResponse, size_t numChannels, size_t partitionSize = 256);
+
+    void reset();
+    // input and output must not overlap
+    void process (const juce::dsp::AudioBlock<const float>& input, const juce::dsp::AudioBlock<float>& output);
+
+    size_t getImpulseResponseLength() const;
+    size_t getNumChannels() const;
+
+private:
+    void processPartitionBoundary (size_t channel);
+
+    size_t _partitionSize;
+    size_t _numPartitions;
+    size_t _numBins;
+    size_t _impulseResponseLength;
+    juce::dsp::FFT _fft;
+    float _inverseScale = 1.0f;
+
+    std::vector<std::vector<float>> _head;            // [channel][sample], first partition, reversed
+    std::vector<std::vector<float>> _filterSpectra;   // [channel][partition * 2 * numBins], partitions 1 and up
+    std::vector<std::vector<float>> _inputSpectra;    // [channel][slot * 2 * numBins], ring of past input blocks
+    std::vector<std::vector<float>> _inputHistory;    // [channel][2 * partitionSize], previous and current block
+    std::vector<std::vector<float>> _tailOutput;      // [channel][partitionSize]
+    std::vector<float> _fftBuffer;
+    std::vector<float> _accumulator;
+
+    size_t _position = 0;
+    size_t _newestSpectrum = 0;
+};
@@ -1,37 +1,98 @@
 #include "ProcessorModulator.h"
 
-ProcessorModulator::ProcessorModulator(OscillatorWrapper& modulator, size_t updateRate)
+void OscillatorWrapper::setWaveform (Waveform newWaveform, size_t numSamples)
+{
+    _waveform.store (newWaveform, std::memory_order_relaxed);
+    _table.store (numSamples == 0 ? nullptr : &WaveformTableRegistry::getInstance().getTable (newWaveform, numSamples), std::memory_order_release);
+
+    if (newWaveform == Random && numSamples > 0)
+    {
+        static std::atomic<juce::uint32> numRandomOscillators{ 0 };
+        const auto index = static_cast<double> (numRandomOscillators.fetch_add (1, std::memory_order_relaxed));
+        const auto fraction = index * 0.6180339887498949 - std::floor (index * 0.6180339887498949);
+
+        _startPhase.store (juce::MathConstants<float>::twoPi * static_cast<float> (fraction), std::memory_order_relaxed);
+    }
+    else
+    {
+        _startPhase.store (0.0f, std::memory_order_relaxed);
+    }
+}
+
+template <typename SampleType>
+ProcessorModulator<SampleType>::ProcessorModulator(OscillatorWrapper& modulator, size_t updateRate)
         :   _modulator(modulator), 
+            _updateCounter(updateRate),
             _updateRate(updateRate)
 {
 }
 
-void ProcessorModulator::prepare (const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
+    _sampleRate = spec.sampleRate;
    _modulator.prepare ({ spec.sampleRate / _updateRate, spec.maximumBlockSize, spec.numChannels });
+    _floatBuffer.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize), false, false, true);
     reset();
 }
 
-void ProcessorModulator::reset()
+template <typename SampleType>
+void ProcessorModulator<SampleType>::reset()
 {
     _modulator.reset();
     _updateCounter = _updateRate;
 }
 
-void ProcessorModulator::process (const juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    processBlock (context);
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
 {
-    auto& outputBlock      = context.getOutputBlock();
-    const auto numSamples  = outputBlock.getNumSamples();
+    processBlock (context);
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+{
+    processBlock (context);
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+{
+    processBlock (context);
+}
+
+template <typename SampleType>
+template <typename ProcessContext>
+void ProcessorModulator<SampleType>::processBlock (const ProcessContext& context)
+{
+    const auto numSamples  = context.getOutputBlock().getNumSamples();
+
+    if (! _modulationEnabled)
+    {
+        processSubBlock (context);
+        return;
+    }
 
     for (size_t pos = 0; pos < (size_t) numSamples; )
     {
         auto numSamplesToProcess = juce::jmin ((size_t) numSamples - pos, _updateCounter);
-        auto subBlock = outputBlock.getSubBlock (pos, numSamplesToProcess);
-
-        juce::dsp::ProcessContextReplacing<float> subContext (subBlock);
+        auto outputSubBlock = context.getOutputBlock().getSubBlock (pos, numSamplesToProcess);
 
-        if (_processorToModulate != nullptr)
-            _processorToModulate->process(subContext);
+        if constexpr (ProcessContext::usesSeparateInputAndOutputBlocks())
+        {
+            const auto inputSubBlock = context.getInputBlock().getSubBlock (pos, numSamplesToProcess);
+            processSubBlock (ProcessContext (inputSubBlock, outputSubBlock));
+        }
+        else
+        {
+            processSubBlock (ProcessContext (outputSubBlock));
+        }
 
         pos += numSamplesToProcess;
         _updateCounter -= numSamplesToProcess;
@@ -40,46 +101,204 @@ void ProcessorModulator::process (const juce::dsp::ProcessContextReplacing<float
         {
             _updateCounter = _updateRate;
 
-            float targetValue;
+            SampleType targetValue;
 
             if (_modulator.getFrequency() != 0)
             {
-                float modulatorOut = _modulator.processSample (0.0f);
-                targetValue = juce::jmap (modulatorOut, -1.0f, 1.0f, _modulationRange.getStart(), _modulationRange.getEnd());
+                SampleType modulatorOut = static_cast<SampleType> (_modulator.processSample (0.0f));
+                targetValue = juce::jmap (modulatorOut, (SampleType) -1, (SampleType) 1, _modulationRange.getStart(), _modulationRange.getEnd());
             }
             else
             {
-                targetValue = 0.0f;                    
+                targetValue = 0.0;                    
             }
             
             if (_modulationTarget)
                 _modulationTarget(targetValue);
+
+            if (_meteringFeed != nullptr)
+                _meteringFeed->setModulation (static_cast<float> (targetValue));
         }
     }
 }
 
-void ProcessorModulator::setProcessorToModulate (juce::dsp::ProcessorBase& newProcessor)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::processSubBlock (const juce::dsp::ProcessContextReplacing<float>& subContext)
+{
+    if (_processorToModulate != nullptr)
+        _processorToModulate->process(subContext);
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::processSubBlock (const juce::dsp::ProcessContextReplacing<double>& subContext)
+{
+    if (_multiPrecisionProcessorToModulate != nullptr)
+        _multiPrecisionProcessorToModulate->process(subContext);
+    else if (_processorToModulate != nullptr)
+        processAsFloat (subContext.getInputBlock(), subContext.getOutputBlock());
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::processSubBlock (const juce::dsp::ProcessContextNonReplacing<float>& subContext)
+{
+    if (_multiPrecisionProcessorToModulate != nullptr)
+    {
+        _multiPrecisionProcessorToModulate->process (subContext);
+        return;
+    }
+
+    subContext.getOutputBlock().copyFrom (subContext.getInputBlock());
+    processSubBlock (juce::dsp::ProcessContextReplacing<float> (subContext.getOutputBlock()));
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::processSubBlock (const juce::dsp::ProcessContextNonReplacing<double>& subContext)
+{
+    if (_multiPrecisionProcessorToModulate != nullptr)
+        _multiPrecisionProcessorToModulate->process (subContext);
+    else if (_processorToModulate != nullptr)
+        processAsFloat (subContext.getInputBlock(), subContext.getOutputBlock());
+    else
+        subContext.getOutputBlock().copyFrom (subContext.getInputBlock());
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::processAsFloat (const juce::dsp::AudioBlock<const double>& input, const juce::dsp::AudioBlock<double>& output)
+{
+    const auto numChannels = output.getNumChannels();
+    const auto numSamples = output.getNumSamples();
+
+    jassert (numChannels <= static_cast<size_t> (_floatBuffer.getNumChannels()) && numSamples <= static_cast<size_t> (_floatBuffer.getNumSamples()));
+
+    auto floatBlock = juce::dsp::AudioBlock<float> (_floatBuffer).getSubsetChannelBlock (0, numChannels).getSubBlock (0, numSamples);
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+        std::copy (input.getChannelPointer (ch), input.getChannelPointer (ch) + numSamples, floatBlock.getChannelPointer (ch));
+
+    _processorToModulate->process (juce::dsp::ProcessContextReplacing<float> (floatBlock));
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+        std::copy (floatBlock.getChannelPointer (ch), floatBlock.getChannelPointer (ch) + numSamples, output.getChannelPointer (ch));
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setProcessorToModulate (juce::dsp::ProcessorBase& newProcessor)
 {
     _processorToModulate = &newProcessor;
+    _multiPrecisionProcessorToModulate = dynamic_cast<MultiPrecisionProcessor*> (&newProcessor);
     _modulationTarget = nullptr;
 }
 
-void ProcessorModulator::setModulationWaveform(OscillatorWrapper::Waveform newWaveform, size_t numSamples)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setModulationWaveform(OscillatorWrapper::Waveform newWaveform, size_t numSamples)
 {
     _modulator.setWaveform(newWaveform, numSamples);
 }
 
-void ProcessorModulator::setModulationTarget(const std::function<void(float)>& newModulationTarget)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setModulationTarget(const std::function<void(SampleType)>& newModulationTarget)
 {
     _modulationTarget = newModulationTarget;
 }
 
-void ProcessorModulator::setModulationFrequency (float newFrequency)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setModulationFrequency (float newFrequency)
 {
     _modulator.setFrequency(newFrequency);
 }
 
-void ProcessorModulator::setModulationRange (const juce::Range<float>& newRange)
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setModulationRange (const juce::Range<SampleType>& newRange)
 {
     _modulationRange = newRange;
 }
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setParameters (const Parameters& parameters)
+{
+    setModulationFrequency (parameters.frequency);
+    setModulationRange (parameters.range);
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setUpdateRate (size_t newUpdateRate)
+{
+    jassert (newUpdateRate > 0);
+
+    _updateRate = juce::jmax (static_cast<size_t> (1), newUpdateRate);
+    _updateCounter = juce::jmin (_updateCounter, _updateRate);
+
+    if (_sampleRate > 0)
+        _modulator.setSampleRate (_sampleRate / static_cast<double> (_updateRate));
+}
+
+template <typename SampleType>
+size_t ProcessorModulator<SampleType>::getUpdateRate() const
+{
+    return _updateRate;
+}
+
+template <typename SampleType>
+size_t ProcessorModulator<SampleType>::getSamplesUntilNextUpdate() const
+{
+    return _updateCounter;
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setModulationEnabled (bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == _modulationEnabled)
+        return;
+
+    _modulationEnabled = shouldBeEnabled;
+
+    if (_modulationEnabled)
+        return;
+
+    const auto centre = _modulationRange.getStart() + _modulationRange.getLength() / static_cast<SampleType> (2);
+
+    if (_modulationTarget)
+        _modulationTarget (centre);
+
+    if (_meteringFeed != nullptr)
+        _meteringFeed->setModulation (static_cast<float> (centre));
+}
+
+template <typename SampleType>
+bool ProcessorModulator<SampleType>::isModulationEnabled() const
+{
+    return _modulationEnabled;
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::setMeteringFeed (MeteringFeed* feed)
+{
+    _meteringFeed = feed;
+}
+
+template <typename SampleType>
+void ProcessorModulator<SampleType>::saveState (StateWriter& writer) const
+{
+    writer.writeTag ("PMOD");
+    writer.write (static_cast<juce::uint64> (_updateRate));
+    writer.write (static_cast<juce::uint64> (_updateCounter));
+    writer.write (_modulationRange);
+    _modulator.saveState (writer);
+}
+
+template <typename SampleType>
+bool ProcessorModulator<SampleType>::restoreState (StateReader& reader)
+{
+    juce::uint64 updateRate = 0;
+    juce::uint64 updateCounter = 0;
+
+    if (! reader.readTag ("PMOD") || ! reader.read (updateRate) || updateRate != _updateRate || ! reader.read (updateCounter))
+        return false;
+
+    _updateCounter = static_cast<size_t> (updateCounter);
+
+    return reader.read (_modulationRange) && _modulator.restoreState (reader);
+}
+
+template class ProcessorModulator<float>;
+template class ProcessorModulator<double>;
@@ -1,5 +1,7 @@
 #pragma once
 
+// Table lookup oscillator with the same arithmetic as juce::dsp::Oscillator<float>, which keeps its
+// phase private. Owning the phase here lets the modulation be saved and resumed exactly.
 class OscillatorWrapper : public juce::dsp::ProcessorBase
 {
 public:
@@ -13,77 +15,218 @@ public:
 
     virtual void prepare (const juce::dsp::ProcessSpec& spec) override
     {
-        _oscillator.prepare(spec);
+        _sampleRate = static_cast<float> (spec.sampleRate);
+        _rampBuffer.resize (spec.maximumBlockSize);
+        reset();
     }
 
     virtual void reset() override
     {
-        _oscillator.reset();
+        _phase = _startPhase.load (std::memory_order_relaxed);
+
+        if (_sampleRate > 0)
+            _frequency.reset (_sampleRate, 0.05);
     }
 
+    // adds the waveform to every channel
     virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
     {
-        _oscillator.process(context);
+        auto& block = context.getOutputBlock();
+        const auto numSamples = block.getNumSamples();
+        const auto baseIncrement = juce::MathConstants<float>::twoPi / _sampleRate;
+        const auto* table = _table.load (std::memory_order_acquire);
+
+        jassert (numSamples <= _rampBuffer.size());
+
+        if (_frequency.isSmoothing())
+        {
+            for (size_t i = 0; i < numSamples; i++)
+                _rampBuffer[i] = advancePhase (_phase, baseIncrement * _frequency.getNextValue()) - juce::MathConstants<float>::pi;
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+            {
+                auto* samples = block.getChannelPointer (ch);
+
+                for (size_t i = 0; i < numSamples; i++)
+                    samples[i] += generate (table, _rampBuffer[i]);
+            }
+        }
+        else
+        {
+            const auto increment = baseIncrement * _frequency.getNextValue();
+            auto phase = _phase;
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+            {
+                auto* samples = block.getChannelPointer (ch);
+                phase = _phase;
+
+                for (size_t i = 0; i < numSamples; i++)
+                    samples[i] += generate (table, advancePhase (phase, increment) - juce::MathConstants<float>::pi);
+            }
+
+            _phase = phase;
+        }
+    }
+
+    float processSample (float input)
+    {
+        const auto increment = juce::MathConstants<float>::twoPi * _frequency.getNextValue() / _sampleRate;
+
+        return input + generate (_table.load (std::memory_order_acquire), advancePhase (_phase, increment) - juce::MathConstants<float>::pi);
+    }
+
+    // Tables come from the WaveformTableRegistry and are shared with every other oscillator of the
+    // same waveform and size; the first oscillator asking for one builds it. The oscillator switches
+    // with an atomic pointer swap, so this can be called while the audio thread processes. Without a
+    // table the waveform is computed for every sample.
+    // Every Random oscillator of a given size reads the same sequence, so binding a Random table also
+    // gives this oscillator its own start phase, spread from the others by the golden ratio; it
+    // applies from the next reset() or prepare(). Other waveforms start at phase 0.
+    void setWaveform (Waveform newWaveform, size_t numSamples = 256);
+
+    // changes the rate processSample() is called at, keeping the phase
+    void setSampleRate (double newSampleRate)
+    {
+        _sampleRate = static_cast<float> (newSampleRate);
+        _frequency.reset (_sampleRate, 0.05);
+    }
+
+    void setFrequency (float newFrequency) { _frequency.setTargetValue (newFrequency); }
+    float getFrequency() const { return _frequency.getTargetValue(); }
+
+    // the waveform is configuration and is not included
+    void saveState (StateWriter& writer) const
+    {
+        writer.writeTag ("OSCW");
+        writer.write (_sampleRate);
+        writer.write (_phase);
+        writer.write (_frequency);
     }
 
-    float processSample(float input)
+    bool restoreState (StateReader& reader)
     {
-        return _oscillator.processSample(input);
+        float sampleRate = 0.0f;
+
+        if (! reader.readTag ("OSCW") || ! reader.read (sampleRate) || sampleRate != _sampleRate)
+            return false;
+
+        return reader.read (_phase) && reader.read (_frequency);
     }
 
-    void setWaveform(Waveform newWaveform, size_t numSamples = 256)
+private:
+    // x in [-pi, pi)
+    float generate (const juce::dsp::LookupTableTransform<float>* table, float x) const
     {
-        switch (newWaveform)
+        if (table != nullptr)
+            return (*table) (x);
+
+        switch (_waveform.load (std::memory_order_relaxed))
         {
-            case Sine:
-                _oscillator.initialise([] (float x) { return std::sin(x); }, numSamples);
-                break;
-            
             case Square:
-                _oscillator.initialise([] (float x) {return x < 0.0f ? -1.0f : 1.0f; }, numSamples);
-                break;
-            
+                return x < 0.0f ? -1.0f : 1.0f;
+
             case Saw:
-                _oscillator.initialise([] (float x) {return x / juce::MathConstants<float>::pi; }, numSamples);
-                break;
-            
+                return x / juce::MathConstants<float>::pi;
+
             case Random:
-                _oscillator.initialise([] (float x) { (void) x; return 2.0 * std::rand() / RAND_MAX - 1.0; }, numSamples);
-                break;
+                return static_cast<float> (2.0 * std::rand() / RAND_MAX - 1.0);
 
+            case Sine:
             default:
-                _oscillator.initialise([] (float x) { return std::sin(x); }, numSamples);
-                break;
+                return std::sin (x);
         }
     }
 
-    void setFrequency(float newFrequency) { _oscillator.setFrequency(newFrequency); }
-    float getFrequency() const { return _oscillator.getFrequency(); }
+    // returns the phase before advancing, wrapped to [0, 2pi) like juce::dsp::Phase
+    static float advancePhase (float& phase, float increment)
+    {
+        const auto last = phase;
+        auto next = last + increment;
 
-private:
-    juce::dsp::Oscillator<float> _oscillator;
+        while (next >= juce::MathConstants<float>::twoPi)
+            next -= juce::MathConstants<float>::twoPi;
+
+        phase = next;
+
+        return last;
+    }
+
+    // owned by the WaveformTableRegistry; _waveform is only read while there is no table
+    std::atomic<const juce::dsp::LookupTableTransform<float>*> _table{ nullptr };
+    std::atomic<Waveform> _waveform{ Sine };
+    std::atomic<float> _startPhase{ 0.0f };
+    juce::LinearSmoothedValue<float> _frequency{ 440.0f };
+    float _sampleRate = 48000.0f;
+    float _phase = 0.0f;
+    std::vector<float> _rampBuffer;
 };
 
-class ProcessorModulator : public juce::dsp::ProcessorBase
+template <typename SampleType = float>
+class ProcessorModulator : public MultiPrecisionProcessor
 {
 public:
+    struct Parameters
+    {
+        float frequency = 0.0f;
+        juce::Range<SampleType> range;
+    };
+
     ProcessorModulator(OscillatorWrapper& modulator, size_t updateRate);
 
     virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
     virtual void reset() override;
     virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+    // the modulated processor reads the input block directly if it derives from MultiPrecisionProcessor
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
 
+    // Processors not deriving from MultiPrecisionProcessor only process float, so double blocks are
+    // converted to float and back for them.
     void setProcessorToModulate (juce::dsp::ProcessorBase& newProcessor);
     void setModulationWaveform(OscillatorWrapper::Waveform newWaveform, size_t numSamples = 256);
-    void setModulationTarget(const std::function<void(float)>& newModulationTarget);
+    void setModulationTarget(const std::function<void(SampleType)>& newModulationTarget);
     void setModulationFrequency (float newFrequency);
-    void setModulationRange (const juce::Range<float>& newRange);
+    void setModulationRange (const juce::Range<SampleType>& newRange);
+    void setParameters (const Parameters& parameters);
+
+    // Cheaper modulation under load. The oscillator keeps its phase across update rate changes, and
+    // disabling sends the centre of the range to the target once, after which blocks are processed
+    // whole. Targets that ramp, like the delay setters, make both changes click-free.
+    void setUpdateRate (size_t newUpdateRate);
+    size_t getUpdateRate() const;
+    // samples left before the next modulation value is sent, counted from the end of the last block
+    size_t getSamplesUntilNextUpdate() const;
+    void setModulationEnabled (bool shouldBeEnabled);
+    bool isModulationEnabled() const;
+
+    // reports every new modulation value from the audio thread, nullptr stops; set it between blocks
+    void setMeteringFeed (MeteringFeed* feed);
+
+    // includes the oscillator, but not the modulated processor, which saves its own state
+    void saveState (StateWriter& writer) const;
+    bool restoreState (StateReader& reader);
 
 private:
+    template <typename ProcessContext>
+    void processBlock (const ProcessContext& context);
+
+    void processSubBlock (const juce::dsp::ProcessContextReplacing<float>& subContext);
+    void processSubBlock (const juce::dsp::ProcessContextReplacing<double>& subContext);
+    void processSubBlock (const juce::dsp::ProcessContextNonReplacing<float>& subContext);
+    void processSubBlock (const juce::dsp::ProcessContextNonReplacing<double>& subContext);
+    void processAsFloat (const juce::dsp::AudioBlock<const double>& input, const juce::dsp::AudioBlock<double>& output);
+
     OscillatorWrapper& _modulator;
     juce::dsp::ProcessorBase* _processorToModulate = nullptr;
-    std::function<void(float)> _modulationTarget = nullptr;
-    juce::Range<float> _modulationRange;
+    MultiPrecisionProcessor* _multiPrecisionProcessorToModulate = nullptr;
+    std::function<void(SampleType)> _modulationTarget = nullptr;
+    juce::Range<SampleType> _modulationRange;
     size_t _updateCounter;
     size_t _updateRate;
+    double _sampleRate = 0.0;
+    bool _modulationEnabled = true;
+    MeteringFeed* _meteringFeed = nullptr;
+    juce::AudioBuffer<float> _floatBuffer;
 };
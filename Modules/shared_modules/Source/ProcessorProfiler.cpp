@@ -0,0 +1,90 @@
+#include "ProcessorProfiler.h"
+
+ProcessorProfiler::ProcessorProfiler()
+{
+    for (auto& bin : _bins)
+        bin.store (0);
+}
+
+void ProcessorProfiler::record (double nsPerSample)
+{
+    if (_clearRequested.exchange (false, std::memory_order_acquire))
+    {
+        for (auto& bin : _bins)
+            bin.store (0, std::memory_order_relaxed);
+
+        _maxNsPerSample.store (0.0, std::memory_order_relaxed);
+        _numCalls.store (0, std::memory_order_relaxed);
+    }
+
+    // there is a single writer, so plain load/store pairs are enough
+    auto& bin = _bins[getBinIndex (nsPerSample)];
+    bin.store (bin.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (nsPerSample > _maxNsPerSample.load (std::memory_order_relaxed))
+        _maxNsPerSample.store (nsPerSample, std::memory_order_relaxed);
+
+    _numCalls.store (_numCalls.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+ProcessorProfiler::Statistics ProcessorProfiler::getStatistics() const
+{
+    Statistics statistics;
+
+    std::array<juce::uint32, numBins> bins;
+    juce::uint64 total = 0;
+
+    for (size_t i = 0; i < numBins; i++)
+    {
+        bins[i] = _bins[i].load (std::memory_order_relaxed);
+        total += bins[i];
+    }
+
+    statistics.numCalls = _numCalls.load (std::memory_order_acquire);
+    statistics.maxNsPerSample = _maxNsPerSample.load (std::memory_order_relaxed);
+
+    if (total == 0)
+        return statistics;
+
+    const auto getPercentile = [&] (double percentile)
+    {
+        auto rank = static_cast<juce::uint64> (std::ceil (percentile * static_cast<double> (total)));
+        juce::uint64 count = 0;
+
+        for (size_t i = 0; i < numBins; i++)
+        {
+            count += bins[i];
+
+            if (count >= rank)
+                return juce::jmin (getBinValue (i), statistics.maxNsPerSample);
+        }
+
+        return statistics.maxNsPerSample;
+    };
+
+    statistics.p50NsPerSample = getPercentile (0.5);
+    statistics.p99NsPerSample = getPercentile (0.99);
+
+    return statistics;
+}
+
+void ProcessorProfiler::clear()
+{
+    _clearRequested.store (true, std::memory_order_release);
+}
+
+size_t ProcessorProfiler::getBinIndex (double nsPerSample)
+{
+    if (nsPerSample <= 0.0)
+        return 0;
+
+    auto index = static_cast<int> (std::floor ((std::log2 (nsPerSample) - minOctave) * binsPerOctave));
+
+    return static_cast<size_t> (juce::jlimit (0, static_cast<int> (numBins) - 1, index));
+}
+
+double ProcessorProfiler::getBinValue (size_t binIndex)
+{
+    // upper edge of the bin, so percentiles are never under-reported
+    return std::exp2 (static_cast<double> (binIndex + 1) / binsPerOctave + minOctave);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+class ProcessorProfiler
+{
+public:
+    struct Statistics
+    {
+        double p50NsPerSample = 0.0;
+        double p99NsPerSample = 0.0;
+        double maxNsPerSample = 0.0;
+        juce::uint64 numCalls = 0;
+    };
+
+    ProcessorProfiler();
+
+    // audio thread only
+    void record (double nsPerSample);
+
+    // any thread, never blocks the audio thread
+    Statistics getStatistics() const;
+    void clear();
+
+private:
+    static constexpr int binsPerOctave = 8;
+    static constexpr int minOctave = -4;
+    static constexpr size_t numBins = 16 * binsPerOctave;
+
+    static size_t getBinIndex (double nsPerSample);
+    static double getBinValue (size_t binIndex);
+
+    std::array<std::atomic<juce::uint32>, numBins> _bins;
+    std::atomic<double> _maxNsPerSample{ 0.0 };
+    std::atomic<juce::uint64> _numCalls{ 0 };
+    std::atomic<bool> _clearRequested{ false };
+};
+
+#if SHARED_MODULES_ENABLE_PROFILING
+
+template <typename ProcessorType>
+class Profiled : public ProcessorType
+{
+public:
+    using ProcessorType::ProcessorType;
+    using ProcessorType::process;
+
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+    {
+        processAndRecord (context);
+    }
+
+    // These override the other MultiPrecisionProcessor overloads, which TiledChain,
+    // ProcessorModulator and the Batched processors call too. Other processors have no such
+    // overloads, and calling these on them does not compile.
+    void process (const juce::dsp::ProcessContextReplacing<double>& context)
+    {
+        processAndRecord (context);
+    }
+
+    void process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+    {
+        processAndRecord (context);
+    }
+
+    void process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+    {
+        processAndRecord (context);
+    }
+
+    const ProcessorProfiler& getProfiler() const { return _profiler; }
+    ProcessorProfiler& getProfiler() { return _profiler; }
+
+private:
+    template <typename ProcessContext>
+    void processAndRecord (const ProcessContext& context)
+    {
+        constexpr auto isMultiPrecision = std::is_base_of_v<MultiPrecisionProcessor, ProcessorType>;
+
+        if constexpr (isMultiPrecision || std::is_same_v<ProcessContext, juce::dsp::ProcessContextReplacing<float>>)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            ProcessorType::process (context);
+
+            const auto elapsed = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now() - start).count();
+            const auto numSamples = context.getOutputBlock().getNumSamples();
+
+            if (numSamples > 0)
+                _profiler.record (elapsed / static_cast<double> (numSamples));
+        }
+        else
+        {
+            static_assert (isMultiPrecision, "only MultiPrecisionProcessors process double or out of place blocks");
+        }
+    }
+
+    ProcessorProfiler _profiler;
+};
+
+#else
+
+// profiling compiled out: process() is not overridden, so a Profiled processor is the processor itself
+template <typename ProcessorType>
+class Profiled : public ProcessorType
+{
+public:
+    using ProcessorType::ProcessorType;
+
+    static ProcessorProfiler& getProfiler()
+    {
+        static ProcessorProfiler emptyProfiler;
+        return emptyProfiler;
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "QualityGovernor.h"
+
+QualityGovernor::QualityGovernor (juce::dsp::ProcessorBase& processor, int numTiers, TierCallback applyTier)
+    : QualityGovernor (processor, numTiers, std::move (applyTier), Settings())
+{
+}
+
+QualityGovernor::QualityGovernor (juce::dsp::ProcessorBase& processor, int numTiers, TierCallback applyTier, Settings settings)
+    : _processor (processor),
+      _numTiers (juce::jmax (1, numTiers)),
+      _applyTier (std::move (applyTier)),
+      _settings (settings)
+{
+    jassert (settings.upgradeLoad < settings.downgradeLoad);
+}
+
+void QualityGovernor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    _sampleRate = spec.sampleRate;
+    _processor.prepare (spec);
+
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    _processor.reset();
+
+    _blocksOverLoad = 0;
+    _secondsUnderLoad = 0.0;
+    _load = 0.0;
+
+    if (_tier.load() != 0)
+        setTier (0);
+}
+
+void QualityGovernor::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    _processor.process (context);
+
+    const auto elapsed = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+    recordBlock (elapsed, context.getOutputBlock().getNumSamples());
+}
+
+bool QualityGovernor::recordBlock (double elapsedSeconds, size_t numSamples)
+{
+    jassert (_sampleRate > 0);
+
+    if (numSamples == 0 || _sampleRate <= 0)
+        return false;
+
+    const auto deadline = static_cast<double> (numSamples) / _sampleRate;
+    const auto load = elapsedSeconds / deadline;
+    const auto tier = _tier.load();
+
+    _load = load;
+
+    if (load > _settings.downgradeLoad)
+    {
+        _secondsUnderLoad = 0.0;
+
+        if (++_blocksOverLoad < _settings.blocksBeforeDowngrade || tier == _numTiers - 1)
+            return false;
+
+        _blocksOverLoad = 0;
+        setTier (tier + 1);
+
+        return true;
+    }
+
+    _blocksOverLoad = 0;
+
+    if (load >= _settings.upgradeLoad)
+    {
+        _secondsUnderLoad = 0.0;
+        return false;
+    }
+
+    _secondsUnderLoad += deadline;
+
+    if (_secondsUnderLoad < _settings.upgradeHoldSeconds || tier == 0)
+        return false;
+
+    _secondsUnderLoad = 0.0;
+    setTier (tier - 1);
+
+    return true;
+}
+
+int QualityGovernor::getTier() const
+{
+    return _tier.load();
+}
+
+double QualityGovernor::getLoad() const
+{
+    return _load.load();
+}
+
+juce::uint32 QualityGovernor::getNumTierChanges() const
+{
+    return _numTierChanges.load();
+}
+
+void QualityGovernor::setTier (int newTier)
+{
+    _tier = newTier;
+    _numTierChanges++;
+
+    if (_applyTier)
+        _applyTier (newTier);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Keeps a processor within its CPU budget by stepping through quality tiers. Every block is timed
+// against its deadline, numSamples / sampleRate. Tier 0 is full quality, and each higher tier should
+// be cheaper. A few consecutive blocks over the downgrade load move one tier down in quality. The
+// governor only moves back up after upgradeHoldSeconds of audio in a row under the lower upgrade load,
+// so a tier that only just fits is not left and re-entered on every block.
+//
+// The tier callback runs on the audio thread, between blocks. It should switch controls that ramp,
+// such as VariableDelayLine::setNumActiveTaps(), ProcessorModulator::setUpdateRate() and
+// ProcessorModulator::setModulationEnabled(), which crossfade over their smoothing time.
+class QualityGovernor : public juce::dsp::ProcessorBase
+{
+public:
+    using TierCallback = std::function<void (int tier)>;
+
+    struct Settings
+    {
+        double downgradeLoad = 0.75; // fractions of the block deadline
+        double upgradeLoad = 0.4;
+        int blocksBeforeDowngrade = 3;
+        double upgradeHoldSeconds = 2.0;
+    };
+
+    QualityGovernor (juce::dsp::ProcessorBase& processor, int numTiers, TierCallback applyTier);
+    QualityGovernor (juce::dsp::ProcessorBase& processor, int numTiers, TierCallback applyTier, Settings settings);
+
+    // back to tier 0, applied through the callback
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+
+    // The decision part of process(), for hosts that time the processor themselves. Returns true if
+    // the tier changed, in which case the callback has been called.
+    bool recordBlock (double elapsedSeconds, size_t numSamples);
+
+    // any thread, for monitoring
+    int getTier() const;
+    double getLoad() const; // of the last block
+    juce::uint32 getNumTierChanges() const;
+
+private:
+    void setTier (int newTier);
+
+    juce::dsp::ProcessorBase& _processor;
+    int _numTiers;
+    TierCallback _applyTier;
+    Settings _settings;
+    double _sampleRate = 0.0;
+
+    int _blocksOverLoad = 0;
+    double _secondsUnderLoad = 0.0;
+
+    std::atomic<int> _tier{ 0 };
+    std::atomic<double> _load{ 0.0 };
+    std::atomic<juce::uint32> _numTierChanges{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (QualityGovernor)
+};
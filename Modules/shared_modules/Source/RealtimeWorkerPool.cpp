@@ -0,0 +1,202 @@
+#include "RealtimeWorkerPool.h"
+
+#if JUCE_WINDOWS
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#if JUCE_LINUX
+    #include <climits>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#if JUCE_INTEL
+    #include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr int numSpinsBeforeSleeping = 4096;
+
+    inline void pauseCpu()
+    {
+#if JUCE_INTEL
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // best effort, the pool works without it
+    void setRealtimePriority()
+    {
+#if JUCE_WINDOWS
+        SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+        sched_param param{};
+        param.sched_priority = sched_get_priority_max (SCHED_FIFO) - 1;
+        pthread_setschedparam (pthread_self(), SCHED_FIFO, &param);
+#endif
+    }
+} // namespace
+
+RealtimeWorkerPool::RealtimeWorkerPool (size_t numWorkers)
+    : _numThreads (numWorkers + 1),
+      _cursors (numWorkers)
+{
+    _workers.reserve (numWorkers);
+
+    for (size_t w = 0; w < numWorkers; w++)
+        _workers.emplace_back ([this, w] { workerLoop (w); });
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    _shouldExit = true;
+    _generation.fetch_add (1);
+    wakeWorkers();
+
+    for (auto& worker : _workers)
+        worker.join();
+}
+
+void RealtimeWorkerPool::run (Task task, void* context, size_t numTasks)
+{
+    const auto generation = _generation.load (std::memory_order_relaxed) + 1;
+
+    // Cursors of the new generation turn away workers still leaving the last run. If one has not left
+    // yet it may be reading the run's fields, so they stay as they are and the tasks run here.
+    for (auto& cursor : _cursors)
+        cursor.value.store (static_cast<juce::uint64> (generation) << 32);
+
+    if (_numWorkersInRun.load() != 0)
+    {
+        for (size_t t = 0; t < numTasks; t++)
+            task (context, t);
+
+        return;
+    }
+
+    _task = task;
+    _context = context;
+    _numTasks = numTasks;
+    _numTasksDone.store (0, std::memory_order_relaxed);
+
+    _generation.store (generation);
+
+    if (_numSleeping.load() > 0)
+        wakeWorkers();
+
+    size_t numOwnTasks = 0;
+
+    for (size_t t = 0; t < numTasks; t += _numThreads)
+    {
+        task (context, t);
+        numOwnTasks++;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + _takeoverDeadline;
+    auto tookOver = false;
+
+    while (_numTasksDone.load (std::memory_order_acquire) + numOwnTasks < numTasks)
+    {
+        // after the deadline only tasks a worker is in the middle of are waited for
+        if (! tookOver && std::chrono::steady_clock::now() >= deadline)
+        {
+            for (size_t w = 0; w < _cursors.size(); w++)
+                runTasks (w + 1, generation);
+
+            tookOver = true;
+        }
+
+        pauseCpu();
+    }
+}
+
+void RealtimeWorkerPool::setTakeoverDeadline (std::chrono::microseconds deadline)
+{
+    _takeoverDeadline = deadline;
+}
+
+void RealtimeWorkerPool::workerLoop (size_t workerIndex)
+{
+    setRealtimePriority();
+
+    juce::uint32 generation = 0;
+
+    for (;;)
+    {
+        generation = waitForNextGeneration (generation);
+
+        if (_shouldExit)
+            return;
+
+        _numWorkersInRun.fetch_add (1);
+        runTasks (workerIndex + 1, generation);
+        _numWorkersInRun.fetch_sub (1);
+    }
+}
+
+void RealtimeWorkerPool::runTasks (size_t threadIndex, juce::uint32 generation)
+{
+    auto& cursor = _cursors[threadIndex - 1].value;
+
+    for (;;)
+    {
+        auto claimed = cursor.load();
+
+        do
+        {
+            if (static_cast<juce::uint32> (claimed >> 32) != generation)
+                return;
+        } while (! cursor.compare_exchange_weak (claimed, claimed + 1));
+
+        const auto t = threadIndex + static_cast<size_t> (claimed & 0xffffffff) * _numThreads;
+
+        if (t >= _numTasks)
+            return;
+
+        _task (_context, t);
+        _numTasksDone.fetch_add (1, std::memory_order_release);
+    }
+}
+
+juce::uint32 RealtimeWorkerPool::waitForNextGeneration (juce::uint32 lastGeneration)
+{
+    for (;;)
+    {
+        for (int i = 0; i < numSpinsBeforeSleeping; i++)
+        {
+            auto generation = _generation.load();
+
+            if (generation != lastGeneration)
+                return generation;
+
+            pauseCpu();
+        }
+
+        // idle for a while: sleep until the next run instead of burning the core
+        _numSleeping.fetch_add (1);
+
+#if JUCE_LINUX
+        static_assert (sizeof (_generation) == sizeof (int), "futex word must be 32 bits");
+        syscall (SYS_futex, reinterpret_cast<int*> (&_generation), FUTEX_WAIT_PRIVATE, static_cast<int> (lastGeneration), nullptr, nullptr, 0);
+#else
+        while (_generation.load() == lastGeneration)
+            std::this_thread::yield();
+#endif
+
+        _numSleeping.fetch_sub (1);
+    }
+}
+
+void RealtimeWorkerPool::wakeWorkers()
+{
+#if JUCE_LINUX
+    syscall (SYS_futex, reinterpret_cast<int*> (&_generation), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
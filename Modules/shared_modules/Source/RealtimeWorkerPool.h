@@ -0,0 +1,57 @@
+#pragma once
+
+class RealtimeWorkerPool
+{
+public:
+    using Task = void (*) (void* context, size_t taskIndex);
+
+    // The workers ask for realtime priority, which the system may refuse, e.g. without the rights to
+    // it on Linux. They then run at default priority and the calling thread takes over what they are
+    // late with, see run().
+    RealtimeWorkerPool (size_t numWorkers);
+    ~RealtimeWorkerPool();
+
+    // Runs task(context, i) for every i < numTasks and returns once all of them are done.
+    // Task i is meant for thread i % (numWorkers + 1), the calling thread being thread 0, so the
+    // handoff needs no queue and never allocates. Once the calling thread is done with its own tasks
+    // it waits for the workers until the takeover deadline and then runs the tasks they have not
+    // started yet itself, so a worker that is descheduled only holds up the task it is running.
+    void run (Task task, void* context, size_t numTasks);
+
+    // how long the calling thread waits before taking over tasks, 50 us by default
+    void setTakeoverDeadline (std::chrono::microseconds deadline);
+
+    size_t getNumWorkers() const { return _workers.size(); }
+    size_t getNumThreads() const { return _numThreads; }
+
+private:
+    // the next task of one thread, the run's generation in the upper 32 bits and the number of the
+    // thread's tasks claimed so far in the lower ones
+    struct alignas (64) Cursor
+    {
+        std::atomic<juce::uint64> value{ 0 };
+    };
+
+    void workerLoop (size_t workerIndex);
+    juce::uint32 waitForNextGeneration (juce::uint32 lastGeneration);
+    void wakeWorkers();
+    // claims and runs the thread's tasks until there are none left in the generation
+    void runTasks (size_t threadIndex, juce::uint32 generation);
+
+    size_t _numThreads;
+    std::vector<Cursor> _cursors; // one per worker, thread 0's tasks are only run by the caller
+    std::vector<std::thread> _workers;
+    std::chrono::microseconds _takeoverDeadline{ 50 };
+
+    std::atomic<juce::uint32> _generation{ 0 };
+    std::atomic<size_t> _numTasksDone{ 0 };
+    std::atomic<int> _numWorkersInRun{ 0 };
+    std::atomic<int> _numSleeping{ 0 };
+    std::atomic<bool> _shouldExit{ false };
+
+    Task _task = nullptr;
+    void* _context = nullptr;
+    size_t _numTasks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeWorkerPool)
+};
@@ -0,0 +1,258 @@
+#include "ResampledProcessor.h"
+
+ResampledProcessor::ResampledProcessor (ProcessorFactory factory, double designSampleRate, size_t numTapsPerPhase)
+    : _factory (std::move (factory)),
+      _designSampleRate (designSampleRate),
+      _numTapsPerPhase (numTapsPerPhase)
+{
+    jassert (_designSampleRate > 0.0);
+    jassert (_numTapsPerPhase > 0);
+}
+
+void ResampledProcessor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    const auto factor = juce::jmax (static_cast<size_t> (1), static_cast<size_t> (spec.sampleRate / _designSampleRate));
+    const juce::dsp::ProcessSpec internalSpec{ spec.sampleRate / static_cast<double> (factor),
+                                               static_cast<juce::uint32> (spec.maximumBlockSize / factor + 1),
+                                               spec.numChannels };
+
+    if (_processor == nullptr || internalSpec.sampleRate != _internalSpec.sampleRate
+        || internalSpec.maximumBlockSize != _internalSpec.maximumBlockSize || internalSpec.numChannels != _internalSpec.numChannels)
+    {
+        _processor = _factory (internalSpec, internalSpec.sampleRate / _designSampleRate);
+        jassert (_processor != nullptr);
+    }
+
+    _internalSpec = internalSpec;
+
+    if (factor != _factor || _decimationFilter.empty())
+    {
+        _factor = factor;
+        designFilters();
+    }
+
+    const auto numChannels = static_cast<size_t> (spec.numChannels);
+    const auto fifoSize = static_cast<size_t> (spec.maximumBlockSize) + 2 * _factor;
+
+    if (_decimatorHistory.size() < numChannels)
+    {
+        _decimatorHistory.resize (numChannels);
+        _interpolatorHistory.resize (numChannels);
+        _outputFifo.resize (numChannels);
+    }
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        _decimatorHistory[ch].resize (2 * _filterLength);
+        _interpolatorHistory[ch].resize (2 * _numTapsPerPhase);
+        _outputFifo[ch].resize (fifoSize);
+    }
+
+    _internalBuffer.setSize (static_cast<int> (numChannels), static_cast<int> (internalSpec.maximumBlockSize), false, false, true);
+
+    reset();
+}
+
+void ResampledProcessor::reset()
+{
+    if (_processor != nullptr)
+        _processor->reset();
+
+    for (auto& history : _decimatorHistory)
+        std::fill (history.begin(), history.end(), 0.0f);
+
+    for (auto& history : _interpolatorHistory)
+        std::fill (history.begin(), history.end(), 0.0f);
+
+    for (auto& fifo : _outputFifo)
+        std::fill (fifo.begin(), fifo.end(), 0.0f);
+
+    _decimatorPosition = 0;
+    _interpolatorPosition = 0;
+    _decimationPhase = 0;
+
+    // The k-th decimated sample is taken at input sample k * factor + factor - 1, so with that many
+    // samples of silence ahead of it every interpolated sample lands on the index it was computed for
+    _fifoRead = 0;
+    _fifoWrite = _factor - 1;
+}
+
+void ResampledProcessor::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    if (_factor == 1)
+    {
+        _processor->process (context);
+        return;
+    }
+
+    auto& block = context.getOutputBlock();
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = block.getNumChannels();
+
+    jassert (numChannels <= _decimatorHistory.size());
+    jassert (numSamples <= _outputFifo[0].size() - 2 * _factor);
+
+    // decimate, computing only the samples that are kept
+    size_t numInternalSamples = 0;
+    auto decimatorPosition = _decimatorPosition;
+    auto decimationPhase = _decimationPhase;
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        const auto* input = block.getChannelPointer (ch);
+        auto* internal = _internalBuffer.getWritePointer (static_cast<int> (ch));
+        auto* history = _decimatorHistory[ch].data();
+        const auto* filter = _decimationFilter.data();
+
+        decimatorPosition = _decimatorPosition;
+        decimationPhase = _decimationPhase;
+        numInternalSamples = 0;
+
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            decimatorPosition = (decimatorPosition == 0 ? _filterLength : decimatorPosition) - 1;
+            history[decimatorPosition] = input[i];
+            history[decimatorPosition + _filterLength] = input[i];
+
+            if (++decimationPhase < _factor)
+                continue;
+
+            decimationPhase = 0;
+
+            const auto* window = history + decimatorPosition;
+            float sum = 0.0f;
+
+            for (size_t j = 0; j < _filterLength; j++)
+                sum += filter[j] * window[j];
+
+            internal[numInternalSamples++] = sum;
+        }
+    }
+
+    _decimatorPosition = decimatorPosition;
+    _decimationPhase = decimationPhase;
+
+    if (numInternalSamples > 0)
+    {
+        auto internalBlock = juce::dsp::AudioBlock<float> (_internalBuffer).getSubsetChannelBlock (0, numChannels).getSubBlock (0, numInternalSamples);
+        _processor->process (juce::dsp::ProcessContextReplacing<float> (internalBlock));
+    }
+
+    // interpolate each internal sample into factor output samples, one polyphase branch each
+    const auto fifoSize = _outputFifo[0].size();
+    auto interpolatorPosition = _interpolatorPosition;
+    auto fifoWrite = _fifoWrite;
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        const auto* internal = _internalBuffer.getReadPointer (static_cast<int> (ch));
+        auto* history = _interpolatorHistory[ch].data();
+        auto* fifo = _outputFifo[ch].data();
+
+        interpolatorPosition = _interpolatorPosition;
+        fifoWrite = _fifoWrite;
+
+        for (size_t k = 0; k < numInternalSamples; k++)
+        {
+            interpolatorPosition = (interpolatorPosition == 0 ? _numTapsPerPhase : interpolatorPosition) - 1;
+            history[interpolatorPosition] = internal[k];
+            history[interpolatorPosition + _numTapsPerPhase] = internal[k];
+
+            const auto* window = history + interpolatorPosition;
+
+            for (const auto& phase : _interpolationPhases)
+            {
+                float sum = 0.0f;
+
+                for (size_t t = 0; t < _numTapsPerPhase; t++)
+                    sum += phase[t] * window[t];
+
+                fifo[fifoWrite] = sum;
+                fifoWrite = fifoWrite + 1 == fifoSize ? 0 : fifoWrite + 1;
+            }
+        }
+    }
+
+    _interpolatorPosition = interpolatorPosition;
+    _fifoWrite = fifoWrite;
+
+    auto fifoRead = _fifoRead;
+
+    for (size_t ch = 0; ch < numChannels; ch++)
+    {
+        const auto* fifo = _outputFifo[ch].data();
+        auto* output = block.getChannelPointer (ch);
+
+        fifoRead = _fifoRead;
+
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            output[i] = fifo[fifoRead];
+            fifoRead = fifoRead + 1 == fifoSize ? 0 : fifoRead + 1;
+        }
+    }
+
+    _fifoRead = fifoRead;
+}
+
+size_t ResampledProcessor::getFactor() const
+{
+    return _factor;
+}
+
+double ResampledProcessor::getInternalSampleRate() const
+{
+    return _internalSpec.sampleRate;
+}
+
+int ResampledProcessor::getLatencyInSamples() const
+{
+    if (_factor == 1)
+        return 0;
+
+    // group delay of both linear phase filters, the fifo lead lines the output up with the input
+    return static_cast<int> (_filterLength - 1);
+}
+
+juce::dsp::ProcessorBase& ResampledProcessor::getProcessor()
+{
+    jassert (_processor != nullptr);
+    return *_processor;
+}
+
+void ResampledProcessor::designFilters()
+{
+    _filterLength = _factor * _numTapsPerPhase;
+    _decimationFilter.assign (_filterLength, 0.0f);
+
+    // Blackman windowed sinc, with the transition band ending at the internal Nyquist frequency
+    const auto factor = static_cast<double> (_factor);
+    const auto length = static_cast<double> (_filterLength);
+    const auto transitionWidth = 5.5 / length;
+    const auto cutoff = juce::jmax (0.25 / factor, 0.5 / factor - 0.5 * transitionWidth);
+    const auto centre = 0.5 * (length - 1.0);
+
+    std::vector<double> taps (_filterLength);
+    double sum = 0.0;
+
+    for (size_t n = 0; n < _filterLength; n++)
+    {
+        const auto x = static_cast<double> (n) - centre;
+        const auto sinc = x == 0.0 ? 2.0 * cutoff : std::sin (juce::MathConstants<double>::twoPi * cutoff * x) / (juce::MathConstants<double>::pi * x);
+        const auto phase = juce::MathConstants<double>::twoPi * static_cast<double> (n) / (length - 1.0);
+        const auto window = 0.42 - 0.5 * std::cos (phase) + 0.08 * std::cos (2.0 * phase);
+
+        taps[n] = sinc * window;
+        sum += taps[n];
+    }
+
+    for (size_t n = 0; n < _filterLength; n++)
+        _decimationFilter[n] = static_cast<float> (taps[n] / sum);
+
+    // zero stuffing leaves 1 / factor of the energy, so every branch carries a gain of factor
+    _interpolationPhases.assign (_factor, std::vector<float> (_numTapsPerPhase));
+
+    for (size_t p = 0; p < _factor; p++)
+        for (size_t t = 0; t < _numTapsPerPhase; t++)
+            _interpolationPhases[p][t] = static_cast<float> (factor * taps[p + t * _factor] / sum);
+}
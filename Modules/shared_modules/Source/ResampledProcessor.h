@@ -0,0 +1,59 @@
+#pragma once
+
+// Runs a processor at a reduced internal sample rate, for networks such as a reverb tank whose
+// damped output holds little above a few kHz. The host rate is divided by the largest integer factor
+// that keeps the internal rate at or above the design rate, so the internal rate always lies in
+// [designSampleRate, 2 * designSampleRate) and the wrapped network costs the same memory and CPU
+// at 96 or 192 kHz as at 48. Below the design rate the processor runs at the host rate.
+//
+// The input is decimated and the output interpolated back with windowed-sinc FIR filters in
+// polyphase form, so only the samples that are kept are ever computed. This adds
+// getLatencyInSamples() of delay when the factor is above one.
+class ResampledProcessor : public juce::dsp::ProcessorBase
+{
+public:
+    // Called from prepare() whenever the internal spec changes. It must return a processor prepared
+    // for internalSpec, with its delay lengths, designed in samples at the design rate, multiplied
+    // by delayScale (and its maximum delays sized the same way).
+    using ProcessorFactory = std::function<std::unique_ptr<juce::dsp::ProcessorBase> (const juce::dsp::ProcessSpec& internalSpec, double delayScale)>;
+
+    // the default design rate is the one of Dattorro's plate
+    ResampledProcessor (ProcessorFactory factory, double designSampleRate = 29761.0, size_t numTapsPerPhase = 32);
+
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+
+    size_t getFactor() const;
+    double getInternalSampleRate() const;
+    int getLatencyInSamples() const;
+    juce::dsp::ProcessorBase& getProcessor();
+
+private:
+    void designFilters();
+
+    ProcessorFactory _factory;
+    double _designSampleRate;
+    size_t _numTapsPerPhase;
+
+    std::unique_ptr<juce::dsp::ProcessorBase> _processor;
+    juce::dsp::ProcessSpec _internalSpec{ 0.0, 0, 0 };
+    size_t _factor = 1;
+
+    std::vector<float> _decimationFilter;                 // factor * numTapsPerPhase taps
+    std::vector<std::vector<float>> _interpolationPhases; // [phase][tap], gain included
+    size_t _filterLength = 0;
+
+    std::vector<std::vector<float>> _decimatorHistory;    // [channel][2 * filterLength], newest first
+    std::vector<std::vector<float>> _interpolatorHistory; // [channel][2 * numTapsPerPhase], newest first
+    std::vector<std::vector<float>> _outputFifo;          // [channel][fifoSize]
+    juce::AudioBuffer<float> _internalBuffer;
+
+    size_t _decimatorPosition = 0;
+    size_t _interpolatorPosition = 0;
+    size_t _decimationPhase = 0;
+    size_t _fifoRead = 0;
+    size_t _fifoWrite = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ResampledProcessor)
+};
@@ -0,0 +1,151 @@
+#include "ReservedMemory.h"
+
+#if JUCE_WINDOWS
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+ReservedMemory::~ReservedMemory()
+{
+    release();
+}
+
+ReservedMemory::ReservedMemory (ReservedMemory&& other) noexcept
+    : _data (std::exchange (other._data, nullptr)),
+      _size (std::exchange (other._size, 0))
+{
+}
+
+ReservedMemory& ReservedMemory::operator= (ReservedMemory&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        _data = std::exchange (other._data, nullptr);
+        _size = std::exchange (other._size, 0);
+    }
+
+    return *this;
+}
+
+bool ReservedMemory::reserve (size_t numBytes)
+{
+    release();
+
+    if (numBytes == 0)
+        return true;
+
+    const auto pageSize = getPageSize();
+    const auto size = (numBytes + pageSize - 1) / pageSize * pageSize;
+
+#if JUCE_WINDOWS
+    auto* data = VirtualAlloc (nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+
+    if (data == nullptr)
+        return false;
+#else
+    auto* data = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (data == MAP_FAILED)
+        return false;
+#endif
+
+    _data = data;
+    _size = size;
+
+    return true;
+}
+
+void ReservedMemory::release()
+{
+    if (_data == nullptr)
+        return;
+
+#if JUCE_WINDOWS
+    VirtualFree (_data, 0, MEM_RELEASE);
+#else
+    munmap (_data, _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+bool ReservedMemory::commit (size_t offset, size_t numBytes)
+{
+    jassert (offset + numBytes <= _size);
+
+#if JUCE_WINDOWS
+    if (numBytes == 0)
+        return true;
+
+    return VirtualAlloc (static_cast<char*> (_data) + offset, numBytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    (void) offset;
+    (void) numBytes;
+
+    return true;
+#endif
+}
+
+size_t ReservedMemory::getResidentBytes (size_t offset, size_t numBytes) const
+{
+    jassert (offset + numBytes <= _size);
+
+    if (numBytes == 0)
+        return 0;
+
+    const auto pageSize = getPageSize();
+    const auto first = offset / pageSize * pageSize;
+    const auto end = (offset + numBytes + pageSize - 1) / pageSize * pageSize;
+    size_t resident = 0;
+
+#if JUCE_WINDOWS
+    // committed pages, the closest Windows gets without the process status API
+    for (auto position = first; position < end;)
+    {
+        MEMORY_BASIC_INFORMATION info;
+
+        if (VirtualQuery (static_cast<char*> (_data) + position, &info, sizeof (info)) == 0)
+            break;
+
+        const auto regionEnd = juce::jmin (end, static_cast<size_t> (static_cast<char*> (info.BaseAddress) - static_cast<char*> (_data)) + info.RegionSize);
+
+        if (info.State == MEM_COMMIT)
+            resident += regionEnd - position;
+
+        position = regionEnd;
+    }
+#else
+    #if JUCE_MAC || JUCE_IOS
+    std::vector<char> pages ((end - first) / pageSize);
+    #else
+    std::vector<unsigned char> pages ((end - first) / pageSize);
+    #endif
+
+    if (mincore (static_cast<char*> (_data) + first, end - first, pages.data()) != 0)
+        return 0;
+
+    for (auto page : pages)
+        if ((page & 1) != 0)
+            resident += pageSize;
+#endif
+
+    return resident;
+}
+
+size_t ReservedMemory::getPageSize()
+{
+#if JUCE_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo (&info);
+
+    return static_cast<size_t> (info.dwPageSize);
+#else
+    static const auto pageSize = static_cast<size_t> (sysconf (_SC_PAGESIZE));
+
+    return pageSize;
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Address space reserved up front whose pages only take physical memory once they are used. On
+// POSIX systems anonymous pages are mapped on their first write; on Windows they have to be
+// committed first. Either way memory that was never committed reads as zero, so a large buffer
+// can be reserved without allocating or clearing it.
+class ReservedMemory
+{
+public:
+    ReservedMemory() = default;
+    ~ReservedMemory();
+
+    ReservedMemory (ReservedMemory&& other) noexcept;
+    ReservedMemory& operator= (ReservedMemory&& other) noexcept;
+
+    // releases what was reserved before, the size is rounded up to whole pages
+    bool reserve (size_t numBytes);
+    void release();
+
+    // Makes the range usable. Pages are mapped when first written on POSIX, so there it does nothing;
+    // on Windows it is a system call, best kept off the audio thread.
+    bool commit (size_t offset, size_t numBytes);
+
+    // the number of bytes in the range that are held in physical memory
+    size_t getResidentBytes (size_t offset, size_t numBytes) const;
+
+    void* getData() const { return _data; }
+    size_t getSize() const { return _size; }
+
+    static size_t getPageSize();
+
+private:
+    void* _data = nullptr;
+    size_t _size = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ReservedMemory)
+};
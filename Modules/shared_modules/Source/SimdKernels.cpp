@@ -0,0 +1,474 @@
+#include "SimdKernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define SHARED_MODULES_SIMD_DISPATCH 1
+#else
+    #define SHARED_MODULES_SIMD_DISPATCH 0
+#endif
+
+#if defined(__clang__)
+    // clang contracts within an expression, the pragma in each body keeps that off
+    #define SHARED_MODULES_SIMD_GENERIC
+    #define SHARED_MODULES_SIMD_TARGET(isa) __attribute__ ((target (isa)))
+    #define SHARED_MODULES_NO_FP_CONTRACT _Pragma ("clang fp contract(off)")
+#elif defined(__GNUC__)
+    // gcc contracts across statements after inlining, so it has to be switched off per function
+    #define SHARED_MODULES_SIMD_GENERIC __attribute__ ((optimize ("fp-contract=off")))
+    #define SHARED_MODULES_SIMD_TARGET(isa) __attribute__ ((target (isa), optimize ("fp-contract=off")))
+    #define SHARED_MODULES_NO_FP_CONTRACT
+#else
+    #define SHARED_MODULES_SIMD_GENERIC
+    #define SHARED_MODULES_NO_FP_CONTRACT
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define SHARED_MODULES_ALWAYS_INLINE inline __attribute__ ((always_inline))
+#else
+    #define SHARED_MODULES_ALWAYS_INLINE inline
+#endif
+
+namespace SimdKernels
+{
+    namespace
+    {
+        // shared bodies, inlined into each variant and vectorised for its target there
+        namespace Bodies
+        {
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void fill (SampleType* destination, SampleType value, size_t numSamples)
+            {
+                for (size_t i = 0; i < numSamples; i++)
+                    destination[i] = value;
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void onePoleLowpass (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* a1, SampleType& zPole, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                for (size_t i = 0; i < numSamples; i++)
+                    output[i] = input[i] * b0[i];
+
+                auto z = zPole;
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    z = output[i] + z * a1[i];
+                    output[i] = z;
+                }
+
+                zPole = z;
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void onePoleLowpassScan (const SampleType* input, SampleType* output, SampleType b0, SampleType a1, SampleType& zPole, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                constexpr size_t width = 8;
+
+                // response[k][i] is output i of a step for a unit input at k, powers[i] = a1^(i + 1)
+                alignas (64) SampleType response[width][width];
+                alignas (64) SampleType powers[width];
+
+                powers[0] = a1;
+
+                for (size_t i = 1; i < width; i++)
+                    powers[i] = powers[i - 1] * a1;
+
+                for (size_t k = 0; k < width; k++)
+                    for (size_t i = 0; i < width; i++)
+                        response[k][i] = i < k ? static_cast<SampleType> (0) : (i == k ? b0 : b0 * powers[i - k - 1]);
+
+                auto z = zPole;
+                size_t start = 0;
+
+                for (; start + width <= numSamples; start += width)
+                {
+                    // Copied first, so input may be output, and so the compiler broadcasts each sample
+                    // over the columns instead of transposing. z is recomputed rather than read back
+                    // from output, which would put a store to load forwarding into the serial chain.
+                    alignas (64) SampleType x[width];
+                    alignas (64) SampleType step[width];
+
+                    for (size_t i = 0; i < width; i++)
+                        x[i] = input[start + i];
+
+                    for (size_t i = 0; i < width; i++)
+                        step[i] = response[0][i] * x[0];
+
+                    for (size_t k = 1; k < width; k++)
+                        for (size_t i = 0; i < width; i++)
+                            step[i] += response[k][i] * x[k];
+
+                    for (size_t i = 0; i < width; i++)
+                        output[start + i] = step[i] + powers[i] * z;
+
+                    z = step[width - 1] + powers[width - 1] * z;
+                }
+
+                for (; start < numSamples; start++)
+                {
+                    z = input[start] * b0 + z * a1;
+                    output[start] = z;
+                }
+
+                zPole = z;
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void onePoleHighpass (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* b1, const SampleType* a1, SampleType& zPole, SampleType& zZero, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                if (numSamples == 0)
+                    return;
+
+                output[0] = input[0] * b0[0] + zZero * b1[0];
+
+                for (size_t i = 1; i < numSamples; i++)
+                    output[i] = input[i] * b0[i] + input[i - 1] * b1[i];
+
+                auto z = zPole;
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    z = output[i] + z * a1[i];
+                    output[i] = z;
+                }
+
+                zPole = z;
+                zZero = input[numSamples - 1];
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void readInterpolated (const SampleType* __restrict buffer, size_t totalSize, size_t readPosition, const SampleType* __restrict delays, SampleType maximumDelay, SampleType* __restrict output, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                // juce::jlimit, in a pass of its own: next to the conversion below the compiler turns
+                // it into a branch and gives up on the loop
+                for (size_t i = 0; i < numSamples; i++)
+                    output[i] = delays[i] < static_cast<SampleType> (0) ? static_cast<SampleType> (0) : (maximumDelay < delays[i] ? maximumDelay : delays[i]);
+
+                // 32 bit indices, so the index arithmetic and the gathers use full width vectors
+                const auto size = static_cast<juce::int32> (totalSize);
+                const auto start = static_cast<juce::int32> (readPosition);
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    // the delay is not negative, so truncating is the same as std::floor
+                    const auto delay = output[i];
+                    const auto delayInt = static_cast<juce::int32> (delay);
+                    const auto delayFrac = delay - static_cast<SampleType> (delayInt);
+
+                    auto index1 = start - static_cast<juce::int32> (i);
+                    index1 += index1 < 0 ? size : 0;
+                    index1 += delayInt;
+                    index1 -= index1 >= size ? size : 0;
+
+                    auto index2 = index1 + 1;
+                    index2 -= index2 >= size ? size : 0;
+
+                    const auto value1 = buffer[index1];
+                    const auto value2 = buffer[index2];
+
+                    output[i] = value1 + delayFrac * (value2 - value1);
+                }
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void allpassLattice (const SampleType* input, const SampleType* taps, const SampleType* gains, SampleType* feedback, SampleType* output, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    const auto in = input[i] - taps[i] * gains[2 * i];
+
+                    feedback[i] = in;
+                    output[i] = taps[i] + in * gains[2 * i + 1];
+                }
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void rampLanes (SampleType* __restrict current, const SampleType* __restrict target, const SampleType* __restrict step, juce::int32* __restrict countdown, SampleType* __restrict values, size_t numLanes, size_t numSteps)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                for (size_t i = 0; i < numSteps; i++)
+                {
+                    for (size_t l = 0; l < numLanes; l++)
+                    {
+                        // a settled smoother has current == target, and returns the target
+                        const auto remaining = countdown[l] - (countdown[l] > 0 ? 1 : 0);
+                        const auto value = remaining > 0 ? current[l] + step[l] : target[l];
+
+                        countdown[l] = remaining;
+                        current[l] = value;
+                        values[i * numLanes + l] = value;
+                    }
+                }
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void onePoleLowpassLanes (SampleType* __restrict samples, const SampleType* __restrict b0, const SampleType* __restrict a1, SampleType* __restrict zPole, size_t numLanes, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    auto* x = samples + i * numLanes;
+
+                    for (size_t l = 0; l < numLanes; l++)
+                    {
+                        zPole[l] = x[l] * b0[i * numLanes + l] + zPole[l] * a1[i * numLanes + l];
+                        x[l] = zPole[l];
+                    }
+                }
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE void onePoleHighpassLanes (SampleType* __restrict samples, const SampleType* __restrict b0, const SampleType* __restrict b1, const SampleType* __restrict a1, SampleType* __restrict zPole, SampleType* __restrict zZero, size_t numLanes, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    auto* x = samples + i * numLanes;
+
+                    for (size_t l = 0; l < numLanes; l++)
+                    {
+                        const auto input = x[l];
+
+                        zPole[l] = input * b0[i * numLanes + l] + zZero[l] * b1[i * numLanes + l] + zPole[l] * a1[i * numLanes + l];
+                        zZero[l] = input;
+                        x[l] = zPole[l];
+                    }
+                }
+            }
+
+            template <typename SampleType>
+            SHARED_MODULES_ALWAYS_INLINE size_t allpassLanes (SampleType* __restrict samples, SampleType* __restrict buffer, size_t totalSize, size_t position, const SampleType* __restrict delays, const SampleType* __restrict gains, SampleType maximumDelay, SampleType* __restrict taps, size_t numLanes, size_t numSamples)
+            {
+                SHARED_MODULES_NO_FP_CONTRACT
+
+                const auto size = static_cast<juce::int32> (totalSize);
+                const auto lanes = static_cast<juce::int32> (numLanes);
+                auto pos = static_cast<juce::int32> (position);
+
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    auto* x = samples + i * numLanes;
+                    const auto* delay = delays + i * numLanes;
+                    const auto* gain = gains + 2 * i * numLanes;
+
+                    // as in readInterpolated, the clamp gets a pass of its own
+                    for (juce::int32 l = 0; l < lanes; l++)
+                        taps[l] = delay[l] < static_cast<SampleType> (0) ? static_cast<SampleType> (0) : (maximumDelay < delay[l] ? maximumDelay : delay[l]);
+
+                    // each lane only reads its own column, so the gathers can go ahead of the writes
+                    for (juce::int32 l = 0; l < lanes; l++)
+                    {
+                        const auto delayInt = static_cast<juce::int32> (taps[l]);
+                        const auto delayFrac = taps[l] - static_cast<SampleType> (delayInt);
+
+                        auto index1 = pos + delayInt;
+                        index1 -= index1 >= size ? size : 0;
+
+                        auto index2 = index1 + 1;
+                        index2 -= index2 >= size ? size : 0;
+
+                        const auto value1 = buffer[index1 * lanes + l];
+                        const auto value2 = buffer[index2 * lanes + l];
+
+                        taps[l] = value1 + delayFrac * (value2 - value1);
+                    }
+
+                    auto* feedback = buffer + pos * lanes;
+
+                    for (size_t l = 0; l < numLanes; l++)
+                    {
+                        const auto in = x[l] - taps[l] * gain[l];
+
+                        feedback[l] = in;
+                        x[l] = taps[l] + in * gain[numLanes + l];
+                    }
+
+                    pos = (pos == 0 ? size : pos) - 1;
+                }
+
+                return static_cast<size_t> (pos);
+            }
+        } // namespace Bodies
+
+#define SHARED_MODULES_DEFINE_KERNEL_VARIANT(Name, ...)                                                                                                                                                  \
+    struct Name                                                                                                                                                                                          \
+    {                                                                                                                                                                                                    \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void fill (SampleType* destination, SampleType value, size_t numSamples)                                                                                                      \
+        {                                                                                                                                                                                                \
+            Bodies::fill (destination, value, numSamples);                                                                                                                                               \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void onePoleLowpass (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* a1, SampleType& zPole, size_t numSamples)                           \
+        {                                                                                                                                                                                                \
+            Bodies::onePoleLowpass (input, output, b0, a1, zPole, numSamples);                                                                                                                           \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void onePoleLowpassScan (const SampleType* input, SampleType* output, SampleType b0, SampleType a1, SampleType& zPole, size_t numSamples)                                      \
+        {                                                                                                                                                                                                \
+            Bodies::onePoleLowpassScan (input, output, b0, a1, zPole, numSamples);                                                                                                                       \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void onePoleHighpass (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* b1, const SampleType* a1, SampleType& zPole, SampleType& zZero, size_t numSamples) \
+        {                                                                                                                                                                                                \
+            Bodies::onePoleHighpass (input, output, b0, b1, a1, zPole, zZero, numSamples);                                                                                                               \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void readInterpolated (const SampleType* __restrict buffer, size_t totalSize, size_t readPosition, const SampleType* __restrict delays, SampleType maximumDelay, SampleType* __restrict output, size_t numSamples) \
+        {                                                                                                                                                                                                \
+            Bodies::readInterpolated (buffer, totalSize, readPosition, delays, maximumDelay, output, numSamples);                                                                                        \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void allpassLattice (const SampleType* input, const SampleType* taps, const SampleType* gains, SampleType* feedback, SampleType* output, size_t numSamples)                    \
+        {                                                                                                                                                                                                \
+            Bodies::allpassLattice (input, taps, gains, feedback, output, numSamples);                                                                                                                   \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void rampLanes (SampleType* current, const SampleType* target, const SampleType* step, juce::int32* countdown, SampleType* values, size_t numLanes, size_t numSteps)         \
+        {                                                                                                                                                                                                \
+            Bodies::rampLanes (current, target, step, countdown, values, numLanes, numSteps);                                                                                                            \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void onePoleLowpassLanes (SampleType* samples, const SampleType* b0, const SampleType* a1, SampleType* zPole, size_t numLanes, size_t numSamples)                             \
+        {                                                                                                                                                                                                \
+            Bodies::onePoleLowpassLanes (samples, b0, a1, zPole, numLanes, numSamples);                                                                                                                  \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static void onePoleHighpassLanes (SampleType* samples, const SampleType* b0, const SampleType* b1, const SampleType* a1, SampleType* zPole, SampleType* zZero, size_t numLanes, size_t numSamples) \
+        {                                                                                                                                                                                                \
+            Bodies::onePoleHighpassLanes (samples, b0, b1, a1, zPole, zZero, numLanes, numSamples);                                                                                                      \
+        }                                                                                                                                                                                                \
+        template <typename SampleType>                                                                                                                                                                   \
+        __VA_ARGS__ static size_t allpassLanes (SampleType* samples, SampleType* buffer, size_t totalSize, size_t position, const SampleType* delays, const SampleType* gains, SampleType maximumDelay, SampleType* taps, size_t numLanes, size_t numSamples) \
+        {                                                                                                                                                                                                \
+            return Bodies::allpassLanes (samples, buffer, totalSize, position, delays, gains, maximumDelay, taps, numLanes, numSamples);                                                                 \
+        }                                                                                                                                                                                                \
+    };
+
+        SHARED_MODULES_DEFINE_KERNEL_VARIANT (Generic, SHARED_MODULES_SIMD_GENERIC)
+#if SHARED_MODULES_SIMD_DISPATCH
+        SHARED_MODULES_DEFINE_KERNEL_VARIANT (Avx2, SHARED_MODULES_SIMD_TARGET ("avx2"))
+        SHARED_MODULES_DEFINE_KERNEL_VARIANT (Avx512, SHARED_MODULES_SIMD_TARGET ("avx512f,avx512vl,avx512dq"))
+#endif
+
+#undef SHARED_MODULES_DEFINE_KERNEL_VARIANT
+
+        template <typename Variant, typename SampleType>
+        Kernels<SampleType> makeKernels()
+        {
+            return { &Variant::template fill<SampleType>,
+                     &Variant::template onePoleLowpass<SampleType>,
+                     &Variant::template onePoleLowpassScan<SampleType>,
+                     &Variant::template onePoleHighpass<SampleType>,
+                     &Variant::template readInterpolated<SampleType>,
+                     &Variant::template allpassLattice<SampleType>,
+                     &Variant::template rampLanes<SampleType>,
+                     &Variant::template onePoleLowpassLanes<SampleType>,
+                     &Variant::template onePoleHighpassLanes<SampleType>,
+                     &Variant::template allpassLanes<SampleType> };
+        }
+
+        Variant detectBestVariant()
+        {
+#if SHARED_MODULES_SIMD_DISPATCH
+            __builtin_cpu_init();
+
+            // libgcc and compiler-rt also check that the OS saves the wider registers
+            if (__builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512vl") && __builtin_cpu_supports ("avx512dq"))
+                return Variant::avx512;
+
+            if (__builtin_cpu_supports ("avx2"))
+                return Variant::avx2;
+#endif
+            return Variant::generic;
+        }
+
+        constexpr int notForced = -1;
+        std::atomic<int> forcedVariant{ notForced };
+    } // namespace
+
+    bool isSupported (Variant variant)
+    {
+        return static_cast<int> (variant) <= static_cast<int> (getBestSupportedVariant());
+    }
+
+    Variant getBestSupportedVariant()
+    {
+        static const auto best = detectBestVariant();
+        return best;
+    }
+
+    void forceVariant (Variant variant)
+    {
+        jassert (isSupported (variant));
+
+        if (isSupported (variant))
+            forcedVariant = static_cast<int> (variant);
+    }
+
+    void clearForcedVariant()
+    {
+        forcedVariant = notForced;
+    }
+
+    Variant getActiveVariant()
+    {
+        const auto forced = forcedVariant.load();
+        return forced == notForced ? getBestSupportedVariant() : static_cast<Variant> (forced);
+    }
+
+    const char* getName (Variant variant)
+    {
+        switch (variant)
+        {
+            case Variant::generic:
+                return "generic";
+            case Variant::avx2:
+                return "avx2";
+            case Variant::avx512:
+                return "avx512";
+        }
+
+        return "unknown";
+    }
+
+    template <typename SampleType>
+    const Kernels<SampleType>& getKernels (Variant variant)
+    {
+        static const Kernels<SampleType> generic = makeKernels<Generic, SampleType>();
+
+#if SHARED_MODULES_SIMD_DISPATCH
+        static const Kernels<SampleType> avx2 = makeKernels<Avx2, SampleType>();
+        static const Kernels<SampleType> avx512 = makeKernels<Avx512, SampleType>();
+
+        switch (variant)
+        {
+            case Variant::avx512:
+                return avx512;
+            case Variant::avx2:
+                return avx2;
+            case Variant::generic:
+                break;
+        }
+#else
+        juce::ignoreUnused (variant);
+#endif
+
+        return generic;
+    }
+
+    template const Kernels<float>& getKernels (Variant);
+    template const Kernels<double>& getKernels (Variant);
+} // namespace SimdKernels
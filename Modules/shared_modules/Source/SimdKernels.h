@@ -0,0 +1,73 @@
+#pragma once
+
+// The inner loops of the one pole filters and the delay processors, compiled once per instruction
+// set with function target attributes so that a single build vectorises for whatever CPU it lands on.
+// Processors pick a variant with getKernels() in prepare(), from CPUID unless one has been forced.
+//
+// Every variant performs the same operations in the same order, and FMA contraction is disabled, so
+// all of them produce bit-identical output. Recursions stay serial; only the loops around them
+// (coefficient products, interpolated reads, the allpass lattice) are vectorised. JUCE smoothers
+// accumulate their ramps one step at a time, so while a parameter ramps the processors keep to their
+// per sample loop and the kernels get the settled values, filled with fill(). The lane kernels used by
+// the batched processors are the exception: there the recursion itself runs across instances. So is
+// onePoleLowpassScan, which runs it across eight consecutive samples.
+namespace SimdKernels
+{
+    enum class Variant
+    {
+        generic, // compiler baseline, SSE2 on x86-64
+        avx2,
+        avx512,
+    };
+
+    template <typename SampleType>
+    struct Kernels
+    {
+        void (*fill) (SampleType* destination, SampleType value, size_t numSamples);
+
+        // output[i] = input[i] * b0[i] + zPole * a1[i], input and output may be the same buffer
+        void (*onePoleLowpass) (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* a1, SampleType& zPole, size_t numSamples);
+        // onePoleLowpass with constant coefficients, eight samples per step: each output of a step is
+        // the step's input through the precomputed impulse response plus a power of a1 times zPole,
+        // so only one product and sum per step are serial. Rounds differently from onePoleLowpass.
+        void (*onePoleLowpassScan) (const SampleType* input, SampleType* output, SampleType b0, SampleType a1, SampleType& zPole, size_t numSamples);
+        // output[i] = input[i] * b0[i] + zZero * b1[i] + zPole * a1[i], input and output must differ
+        void (*onePoleHighpass) (const SampleType* input, SampleType* output, const SampleType* b0, const SampleType* b1, const SampleType* a1, SampleType& zPole, SampleType& zZero, size_t numSamples);
+
+        // Linearly interpolated reads with the exact arithmetic of DelayBuffer::popSample(). The read
+        // position moves back by one per sample from readPosition, numSamples must be below totalSize.
+        // The output must not overlap the buffer or the delays.
+        void (*readInterpolated) (const SampleType* buffer, size_t totalSize, size_t readPosition, const SampleType* delays, SampleType maximumDelay, SampleType* output, size_t numSamples);
+
+        // feedback[i] = input[i] - taps[i] * gains[2i], output[i] = taps[i] + feedback[i] * gains[2i + 1],
+        // input and output may be the same buffer
+        void (*allpassLattice) (const SampleType* input, const SampleType* taps, const SampleType* gains, SampleType* feedback, SampleType* output, size_t numSamples);
+
+        // Lane interleaved kernels for the batched processors: every array but the per lane state is
+        // laid out [sample * numLanes + lane], and each step advances all lanes together.
+
+        // numSteps values of juce::LinearSmoothedValue::getNextValue() per lane
+        void (*rampLanes) (SampleType* current, const SampleType* target, const SampleType* step, juce::int32* countdown, SampleType* values, size_t numLanes, size_t numSteps);
+        // onePoleLowpass and onePoleHighpass in place, with one zPole (and zZero) per lane
+        void (*onePoleLowpassLanes) (SampleType* samples, const SampleType* b0, const SampleType* a1, SampleType* zPole, size_t numLanes, size_t numSamples);
+        void (*onePoleHighpassLanes) (SampleType* samples, const SampleType* b0, const SampleType* b1, const SampleType* a1, SampleType* zPole, SampleType* zZero, size_t numLanes, size_t numSamples);
+        // VariableDelayAllpass::processSample in place, over a delay buffer laid out [position * numLanes
+        // + lane] whose read and write positions coincide. gains holds two values per sample and taps
+        // is numLanes long scratch. Returns the position after numSamples.
+        size_t (*allpassLanes) (SampleType* samples, SampleType* buffer, size_t totalSize, size_t position, const SampleType* delays, const SampleType* gains, SampleType maximumDelay, SampleType* taps, size_t numLanes, size_t numSamples);
+    };
+
+    bool isSupported (Variant variant);
+    Variant getBestSupportedVariant();
+
+    // Overrides the CPUID choice for every processor prepared afterwards, for tests and benchmarks.
+    // The variant must be supported on this machine.
+    void forceVariant (Variant variant);
+    void clearForcedVariant();
+    Variant getActiveVariant();
+
+    const char* getName (Variant variant);
+
+    template <typename SampleType>
+    const Kernels<SampleType>& getKernels (Variant variant = getActiveVariant());
+} // namespace SimdKernels
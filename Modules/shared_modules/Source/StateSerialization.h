@@ -0,0 +1,253 @@
+#pragma once
+
+// Compact binary snapshots of processor runtime state (delay memory, read and write positions,
+// smoother and filter state, oscillator phase), so that a render can stop on one machine and resume
+// bit-identically on another. Buffers are stored as raw native-endian bytes behind an element count
+// and size, and are restored with one memcpy each, so a StateReader can run straight over the
+// contents of a juce::MemoryMappedFile without parsing anything per sample.
+//
+// Smoothers are stored field by field: current and target value, the samples left in the ramp and
+// the step, which JUCE does not recompute once a ramp has started. Ranges are stored as start and
+// end. Configuration is not stored: restore into a processor built with the same constructor
+// arguments and waveform, and prepared with the same spec. Restoring never allocates. If the layout
+// does not match it returns false, and the processor should be reset().
+
+// juce::LinearSmoothedValue keeps its state protected and its step private, so the fields are
+// reached through a derived class and the step through the public ramp interface
+template <typename FloatType>
+struct SmootherFields : juce::LinearSmoothedValue<FloatType>
+{
+    using Smoother = juce::LinearSmoothedValue<FloatType>;
+
+    static int getCountdown (const Smoother& smoother)
+    {
+        return smoother.*(&SmootherFields::countdown);
+    }
+
+    static FloatType getStep (const Smoother& smoother)
+    {
+        // one step from -0 adds exactly the step, signed zero included
+        auto probe = smoother;
+        probe.*(&SmootherFields::currentValue) = static_cast<FloatType> (-0.0);
+        probe.*(&SmootherFields::countdown) = 2;
+
+        return probe.getNextValue();
+    }
+
+    // the smoother keeps the ramp length it was prepared with
+    static void restore (Smoother& smoother, FloatType current, FloatType target, int countdown, FloatType step)
+    {
+        auto probe = smoother;
+        probe.setCurrentAndTargetValue (0);
+        probe.setTargetValue (1);
+        const auto numRampSteps = probe.*(&SmootherFields::countdown);
+
+        // a one step ramp from 0 sets the step exactly, and reset() leaves it alone
+        smoother.reset (1);
+        smoother.setCurrentAndTargetValue (0);
+
+        if (step == 0)
+            smoother.*(&SmootherFields::target) = 1;
+
+        smoother.setTargetValue (step);
+        smoother.reset (numRampSteps);
+
+        smoother.*(&SmootherFields::currentValue) = current;
+        smoother.*(&SmootherFields::target) = target;
+        smoother.*(&SmootherFields::countdown) = countdown;
+    }
+};
+
+class StateWriter
+{
+public:
+    explicit StateWriter (juce::MemoryBlock& destination)
+        : _destination (destination)
+    {
+    }
+
+    void writeTag (const char (&tag)[5])
+    {
+        _destination.append (tag, 4);
+        write (formatVersion);
+    }
+
+    template <typename Type>
+    void write (const Type& value)
+    {
+        static_assert (std::is_trivially_copyable_v<Type>, "only trivially copyable types can be stored as raw bytes");
+        _destination.append (&value, sizeof (Type));
+    }
+
+    template <typename FloatType>
+    void write (const juce::LinearSmoothedValue<FloatType>& smoother)
+    {
+        write (smoother.getCurrentValue());
+        write (smoother.getTargetValue());
+        write (static_cast<juce::int32> (SmootherFields<FloatType>::getCountdown (smoother)));
+        write (SmootherFields<FloatType>::getStep (smoother));
+    }
+
+    template <typename Type>
+    void write (const juce::Range<Type>& range)
+    {
+        write (range.getStart());
+        write (range.getEnd());
+    }
+
+    template <typename Type>
+    void writeArray (const Type* data, size_t count)
+    {
+        static_assert (std::is_trivially_copyable_v<Type>, "only trivially copyable types can be stored as raw bytes");
+
+        write (static_cast<juce::uint64> (count));
+        write (static_cast<juce::uint32> (sizeof (Type)));
+        _destination.append (data, count * sizeof (Type));
+    }
+
+    // the element size is that of the smoothed value
+    template <typename FloatType>
+    void writeArray (const juce::LinearSmoothedValue<FloatType>* smoothers, size_t count)
+    {
+        write (static_cast<juce::uint64> (count));
+        write (static_cast<juce::uint32> (sizeof (FloatType)));
+
+        for (size_t i = 0; i < count; i++)
+            write (smoothers[i]);
+    }
+
+    template <typename Type>
+    void writeArray (const std::vector<Type>& values)
+    {
+        writeArray (values.data(), values.size());
+    }
+
+    static constexpr juce::uint32 formatVersion = 1;
+
+private:
+    juce::MemoryBlock& _destination;
+};
+
+class StateReader
+{
+public:
+    StateReader (const void* data, size_t size)
+        : _data (static_cast<const char*> (data)),
+          _size (size)
+    {
+    }
+
+    explicit StateReader (const juce::MemoryBlock& source)
+        : StateReader (source.getData(), source.getSize())
+    {
+    }
+
+    bool readTag (const char (&tag)[5])
+    {
+        juce::uint32 version = 0;
+
+        if (_position + 4 > _size || std::memcmp (_data + _position, tag, 4) != 0)
+            return false;
+
+        _position += 4;
+
+        return read (version) && version == StateWriter::formatVersion;
+    }
+
+    template <typename Type>
+    bool read (Type& value)
+    {
+        static_assert (std::is_trivially_copyable_v<Type>, "only trivially copyable types can be stored as raw bytes");
+
+        return readBytes (&value, sizeof (Type));
+    }
+
+    template <typename FloatType>
+    bool read (juce::LinearSmoothedValue<FloatType>& smoother)
+    {
+        FloatType current{}, target{}, step{};
+        juce::int32 countdown = 0;
+
+        if (! read (current) || ! read (target) || ! read (countdown) || ! read (step) || countdown < 0)
+            return false;
+
+        SmootherFields<FloatType>::restore (smoother, current, target, countdown, step);
+
+        return true;
+    }
+
+    template <typename Type>
+    bool read (juce::Range<Type>& range)
+    {
+        Type start{}, end{};
+
+        if (! read (start) || ! read (end) || end < start)
+            return false;
+
+        range = { start, end };
+
+        return true;
+    }
+
+    // the stored array must have exactly count elements of the same size
+    template <typename Type>
+    bool readArray (Type* data, size_t count)
+    {
+        static_assert (std::is_trivially_copyable_v<Type>, "only trivially copyable types can be stored as raw bytes");
+
+        return readMatchingArrayHeader (count, sizeof (Type)) && readBytes (data, count * sizeof (Type));
+    }
+
+    template <typename FloatType>
+    bool readArray (juce::LinearSmoothedValue<FloatType>* smoothers, size_t count)
+    {
+        if (! readMatchingArrayHeader (count, sizeof (FloatType)))
+            return false;
+
+        for (size_t i = 0; i < count; i++)
+            if (! read (smoothers[i]))
+                return false;
+
+        return true;
+    }
+
+    template <typename Type>
+    bool readArray (std::vector<Type>& values)
+    {
+        return readArray (values.data(), values.size());
+    }
+
+    size_t getPosition() const
+    {
+        return _position;
+    }
+
+    bool isExhausted() const
+    {
+        return _position == _size;
+    }
+
+private:
+    bool readMatchingArrayHeader (size_t count, size_t elementSize)
+    {
+        juce::uint64 storedCount = 0;
+        juce::uint32 storedElementSize = 0;
+
+        return read (storedCount) && read (storedElementSize) && storedCount == count && storedElementSize == elementSize;
+    }
+
+    bool readBytes (void* destination, size_t numBytes)
+    {
+        if (numBytes > _size - _position)
+            return false;
+
+        std::memcpy (destination, _data + _position, numBytes);
+        _position += numBytes;
+
+        return true;
+    }
+
+    const char* _data;
+    size_t _size;
+    size_t _position = 0;
+};
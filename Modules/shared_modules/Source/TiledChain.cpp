@@ -0,0 +1,147 @@
+#include "TiledChain.h"
+
+TiledChain::TiledChain (size_t tileSize)
+    : _tileSize (juce::jmax (static_cast<size_t> (1), tileSize))
+{
+    jassert (tileSize > 0);
+}
+
+void TiledChain::addProcessor (juce::dsp::ProcessorBase& processor)
+{
+    _links.push_back ({ &processor, dynamic_cast<MultiPrecisionProcessor*> (&processor) });
+}
+
+template <typename SampleType>
+void TiledChain::addProcessor (ProcessorModulator<SampleType>& modulator)
+{
+    addProcessor (static_cast<juce::dsp::ProcessorBase&> (modulator));
+
+    _tileLimits.push_back ([&modulator] (size_t maxLength)
+                           {
+                               if (! modulator.isModulationEnabled())
+                                   return maxLength;
+
+                               return alignToTicks (maxLength, modulator.getSamplesUntilNextUpdate(), modulator.getUpdateRate());
+                           });
+}
+
+void TiledChain::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    const juce::dsp::ProcessSpec tileSpec{ spec.sampleRate, static_cast<juce::uint32> (juce::jmin (_tileSize, static_cast<size_t> (spec.maximumBlockSize))), spec.numChannels };
+
+    for (auto& link : _links)
+        link.processor->prepare (tileSpec);
+}
+
+void TiledChain::reset()
+{
+    for (auto& link : _links)
+        link.processor->reset();
+}
+
+void TiledChain::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    processBlock (context);
+}
+
+void TiledChain::process (const juce::dsp::ProcessContextReplacing<double>& context)
+{
+    processBlock (context);
+}
+
+void TiledChain::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+{
+    processBlock (context);
+}
+
+void TiledChain::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+{
+    processBlock (context);
+}
+
+size_t TiledChain::getTileSize() const
+{
+    return _tileSize;
+}
+
+template <typename ProcessContext>
+void TiledChain::processBlock (const ProcessContext& context)
+{
+    const auto& block = context.getOutputBlock();
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t start = 0; start < numSamples;)
+    {
+        auto length = juce::jmin (_tileSize, numSamples - start);
+
+        // the next block starts where this one ends anyway, so the last tile is left whole
+        if (start + length < numSamples)
+            for (auto& limit : _tileLimits)
+                length = limit (length);
+
+        auto tile = block.getSubBlock (start, length);
+        auto link = _links.begin();
+
+        // out of place, the first processor reads the input and the others work on its output
+        if constexpr (ProcessContext::usesSeparateInputAndOutputBlocks())
+        {
+            const auto inputTile = context.getInputBlock().getSubBlock (start, length);
+
+            if (link == _links.end())
+                tile.copyFrom (inputTile);
+            else
+                processTile (*link++, inputTile, tile);
+        }
+
+        for (; link != _links.end(); link++)
+            processTile (*link, tile);
+
+        start += length;
+    }
+}
+
+void TiledChain::processTile (Link& link, juce::dsp::AudioBlock<float>& tile)
+{
+    link.processor->process (juce::dsp::ProcessContextReplacing<float> (tile));
+}
+
+void TiledChain::processTile (Link& link, juce::dsp::AudioBlock<double>& tile)
+{
+    jassert (link.multiPrecisionProcessor != nullptr);
+
+    if (link.multiPrecisionProcessor != nullptr)
+        link.multiPrecisionProcessor->process (juce::dsp::ProcessContextReplacing<double> (tile));
+}
+
+void TiledChain::processTile (Link& link, const juce::dsp::AudioBlock<const float>& inputTile, juce::dsp::AudioBlock<float>& tile)
+{
+    if (link.multiPrecisionProcessor != nullptr)
+    {
+        link.multiPrecisionProcessor->process (juce::dsp::ProcessContextNonReplacing<float> (inputTile, tile));
+        return;
+    }
+
+    tile.copyFrom (inputTile);
+    processTile (link, tile);
+}
+
+void TiledChain::processTile (Link& link, const juce::dsp::AudioBlock<const double>& inputTile, juce::dsp::AudioBlock<double>& tile)
+{
+    jassert (link.multiPrecisionProcessor != nullptr);
+
+    if (link.multiPrecisionProcessor != nullptr)
+        link.multiPrecisionProcessor->process (juce::dsp::ProcessContextNonReplacing<double> (inputTile, tile));
+    else
+        tile.copyFrom (inputTile);
+}
+
+size_t TiledChain::alignToTicks (size_t maxLength, size_t samplesUntilNextTick, size_t tickInterval)
+{
+    if (samplesUntilNextTick == 0 || samplesUntilNextTick > maxLength || tickInterval == 0)
+        return maxLength;
+
+    return samplesUntilNextTick + (maxLength - samplesUntilNextTick) / tickInterval * tickInterval;
+}
+
+template void TiledChain::addProcessor<float> (ProcessorModulator<float>&);
+template void TiledChain::addProcessor<double> (ProcessorModulator<double>&);
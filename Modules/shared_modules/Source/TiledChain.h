@@ -0,0 +1,54 @@
+#pragma once
+
+// Runs a chain of processors tile by tile: every processor processes the first tileSize samples
+// of the block before any of them moves on to the next tile, so a tile and the processors' scratch
+// buffers stay in cache across the whole chain instead of every processor streaming the full block
+// through it. Large offline blocks then cost what small realtime ones do.
+//
+// The processors are not owned and run in the order they were added. prepare() prepares them for
+// blocks of at most tileSize samples; processors reached only through a ProcessorModulator are the
+// caller's to prepare, as usual.
+class TiledChain : public MultiPrecisionProcessor
+{
+public:
+    explicit TiledChain (size_t tileSize = 128);
+
+    // double blocks are only forwarded to processors deriving from MultiPrecisionProcessor
+    void addProcessor (juce::dsp::ProcessorBase& processor);
+
+    // Tiles are also cut to end on the modulator's control ticks, so that the modulator splits them
+    // in whole update periods, or not at all when the update rate is above the tile size.
+    template <typename SampleType>
+    void addProcessor (ProcessorModulator<SampleType>& modulator);
+
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
+    virtual void reset() override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+    size_t getTileSize() const;
+
+private:
+    struct Link
+    {
+        juce::dsp::ProcessorBase* processor;
+        MultiPrecisionProcessor* multiPrecisionProcessor;
+    };
+
+    template <typename ProcessContext>
+    void processBlock (const ProcessContext& context);
+
+    void processTile (Link& link, juce::dsp::AudioBlock<float>& tile);
+    void processTile (Link& link, juce::dsp::AudioBlock<double>& tile);
+    void processTile (Link& link, const juce::dsp::AudioBlock<const float>& inputTile, juce::dsp::AudioBlock<float>& tile);
+    void processTile (Link& link, const juce::dsp::AudioBlock<const double>& inputTile, juce::dsp::AudioBlock<double>& tile);
+
+    // the longest length up to maxLength that ends on a tick, or maxLength if no tick falls in it
+    static size_t alignToTicks (size_t maxLength, size_t samplesUntilNextTick, size_t tickInterval);
+
+    size_t _tileSize;
+    std::vector<Link> _links;
+    std::vector<std::function<size_t (size_t maxLength)>> _tileLimits;
+};
@@ -1,24 +1,28 @@
 #include "VariableDelayAllpass.h"
 
-VariableDelayAllpass::VariableDelayAllpass (size_t maxDelayInSamples, size_t numTaps)
-    : _delayLine (maxDelayInSamples),
+template <typename SampleType>
+VariableDelayAllpass<SampleType>::VariableDelayAllpass (size_t maxDelayInSamples, size_t numTaps, DelayMemory memory)
+    : _delayLine (maxDelayInSamples, memory),
       _numTaps (numTaps)
 {
 }
 
-void VariableDelayAllpass::prepare (const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
     _delayLine.prepare (spec);
 
-    _delayInSamples.resize (spec.numChannels);
-    _gain.resize (spec.numChannels);
-
-    _tapOutBuffer.clear();
+    // see VariableDelayLine::prepare
+    if (_delayInSamples.size() < spec.numChannels)
+    {
+        _delayInSamples.resize (spec.numChannels);
+        _tapOutBuffer.resize (spec.numChannels);
+        _gain.resize (spec.numChannels);
+    }
 
     for (size_t ch = 0; ch < spec.numChannels; ch++)
     {
-        _tapOutBuffer.emplace_back (_numTaps, spec.maximumBlockSize);
-        _tapOutBuffer[ch].clear();
+        _tapOutBuffer[ch].setSize (static_cast<int> (_numTaps), static_cast<int> (spec.maximumBlockSize), false, false, true);
         _gain[ch].reset (spec.sampleRate, 0.05);
         _delayInSamples[ch].resize (_numTaps);
     }
@@ -27,10 +31,18 @@ void VariableDelayAllpass::prepare (const juce::dsp::ProcessSpec& spec)
         for (size_t i = 0; i < _numTaps; i++)
             _delayInSamples[ch][i].reset (spec.sampleRate, 0.05);
 
+    _kernels = &SimdKernels::getKernels<SampleType>();
+    _input.resize (spec.maximumBlockSize);
+    _feedback.resize (spec.maximumBlockSize);
+    _delayValues.resize (_numTaps * spec.maximumBlockSize);
+    _gainValues.resize (2 * spec.maximumBlockSize);
+    _outputMix.prepare (spec.sampleRate);
+
     reset();
 }
 
-void VariableDelayAllpass::reset()
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::reset()
 {
     _delayLine.reset();
 
@@ -38,38 +50,148 @@ void VariableDelayAllpass::reset()
         _tapOutBuffer[ch].clear();
 }
 
-void VariableDelayAllpass::process (const juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+template <typename IOType>
+void VariableDelayAllpass<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
 {
-    auto& outputBlock = context.getOutputBlock();
     const auto numChannels = outputBlock.getNumChannels();
     const auto numSamples = outputBlock.getNumSamples();
+    const auto maxBlockSize = _input.size();
+    const auto maximumDelay = static_cast<SampleType> (_delayLine.getCommittedDelayInSamples());
+
+    jassert (maxBlockSize > 0);
+    jassert (inputBlock.getNumChannels() == numChannels && inputBlock.getNumSamples() == numSamples);
+
+    _outputMix.beginBlock (numSamples);
 
     for (size_t ch = 0; ch < numChannels; ch++)
     {
-        auto* samples = outputBlock.getChannelPointer (ch);
-
-        for (size_t i = 0; i < numSamples; i++)
+        for (size_t start = 0; start < numSamples; start += maxBlockSize)
         {
-            for (size_t n = 1; n < _numTaps; n++)
-                _tapOutBuffer[ch].setSample (n, i, _delayLine.popSample (ch, _delayInSamples[ch][n].getNextValue(), false));
+            const auto blockSize = juce::jmin (maxBlockSize, numSamples - start);
+            const auto* input = inputBlock.getChannelPointer (ch) + start;
+            auto* output = outputBlock.getChannelPointer (ch) + start;
 
-            float mainTapOut = _delayLine.popSample (ch, _delayInSamples[ch][0].getNextValue());
+            if (isSmoothing (ch))
+            {
+                for (size_t i = 0; i < blockSize; i++)
+                    _input[i] = processSample (ch, i, static_cast<SampleType> (input[i]));
 
-            _tapOutBuffer[ch].setSample (0, i, mainTapOut);
+                _outputMix.write (input, _input.data(), output, start, blockSize);
+                reportToMeteringFeed (ch, blockSize);
+                continue;
+            }
 
-            float in = samples[i] - mainTapOut * _gain[ch].getNextValue();
-            float out = mainTapOut + in * _gain[ch].getNextValue();
-            _delayLine.pushSample (ch, in);
+            for (size_t i = 0; i < blockSize; i++)
+                _input[i] = static_cast<SampleType> (input[i]);
 
-            samples[i] = out;
+            auto shortestDelay = maximumDelay;
+
+            for (size_t n = 0; n < _numTaps; n++)
+            {
+                const auto delay = _delayInSamples[ch][n].getTargetValue();
+
+                _kernels->fill (_delayValues.data() + n * maxBlockSize, delay, blockSize);
+                shortestDelay = juce::jmin (shortestDelay, delay);
+            }
+
+            _kernels->fill (_gainValues.data(), _gain[ch].getTargetValue(), 2 * blockSize);
+
+            // A chunk is read before its feedback is written, which is only exact while every read
+            // reaches further back than the chunk is long. Below one sample this is per sample.
+            const auto chunkSize = juce::jmax (static_cast<size_t> (1), static_cast<size_t> (std::floor (juce::jmax (shortestDelay, static_cast<SampleType> (0)))));
+
+            for (size_t offset = 0; offset < blockSize; offset += chunkSize)
+            {
+                const auto length = juce::jmin (chunkSize, blockSize - offset);
+
+                for (size_t n = 0; n < _numTaps; n++)
+                    _delayLine.readBlock (ch, _delayValues.data() + n * maxBlockSize + offset, _tapOutBuffer[ch].getWritePointer (static_cast<int> (n), static_cast<int> (offset)), length);
+
+                _delayLine.advanceReadPointer (ch, length);
+
+                _kernels->allpassLattice (_input.data() + offset,
+                                          _tapOutBuffer[ch].getReadPointer (0, static_cast<int> (offset)),
+                                          _gainValues.data() + 2 * offset,
+                                          _feedback.data() + offset,
+                                          _input.data() + offset,
+                                          length);
+
+                _delayLine.pushBlock (ch, _feedback.data() + offset, length);
+            }
+
+            _outputMix.write (input, _input.data(), output, start, blockSize);
+
+            reportToMeteringFeed (ch, blockSize);
         }
     }
 }
 
-void VariableDelayAllpass::setDelayInSamples (float newDelayInSamples, size_t tapIndex, bool force)
+template <typename SampleType>
+SampleType VariableDelayAllpass<SampleType>::processSample (size_t channel, size_t index, SampleType input)
+{
+    for (size_t n = 1; n < _numTaps; n++)
+        _tapOutBuffer[channel].setSample (static_cast<int> (n), static_cast<int> (index), _delayLine.popSample (channel, _delayInSamples[channel][n].getNextValue(), false));
+
+    const auto mainTapOut = _delayLine.popSample (channel, _delayInSamples[channel][0].getNextValue());
+    _tapOutBuffer[channel].setSample (0, static_cast<int> (index), mainTapOut);
+
+    const auto in = input - mainTapOut * _gain[channel].getNextValue();
+    const auto out = mainTapOut + in * _gain[channel].getNextValue();
+    _delayLine.pushSample (channel, in);
+
+    return out;
+}
+
+template <typename SampleType>
+bool VariableDelayAllpass<SampleType>::isSmoothing (size_t channel) const
+{
+    if (_gain[channel].isSmoothing())
+        return true;
+
+    for (const auto& delay : _delayInSamples[channel])
+        if (delay.isSmoothing())
+            return true;
+
+    return false;
+}
+
+template <typename SampleType>
+bool VariableDelayAllpass<SampleType>::reserveDelayInSamples (size_t delayInSamples)
+{
+    return _delayLine.commitDelay (delayInSamples);
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex, bool force)
 {
     jassert (tapIndex < _numTaps);
     jassert (newDelayInSamples < _delayLine.getMaximumDelayInSamples());
+    jassert (newDelayInSamples <= _delayLine.getCommittedDelayInSamples());
 
     if (force)
         for (int ch = 0; ch < _delayInSamples.size(); ch++)
@@ -79,7 +201,8 @@ void VariableDelayAllpass::setDelayInSamples (float newDelayInSamples, size_t ta
             _delayInSamples[ch][tapIndex].setTargetValue (newDelayInSamples);
 }
 
-void VariableDelayAllpass::setGain (float newGain, bool force)
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::setGain (SampleType newGain, bool force)
 {
     if (force)
         for (int ch = 0; ch < _gain.size(); ch++)
@@ -89,10 +212,92 @@ void VariableDelayAllpass::setGain (float newGain, bool force)
             _gain[ch].setTargetValue (newGain);
 }
 
-const float* VariableDelayAllpass::getTapOutBuffer (size_t channelIndex, size_t tapIndex) const
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::setParameters (const Parameters& parameters, bool force)
+{
+    // Parameters only hold the first maxNumTaps delays
+    jassert (_numTaps <= maxNumTaps);
+
+    const auto numTaps = juce::jmin (_numTaps, maxNumTaps);
+
+    for (size_t ch = 0; ch < _delayInSamples.size(); ch++)
+    {
+        if (force)
+            _gain[ch].setCurrentAndTargetValue (parameters.gain);
+        else
+            _gain[ch].setTargetValue (parameters.gain);
+
+        for (size_t n = 0; n < numTaps; n++)
+        {
+            jassert (parameters.delayInSamples[n] < _delayLine.getMaximumDelayInSamples());
+            jassert (parameters.delayInSamples[n] <= _delayLine.getCommittedDelayInSamples());
+
+            if (force)
+                _delayInSamples[ch][n].setCurrentAndTargetValue (parameters.delayInSamples[n]);
+            else
+                _delayInSamples[ch][n].setTargetValue (parameters.delayInSamples[n]);
+        }
+    }
+}
+
+template <typename SampleType>
+const SampleType* VariableDelayAllpass<SampleType>::getTapOutBuffer (size_t channelIndex, size_t tapIndex) const
 {
     jassert (channelIndex < _tapOutBuffer.size());
     jassert (tapIndex < _numTaps);
 
     return _tapOutBuffer[channelIndex].getReadPointer (tapIndex);
 }
+
+template <typename SampleType>
+OutputMix<SampleType>& VariableDelayAllpass<SampleType>::getOutputMix()
+{
+    return _outputMix;
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::setMeteringFeed (MeteringFeed* feed, size_t firstTap)
+{
+    _meteringFeed = feed;
+    _meteringFirstTap = firstTap;
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::reportToMeteringFeed (size_t channel, size_t blockSize)
+{
+    if (_meteringFeed == nullptr)
+        return;
+
+    for (size_t n = 0; n < _numTaps; n++)
+    {
+        _meteringFeed->addTapBlock (channel, _meteringFirstTap + n, _tapOutBuffer[channel].getReadPointer (static_cast<int> (n)), blockSize);
+        _meteringFeed->setDelayInSamples (channel, _meteringFirstTap + n, static_cast<float> (_delayInSamples[channel][n].getCurrentValue()));
+    }
+}
+
+template <typename SampleType>
+void VariableDelayAllpass<SampleType>::saveState (StateWriter& writer) const
+{
+    writer.writeTag ("VDAP");
+    _delayLine.saveState (writer);
+    writer.writeArray (_gain.data(), _delayLine.getNumChannels());
+
+    for (size_t ch = 0; ch < _delayLine.getNumChannels(); ch++)
+        writer.writeArray (_delayInSamples[ch]);
+}
+
+template <typename SampleType>
+bool VariableDelayAllpass<SampleType>::restoreState (StateReader& reader)
+{
+    if (! reader.readTag ("VDAP") || ! _delayLine.restoreState (reader) || ! reader.readArray (_gain.data(), _delayLine.getNumChannels()))
+        return false;
+
+    for (size_t ch = 0; ch < _delayLine.getNumChannels(); ch++)
+        if (! reader.readArray (_delayInSamples[ch]))
+            return false;
+
+    return true;
+}
+
+template class VariableDelayAllpass<float>;
+template class VariableDelayAllpass<double>;
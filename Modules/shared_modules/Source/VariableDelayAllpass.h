@@ -1,23 +1,69 @@
 #pragma once
 
-class VariableDelayAllpass : public juce::dsp::ProcessorBase
+template <typename SampleType = float>
+class VariableDelayAllpass : public MultiPrecisionProcessor
 {
 public:
-    VariableDelayAllpass (size_t maxDelayInSamples, size_t numTaps = 1);
+    // see VariableDelayLine
+    static constexpr size_t maxNumTaps = 8;
+
+    struct Parameters
+    {
+        std::array<SampleType, maxNumTaps> delayInSamples{}; // one per tap, those past numTaps are ignored
+        SampleType gain = 0.0;
+    };
+
+    // see VariableDelayLine
+    VariableDelayAllpass (size_t maxDelayInSamples, size_t numTaps = 1, DelayMemory memory = DelayMemory::allocated);
 
     virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
     virtual void reset() override;
     virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+    // see VariableDelayLine::reserveDelayInSamples
+    bool reserveDelayInSamples (size_t delayInSamples);
+
+    void setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex = 0, bool force = false);
+    void setGain (SampleType newGain, bool force = false);
+    void setParameters (const Parameters& parameters, bool force = false);
 
-    void setDelayInSamples (float newDelayInSamples, size_t tapIndex = 0, bool force = false);
-    void setGain (float newGain, bool force = false);
+    // dry/wet and output gain, applied as the allpass output is written
+    OutputMix<SampleType>& getOutputMix();
 
-    const float* getTapOutBuffer (size_t channelIndex, size_t tapIndex) const;
+    // Only valid on the audio thread, which overwrites it every block. Other threads read a MeteringFeed.
+    // Blocks longer than the prepared maximum are processed in chunks of that size, and the buffer
+    // then holds the last chunk.
+    const SampleType* getTapOutBuffer (size_t channelIndex, size_t tapIndex) const;
+    // see VariableDelayLine::setMeteringFeed
+    void setMeteringFeed (MeteringFeed* feed, size_t firstTap = 0);
+
+    void saveState (StateWriter& writer) const;
+    bool restoreState (StateReader& reader);
 
 private:
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> _delayLine;
-    std::vector<std::vector<juce::LinearSmoothedValue<float>>> _delayInSamples;
+    template <typename IOType>
+    void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+    // the per sample path, used while any of the channel's parameters is ramping
+    SampleType processSample (size_t channel, size_t index, SampleType input);
+    bool isSmoothing (size_t channel) const;
+    void reportToMeteringFeed (size_t channel, size_t blockSize);
+
+    DelayBuffer<SampleType> _delayLine;
+    std::vector<std::vector<juce::LinearSmoothedValue<SampleType>>> _delayInSamples;
     size_t _numTaps;
-    std::vector<juce::AudioBuffer<float>> _tapOutBuffer;
-    std::vector<juce::LinearSmoothedValue<float>> _gain;
+    std::vector<juce::AudioBuffer<SampleType>> _tapOutBuffer;
+    MeteringFeed* _meteringFeed = nullptr;
+    size_t _meteringFirstTap = 0;
+    OutputMix<SampleType> _outputMix;
+
+    // per block values for the kernels, maximumBlockSize long
+    const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+    std::vector<SampleType> _input;
+    std::vector<SampleType> _delayValues; // [tap * maximumBlockSize + sample]
+    std::vector<SampleType> _feedback;
+    std::vector<SampleType> _gainValues; // two per sample, the gain is read twice
+    std::vector<juce::LinearSmoothedValue<SampleType>> _gain;
 };
@@ -1,32 +1,54 @@
 #include "VariableDelayLine.h"
 
-VariableDelayLine::VariableDelayLine (size_t maxDelayInSample, size_t numTaps)
-    : _delayLine (maxDelayInSample),
-      _numTaps (numTaps)
+template <typename SampleType>
+VariableDelayLine<SampleType>::VariableDelayLine (size_t maxDelayInSample, size_t numTaps, DelayMemory memory)
+    : _delayLine (maxDelayInSample, memory),
+      _numTaps (numTaps),
+      _numActiveTaps (numTaps)
 {
 }
 
-void VariableDelayLine::prepare (const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void VariableDelayLine<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
-    _delayInSamples.resize (spec.numChannels);
-    _tapOutBuffer.clear();
+    // per-channel state only grows and is resized in place, so re-preparing with the same or a
+    // smaller spec does not allocate; channels past spec.numChannels are kept idle
+    if (_delayInSamples.size() < spec.numChannels)
+    {
+        _delayInSamples.resize (spec.numChannels);
+        _tapGain.resize (spec.numChannels);
+        _tapOutBuffer.resize (spec.numChannels);
+    }
 
     for (size_t ch = 0; ch < spec.numChannels; ch++)
     {
-        _tapOutBuffer.emplace_back (_numTaps, spec.maximumBlockSize);
+        _tapOutBuffer[ch].setSize (static_cast<int> (_numTaps), static_cast<int> (spec.maximumBlockSize), false, false, true);
         _delayInSamples[ch].resize (_numTaps);
+        _tapGain[ch].resize (_numTaps);
     }
 
     for (size_t ch = 0; ch < spec.numChannels; ch++)
+    {
         for (size_t i = 0; i < _numTaps; i++)
+        {
             _delayInSamples[ch][i].reset (spec.sampleRate, 0.05);
+            _tapGain[ch][i].reset (spec.sampleRate, 0.05);
+            _tapGain[ch][i].setCurrentAndTargetValue (i < _numActiveTaps ? static_cast<SampleType> (1) : static_cast<SampleType> (0));
+        }
+    }
 
     _delayLine.prepare (spec);
 
+    _kernels = &SimdKernels::getKernels<SampleType>();
+    _input.resize (spec.maximumBlockSize);
+    _delayValues.resize (_numTaps * spec.maximumBlockSize);
+    _outputMix.prepare (spec.sampleRate);
+
     reset();
 }
 
-void VariableDelayLine::reset()
+template <typename SampleType>
+void VariableDelayLine<SampleType>::reset()
 {
     for (size_t ch = 0; ch < _tapOutBuffer.size(); ch++)
         _tapOutBuffer[ch].clear();
@@ -34,35 +56,186 @@ void VariableDelayLine::reset()
     _delayLine.reset();
 }
 
-void VariableDelayLine::process (const juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void VariableDelayLine<SampleType>::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::process (const juce::dsp::ProcessContextReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<float>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::process (const juce::dsp::ProcessContextNonReplacing<double>& context)
+{
+    processBlock (context.getInputBlock(), context.getOutputBlock());
+}
+
+template <typename SampleType>
+template <typename IOType>
+void VariableDelayLine<SampleType>::processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock)
 {
-    auto& outputBlock = context.getOutputBlock();
     const auto numChannels = outputBlock.getNumChannels();
     const auto numSamples = outputBlock.getNumSamples();
+    const auto maxBlockSize = _input.size();
+    const auto maximumDelay = _delayLine.getCommittedDelayInSamples();
+
+    jassert (maxBlockSize > 0);
+    jassert (inputBlock.getNumChannels() == numChannels && inputBlock.getNumSamples() == numSamples);
+
+    _outputMix.beginBlock (numSamples);
 
     for (size_t ch = 0; ch < numChannels; ch++)
     {
-        auto* samples = outputBlock.getChannelPointer (ch);
-
-        for (size_t i = 0; i < numSamples; i++)
+        for (size_t start = 0; start < numSamples; start += maxBlockSize)
         {
-            _delayLine.pushSample (ch, samples[i]);
+            const auto blockSize = juce::jmin (maxBlockSize, numSamples - start);
+            const auto* input = inputBlock.getChannelPointer (ch) + start;
+            auto* output = outputBlock.getChannelPointer (ch) + start;
+
+            if (isSmoothing (ch))
+            {
+                for (size_t i = 0; i < blockSize; i++)
+                    processSample (ch, i, static_cast<SampleType> (input[i]));
+
+                _outputMix.write (input, _tapOutBuffer[ch].getReadPointer (0), output, start, blockSize);
+                reportToMeteringFeed (ch, blockSize);
+                continue;
+            }
+
+            for (size_t i = 0; i < blockSize; i++)
+                _input[i] = static_cast<SampleType> (input[i]);
+
+            SampleType longestDelay = 0;
+
+            for (size_t n = 0; n < _numTaps; n++)
+            {
+                if (! isTapRead (ch, n))
+                    continue;
+
+                const auto delay = _delayInSamples[ch][n].getTargetValue();
+
+                _kernels->fill (_delayValues.data() + n * maxBlockSize, delay, blockSize);
+                longestDelay = juce::jmax (longestDelay, delay);
+            }
+
+            // A chunk is written before it is read. Reads that stay chunkSize samples short of the
+            // maximum delay only reach samples the chunk cannot have overwritten yet.
+            const auto longestDelayInt = static_cast<size_t> (std::floor (juce::jmin (longestDelay, static_cast<SampleType> (maximumDelay))));
+            const auto chunkSize = juce::jmax (static_cast<size_t> (1), maximumDelay - longestDelayInt);
+
+            for (size_t offset = 0; offset < blockSize; offset += chunkSize)
+            {
+                const auto length = juce::jmin (chunkSize, blockSize - offset);
+
+                _delayLine.pushBlock (ch, _input.data() + offset, length);
+
+                for (size_t n = 0; n < _numTaps; n++)
+                    if (isTapRead (ch, n))
+                        _delayLine.readBlock (ch, _delayValues.data() + n * maxBlockSize + offset, _tapOutBuffer[ch].getWritePointer (static_cast<int> (n), static_cast<int> (offset)), length);
+
+                _delayLine.advanceReadPointer (ch, length);
+            }
 
             for (size_t n = 1; n < _numTaps; n++)
-                _tapOutBuffer[ch].setSample (n, i, _delayLine.popSample (ch, _delayInSamples[ch][n].getNextValue(), false));
+                if (! isTapRead (ch, n))
+                    juce::FloatVectorOperations::clear (_tapOutBuffer[ch].getWritePointer (static_cast<int> (n)), static_cast<int> (blockSize));
 
-            float mainTapOut = _delayLine.popSample (ch, _delayInSamples[ch][0].getNextValue());
-            _tapOutBuffer[ch].setSample (0, i, mainTapOut);
+            _outputMix.write (input, _tapOutBuffer[ch].getReadPointer (0), output, start, blockSize);
 
-            samples[i] = mainTapOut;
+            reportToMeteringFeed (ch, blockSize);
         }
     }
 }
 
-void VariableDelayLine::setDelayInSamples (float newDelayInSamples, size_t tapIndex, bool force)
+template <typename SampleType>
+SampleType VariableDelayLine<SampleType>::processSample (size_t channel, size_t index, SampleType input)
+{
+    _delayLine.pushSample (channel, input);
+
+    for (size_t n = 1; n < _numTaps; n++)
+    {
+        auto tapOut = static_cast<SampleType> (0);
+
+        if (isTapRead (channel, n))
+        {
+            tapOut = _delayLine.popSample (channel, _delayInSamples[channel][n].getNextValue(), false);
+
+            if (_tapGain[channel][n].isSmoothing())
+                tapOut *= _tapGain[channel][n].getNextValue();
+        }
+
+        _tapOutBuffer[channel].setSample (static_cast<int> (n), static_cast<int> (index), tapOut);
+    }
+
+    const auto mainTapOut = _delayLine.popSample (channel, _delayInSamples[channel][0].getNextValue());
+    _tapOutBuffer[channel].setSample (0, static_cast<int> (index), mainTapOut);
+
+    return mainTapOut;
+}
+
+template <typename SampleType>
+bool VariableDelayLine<SampleType>::isSmoothing (size_t channel) const
+{
+    for (const auto& delay : _delayInSamples[channel])
+        if (delay.isSmoothing())
+            return true;
+
+    // taps fade in and out on the per sample path
+    for (const auto& gain : _tapGain[channel])
+        if (gain.isSmoothing())
+            return true;
+
+    return false;
+}
+
+template <typename SampleType>
+bool VariableDelayLine<SampleType>::isTapRead (size_t channel, size_t tapIndex) const
+{
+    const auto& gain = _tapGain[channel][tapIndex];
+
+    return gain.isSmoothing() || gain.getTargetValue() > static_cast<SampleType> (0);
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::setNumActiveTaps (size_t numActiveTaps)
+{
+    jassert (numActiveTaps >= 1 && numActiveTaps <= _numTaps);
+
+    _numActiveTaps = juce::jlimit (static_cast<size_t> (1), _numTaps, numActiveTaps);
+
+    for (size_t ch = 0; ch < _tapGain.size(); ch++)
+        for (size_t n = 1; n < _numTaps; n++)
+            _tapGain[ch][n].setTargetValue (n < _numActiveTaps ? static_cast<SampleType> (1) : static_cast<SampleType> (0));
+}
+
+template <typename SampleType>
+size_t VariableDelayLine<SampleType>::getNumActiveTaps() const
+{
+    return _numActiveTaps;
+}
+
+template <typename SampleType>
+bool VariableDelayLine<SampleType>::reserveDelayInSamples (size_t delayInSamples)
+{
+    return _delayLine.commitDelay (delayInSamples);
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex, bool force)
 {
     jassert (tapIndex < _numTaps);
     jassert (newDelayInSamples < getMaximumDelayInSamples());
+    jassert (newDelayInSamples <= _delayLine.getCommittedDelayInSamples());
 
     if (force)
         for (int ch = 0; ch < _delayInSamples.size(); ch++)
@@ -72,7 +245,29 @@ void VariableDelayLine::setDelayInSamples (float newDelayInSamples, size_t tapIn
             _delayInSamples[ch][tapIndex].setTargetValue (newDelayInSamples);
 }
 
-const float* VariableDelayLine::getTapOutBuffer (size_t channelIndex, size_t tapIndex) const
+template <typename SampleType>
+void VariableDelayLine<SampleType>::setParameters (const Parameters& parameters, bool force)
+{
+    // Parameters only hold the first maxNumTaps delays
+    jassert (_numTaps <= maxNumTaps);
+
+    const auto numTaps = juce::jmin (_numTaps, maxNumTaps);
+
+    for (size_t ch = 0; ch < _delayInSamples.size(); ch++)
+        for (size_t n = 0; n < numTaps; n++)
+        {
+            jassert (parameters.delayInSamples[n] < getMaximumDelayInSamples());
+            jassert (parameters.delayInSamples[n] <= _delayLine.getCommittedDelayInSamples());
+
+            if (force)
+                _delayInSamples[ch][n].setCurrentAndTargetValue (parameters.delayInSamples[n]);
+            else
+                _delayInSamples[ch][n].setTargetValue (parameters.delayInSamples[n]);
+        }
+}
+
+template <typename SampleType>
+const SampleType* VariableDelayLine<SampleType>::getTapOutBuffer (size_t channelIndex, size_t tapIndex) const
 {
     jassert (channelIndex < _tapOutBuffer.size());
     jassert (tapIndex < _numTaps);
@@ -80,7 +275,81 @@ const float* VariableDelayLine::getTapOutBuffer (size_t channelIndex, size_t tap
     return _tapOutBuffer[channelIndex].getReadPointer (tapIndex);
 }
 
-size_t VariableDelayLine::getMaximumDelayInSamples() const
+template <typename SampleType>
+size_t VariableDelayLine<SampleType>::getMaximumDelayInSamples() const
+{
+    return _delayLine.getMaximumDelayInSamples();
+}
+
+template <typename SampleType>
+OutputMix<SampleType>& VariableDelayLine<SampleType>::getOutputMix()
+{
+    return _outputMix;
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::setMeteringFeed (MeteringFeed* feed, size_t firstTap)
 {
-    return static_cast<size_t> (_delayLine.getMaximumDelayInSamples());
+    _meteringFeed = feed;
+    _meteringFirstTap = firstTap;
 }
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::reportToMeteringFeed (size_t channel, size_t blockSize)
+{
+    if (_meteringFeed == nullptr)
+        return;
+
+    for (size_t n = 0; n < _numTaps; n++)
+    {
+        _meteringFeed->addTapBlock (channel, _meteringFirstTap + n, _tapOutBuffer[channel].getReadPointer (static_cast<int> (n)), blockSize);
+        _meteringFeed->setDelayInSamples (channel, _meteringFirstTap + n, static_cast<float> (_delayInSamples[channel][n].getCurrentValue()));
+    }
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::saveState (StateWriter& writer) const
+{
+    writer.writeTag ("VDLN");
+    _delayLine.saveState (writer);
+    writer.write (static_cast<juce::uint64> (_numActiveTaps));
+
+    // tap outputs only hold the last block, they are not needed to continue
+    for (size_t ch = 0; ch < _delayLine.getNumChannels(); ch++)
+    {
+        writer.writeArray (_delayInSamples[ch]);
+        writer.writeArray (_tapGain[ch]);
+    }
+}
+
+template <typename SampleType>
+bool VariableDelayLine<SampleType>::restoreState (StateReader& reader)
+{
+    juce::uint64 numActiveTaps = 0;
+
+    if (! reader.readTag ("VDLN") || ! _delayLine.restoreState (reader) || ! reader.read (numActiveTaps) || numActiveTaps < 1 || numActiveTaps > _numTaps)
+        return false;
+
+    _numActiveTaps = static_cast<size_t> (numActiveTaps);
+
+    for (size_t ch = 0; ch < _delayLine.getNumChannels(); ch++)
+        if (! reader.readArray (_delayInSamples[ch]) || ! reader.readArray (_tapGain[ch]))
+            return false;
+
+    return true;
+}
+
+template <typename SampleType>
+SampleType VariableDelayLine<SampleType>::popSample (size_t channel)
+{
+    return _delayLine.popSample (channel, _delayInSamples[channel][0].getNextValue());
+}
+
+template <typename SampleType>
+void VariableDelayLine<SampleType>::pushSample (size_t channel, SampleType sample)
+{
+    _delayLine.pushSample (channel, sample);
+}
+
+template class VariableDelayLine<float>;
+template class VariableDelayLine<double>;
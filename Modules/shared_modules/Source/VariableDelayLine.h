@@ -1,22 +1,83 @@
 #pragma once
 
-class VariableDelayLine : public juce::dsp::ProcessorBase
+template <typename SampleType = float>
+class VariableDelayLine : public MultiPrecisionProcessor
 {
 public:
-    VariableDelayLine (size_t maxDelayInSample, size_t numTaps = 1);
+    // Parameters have a fixed capacity, so that a ParameterSnapshot copies them without allocating.
+    static constexpr size_t maxNumTaps = 8;
+
+    struct Parameters
+    {
+        std::array<SampleType, maxNumTaps> delayInSamples{}; // one per tap, those past numTaps are ignored
+    };
+
+    // With DelayMemory::reserved only the delays made usable with reserveDelayInSamples() take
+    // memory, see DelayBuffer.
+    VariableDelayLine (size_t maxDelayInSample, size_t numTaps = 1, DelayMemory memory = DelayMemory::allocated);
 
     virtual void prepare (const juce::dsp::ProcessSpec& spec) override;
     virtual void reset() override;
     virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override;
+    virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override;
+
+    // With reserved memory, the longest delay the setters below may use, modulation included;
+    // longer delays are clamped. Commits memory, so call it from the message thread while nothing
+    // is processing, as with prepare(). Returns false if the memory could not be committed.
+    bool reserveDelayInSamples (size_t delayInSamples);
+
+    void setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex = 0, bool force = false);
+    void setParameters (const Parameters& parameters, bool force = false);
+
+    // Taps from numActiveTaps on are faded out and then no longer read, their outputs stay at zero.
+    // The main tap is always active. Reactivated taps fade back in.
+    void setNumActiveTaps (size_t numActiveTaps);
+    size_t getNumActiveTaps() const;
 
-    void setDelayInSamples (float newDelayInSamples, size_t tapIndex = 0, bool force = false);
+    // dry/wet and output gain, applied as the main tap output is written
+    OutputMix<SampleType>& getOutputMix();
 
-    const float* getTapOutBuffer (size_t channelIndex, size_t tapIndex) const;
+    // Only valid on the audio thread, which overwrites it every block. Other threads read a MeteringFeed.
+    // Blocks longer than the prepared maximum are processed in chunks of that size, and the buffer
+    // then holds the last chunk.
+    const SampleType* getTapOutBuffer (size_t channelIndex, size_t tapIndex) const;
+    // Reports tap levels and delays from the audio thread, nullptr stops; set it between blocks. The
+    // taps go to the feed's taps from firstTap on, so processors sharing a feed each take their own.
+    void setMeteringFeed (MeteringFeed* feed, size_t firstTap = 0);
+
+    void saveState (StateWriter& writer) const;
+    bool restoreState (StateReader& reader);
     size_t getMaximumDelayInSamples() const;
 
+    // Sample-by-sample access for feedback structures, which read the line before writing to it.
+    // Reading first gives exactly the main tap delay, so that delay must be at least one sample.
+    // Tap outputs are not recorded on this path.
+    SampleType popSample (size_t channel);
+    void pushSample (size_t channel, SampleType sample);
+
 private:
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> _delayLine;
-    std::vector<std::vector<juce::LinearSmoothedValue<float>>> _delayInSamples;
+    template <typename IOType>
+    void processBlock (const juce::dsp::AudioBlock<const IOType>& inputBlock, const juce::dsp::AudioBlock<IOType>& outputBlock);
+    // the per sample path, used while any of the channel's parameters is ramping
+    SampleType processSample (size_t channel, size_t index, SampleType input);
+    bool isSmoothing (size_t channel) const;
+    void reportToMeteringFeed (size_t channel, size_t blockSize);
+    bool isTapRead (size_t channel, size_t tapIndex) const;
+
+    DelayBuffer<SampleType> _delayLine;
+    std::vector<std::vector<juce::LinearSmoothedValue<SampleType>>> _delayInSamples;
+    std::vector<std::vector<juce::LinearSmoothedValue<SampleType>>> _tapGain; // 1 active, 0 inactive
     size_t _numTaps;
-    std::vector<juce::AudioBuffer<float>> _tapOutBuffer;
+    size_t _numActiveTaps;
+    std::vector<juce::AudioBuffer<SampleType>> _tapOutBuffer;
+    MeteringFeed* _meteringFeed = nullptr;
+    size_t _meteringFirstTap = 0;
+    OutputMix<SampleType> _outputMix;
+
+    // per block values for the kernels, maximumBlockSize long
+    const SimdKernels::Kernels<SampleType>* _kernels = nullptr;
+    std::vector<SampleType> _input;
+    std::vector<SampleType> _delayValues; // [tap * maximumBlockSize + sample]
 };
@@ -0,0 +1,49 @@
+#include "WaveformTableRegistry.h"
+
+WaveformTableRegistry& WaveformTableRegistry::getInstance()
+{
+    static WaveformTableRegistry instance;
+
+    return instance;
+}
+
+const WaveformTableRegistry::Table& WaveformTableRegistry::getTable (OscillatorWrapper::Waveform waveform, size_t numPoints)
+{
+    jassert (numPoints > 1);
+
+    std::lock_guard<std::mutex> lock (_mutex);
+
+    auto& table = _tables[{ waveform, numPoints }];
+
+    if (table == nullptr)
+        table = std::make_unique<Table> (makeFunction (waveform, numPoints), -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, numPoints);
+
+    return *table;
+}
+
+size_t WaveformTableRegistry::getNumTables() const
+{
+    std::lock_guard<std::mutex> lock (_mutex);
+
+    return _tables.size();
+}
+
+std::function<float (float)> WaveformTableRegistry::makeFunction (OscillatorWrapper::Waveform waveform, size_t numPoints)
+{
+    switch (waveform)
+    {
+        case OscillatorWrapper::Square:
+            return [] (float x) { return x < 0.0f ? -1.0f : 1.0f; };
+
+        case OscillatorWrapper::Saw:
+            return [] (float x) { return x / juce::MathConstants<float>::pi; };
+
+        case OscillatorWrapper::Random:
+            // called once per point, in order
+            return [random = juce::Random (static_cast<juce::int64> (numPoints))] (float) mutable { return 2.0f * random.nextFloat() - 1.0f; };
+
+        case OscillatorWrapper::Sine:
+        default:
+            return [] (float x) { return std::sin (x); };
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// Process-wide store of the oscillator lookup tables, keyed by waveform and size. A table is built
+// the first time it is asked for and is then shared, unchanged, by every oscillator using it, so
+// hundreds of modulators cost one table. Tables are never freed, which is what lets oscillators
+// hold plain pointers to them and swap those while audio runs.
+//
+// The oscillators are LFOs driving ProcessorModulators, so saw and square are the exact shapes, not
+// band-limited: their corners are what the modulation targets should follow. The random table is
+// seeded by its size, so it is the same in every run.
+class WaveformTableRegistry
+{
+public:
+    using Table = juce::dsp::LookupTableTransform<float>;
+
+    static WaveformTableRegistry& getInstance();
+
+    // Builds missing tables under a lock: call from the message thread.
+    const Table& getTable (OscillatorWrapper::Waveform waveform, size_t numPoints);
+
+    size_t getNumTables() const;
+
+private:
+    WaveformTableRegistry() = default;
+
+    static std::function<float (float)> makeFunction (OscillatorWrapper::Waveform waveform, size_t numPoints);
+
+    mutable std::mutex _mutex;
+    std::map<std::pair<OscillatorWrapper::Waveform, size_t>, std::unique_ptr<Table>> _tables;
+
+    JUCE_DECLARE_NON_COPYABLE (WaveformTableRegistry)
+};
@@ -1,6 +1,21 @@
 #include "shared_modules.h"
 
+#include "Source/MeteringFeed.cpp"
+#include "Source/SimdKernels.cpp"
+#include "Source/ReservedMemory.cpp"
+#include "Source/DelayBuffer.cpp"
 #include "Source/OnePoleFilter.cpp"
 #include "Source/VariableDelayLine.cpp"
 #include "Source/VariableDelayAllpass.cpp"
+#include "Source/BatchedProcessors.cpp"
+#include "Source/WaveformTableRegistry.cpp"
 #include "Source/ProcessorModulator.cpp"
+#include "Source/TiledChain.cpp"
+#include "Source/FDN.cpp"
+#include "Source/PartitionedConvolver.cpp"
+#include "Source/FreezableProcessor.cpp"
+#include "Source/ResampledProcessor.cpp"
+#include "Source/ProcessorProfiler.cpp"
+#include "Source/QualityGovernor.cpp"
+#include "Source/RealtimeWorkerPool.cpp"
+#include "Source/ChannelParallelProcessor.cpp"
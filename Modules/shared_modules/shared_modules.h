@@ -18,7 +18,34 @@ BEGIN_JUCE_MODULE_DECLARATION
 
 #include <juce_dsp/juce_dsp.h>
 
+/** Config: SHARED_MODULES_ENABLE_PROFILING
+    Enables the per-call timing of processors wrapped in Profiled<>. When disabled the wrapper
+    adds no code at all.
+*/
+#ifndef SHARED_MODULES_ENABLE_PROFILING
+    #define SHARED_MODULES_ENABLE_PROFILING 0
+#endif
+
+#include "Source/MultiPrecisionProcessor.h"
+#include "Source/OutputMix.h"
+#include "Source/ParameterSnapshot.h"
+#include "Source/MeteringFeed.h"
+#include "Source/StateSerialization.h"
+#include "Source/SimdKernels.h"
+#include "Source/ReservedMemory.h"
+#include "Source/DelayBuffer.h"
 #include "Source/OnePoleFilter.h"
 #include "Source/VariableDelayLine.h"
 #include "Source/VariableDelayAllpass.h"
+#include "Source/BatchedProcessors.h"
 #include "Source/ProcessorModulator.h"
+#include "Source/WaveformTableRegistry.h"
+#include "Source/TiledChain.h"
+#include "Source/FDN.h"
+#include "Source/PartitionedConvolver.h"
+#include "Source/FreezableProcessor.h"
+#include "Source/ResampledProcessor.h"
+#include "Source/ProcessorProfiler.h"
+#include "Source/QualityGovernor.h"
+#include "Source/RealtimeWorkerPool.h"
+#include "Source/ChannelParallelProcessor.h"
@@ -0,0 +1,201 @@
+// Headless host for measuring a plugin processor end to end. It runs a number of instances of the
+// processor one after the other in every callback, the way a host runs the tracks of a session on one
+// audio thread, and behaves like a real host while doing so: buffer sizes change from call to call,
+// parameters are automated between calls and, with --paced, callbacks come at the audio rate rather
+// than back to back, so caches go cold between them.
+//
+//   --instances N         processors run per callback (8)
+//   --seconds S           length of the simulated audio (10)
+//   --sample-rate R       (48000)
+//   --block-size B        size prepared for, the largest one used (512)
+//   --fixed-block-size    always call back with the prepared size
+//   --automation P        chance per callback that an instance gets a parameter change (0.25)
+//   --paced               wait for every deadline, like an audio device
+//   --seed N              (1)
+//
+// The report gives the real-time factor (processing time over audio time), the number of callbacks
+// that missed their deadline and the spread of callback times. The exit code is 1 if any callback
+// missed its deadline.
+
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Options
+    {
+        int numInstances = 8;
+        double seconds = 10.0;
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        bool fixedBlockSize = false;
+        float automationProbability = 0.25f;
+        bool paced = false;
+        juce::int64 seed = 1;
+    };
+
+    Options parseOptions (const juce::ArgumentList& arguments)
+    {
+        Options options;
+
+        const auto getValue = [&arguments] (const char* option, auto defaultValue)
+        {
+            const auto value = arguments.getValueForOption (option);
+            return value.isEmpty() ? defaultValue : static_cast<decltype (defaultValue)> (value.getDoubleValue());
+        };
+
+        options.numInstances = juce::jmax (1, getValue ("--instances", options.numInstances));
+        options.seconds = juce::jmax (0.1, getValue ("--seconds", options.seconds));
+        options.sampleRate = juce::jmax (8000.0, getValue ("--sample-rate", options.sampleRate));
+        options.blockSize = juce::jmax (1, getValue ("--block-size", options.blockSize));
+        options.fixedBlockSize = arguments.containsOption ("--fixed-block-size");
+        options.automationProbability = juce::jlimit (0.0f, 1.0f, getValue ("--automation", options.automationProbability));
+        options.paced = arguments.containsOption ("--paced");
+        options.seed = getValue ("--seed", options.seed);
+
+        return options;
+    }
+
+    // Mostly the prepared size, but hosts also split blocks at loop points and automation events, or
+    // just hand over whatever the device delivered.
+    int nextBlockSize (juce::Random& random, const Options& options)
+    {
+        if (options.fixedBlockSize)
+            return options.blockSize;
+
+        const auto roll = random.nextInt (10);
+
+        if (roll < 6)
+            return options.blockSize;
+
+        if (roll < 8)
+            return juce::jmax (1, options.blockSize / 2);
+
+        if (roll < 9)
+            return 1 + random.nextInt (options.blockSize);
+
+        return 1 + random.nextInt (juce::jmin (32, options.blockSize));
+    }
+
+    void automate (juce::Random& random, juce::AudioProcessor& processor)
+    {
+        const auto& parameters = processor.getParameters();
+
+        if (parameters.isEmpty())
+            return;
+
+        parameters[random.nextInt (parameters.size())]->setValueNotifyingHost (random.nextFloat());
+    }
+
+    double getPercentile (std::vector<double> values, double percentile)
+    {
+        if (values.empty())
+            return 0.0;
+
+        const auto index = static_cast<size_t> (std::ceil (percentile * static_cast<double> (values.size()))) - 1;
+        const auto nth = values.begin() + static_cast<std::ptrdiff_t> (juce::jmin (index, values.size() - 1));
+
+        std::nth_element (values.begin(), nth, values.end());
+
+        return *nth;
+    }
+} // namespace
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto options = parseOptions (juce::ArgumentList (argc, argv));
+
+    std::vector<std::unique_ptr<juce::AudioProcessor>> instances;
+
+    for (int i = 0; i < options.numInstances; i++)
+    {
+        instances.emplace_back (createPluginFilter());
+        instances.back()->setRateAndBufferSizeDetails (options.sampleRate, options.blockSize);
+        instances.back()->prepareToPlay (options.sampleRate, options.blockSize);
+    }
+
+    const auto numChannels = instances.front()->getTotalNumOutputChannels();
+    std::vector<juce::AudioBuffer<float>> buffers;
+
+    for (int i = 0; i < options.numInstances; i++)
+        buffers.emplace_back (juce::jmax (numChannels, instances[static_cast<size_t> (i)]->getTotalNumInputChannels()), options.blockSize);
+
+    juce::MidiBuffer midiMessages;
+    juce::Random random (options.seed);
+
+    const auto totalSamples = static_cast<juce::int64> (options.seconds * options.sampleRate);
+    std::vector<double> loads;
+    std::vector<double> callbackSeconds;
+    std::vector<double> nsPerSample;
+
+    double processingSeconds = 0.0;
+    size_t numMisses = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (juce::int64 position = 0; position < totalSamples;)
+    {
+        const auto numSamples = static_cast<int> (juce::jmin (static_cast<juce::int64> (nextBlockSize (random, options)), totalSamples - position));
+
+        // the input is written outside of the callback, like a device driver would
+        for (auto& buffer : buffers)
+            for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+                for (int i = 0; i < numSamples; i++)
+                    buffer.setSample (ch, i, 0.25f * (2.0f * random.nextFloat() - 1.0f));
+
+        if (options.paced)
+            std::this_thread::sleep_until (start + std::chrono::duration<double> (static_cast<double> (position) / options.sampleRate));
+
+        // automation lands between callbacks, so setting it is not part of the measured time
+        for (auto& instance : instances)
+            if (random.nextFloat() < options.automationProbability)
+                automate (random, *instance);
+
+        const auto callbackStart = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < instances.size(); i++)
+        {
+            juce::AudioBuffer<float> block (buffers[i].getArrayOfWritePointers(), buffers[i].getNumChannels(), numSamples);
+            instances[i]->processBlock (block, midiMessages);
+        }
+
+        const auto elapsed = std::chrono::duration<double> (std::chrono::steady_clock::now() - callbackStart).count();
+        const auto deadline = static_cast<double> (numSamples) / options.sampleRate;
+
+        loads.push_back (elapsed / deadline);
+        callbackSeconds.push_back (elapsed);
+        nsPerSample.push_back (1.0e9 * elapsed / static_cast<double> (numSamples));
+
+        processingSeconds += elapsed;
+        numMisses += elapsed > deadline ? 1 : 0;
+        position += numSamples;
+    }
+
+    for (auto& instance : instances)
+        instance->releaseResources();
+
+    const auto audioSeconds = static_cast<double> (totalSamples) / options.sampleRate;
+    const auto realtimeFactor = processingSeconds / audioSeconds;
+
+    const auto meanNsPerSample = std::accumulate (nsPerSample.begin(), nsPerSample.end(), 0.0) / static_cast<double> (nsPerSample.size());
+    const auto variance = std::accumulate (nsPerSample.begin(), nsPerSample.end(), 0.0, [meanNsPerSample] (double sum, double value) { return sum + (value - meanNsPerSample) * (value - meanNsPerSample); })
+                          / static_cast<double> (nsPerSample.size());
+
+    std::cout << instances.front()->getName() << ": " << options.numInstances << " instances, " << options.sampleRate << " Hz, "
+              << (options.fixedBlockSize ? "blocks of " : "blocks up to ") << options.blockSize << " samples, "
+              << options.seconds << " s of audio" << (options.paced ? ", paced" : "") << "\n"
+              << "callbacks              " << loads.size() << "\n"
+              << "real-time factor       " << realtimeFactor << " (" << 1.0 / realtimeFactor << "x real time)\n"
+              << "deadline misses        " << numMisses << " (" << 100.0 * static_cast<double> (numMisses) / static_cast<double> (loads.size()) << " %)\n"
+              << "load p50 / p99 / max   " << getPercentile (loads, 0.5) << " / " << getPercentile (loads, 0.99) << " / " << getPercentile (loads, 1.0) << "\n"
+              << "us p50 / p99 / max     " << 1.0e6 * getPercentile (callbackSeconds, 0.5) << " / " << 1.0e6 * getPercentile (callbackSeconds, 0.99) << " / " << 1.0e6 * getPercentile (callbackSeconds, 1.0) << "\n"
+              << "jitter                 " << std::sqrt (variance) << " ns per sample standard deviation, around " << meanNsPerSample << std::endl;
+
+    return numMisses == 0 ? 0 : 1;
+}
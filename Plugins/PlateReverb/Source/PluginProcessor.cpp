@@ -0,0 +1,240 @@
+#include "PluginProcessor.h"
+
+namespace
+{
+    // Dattorro's delays are given in samples at this rate and scaled to the one we run at
+    constexpr double referenceSampleRate = 29761.0;
+    constexpr double maximumSampleRate = 192000.0;
+
+    constexpr std::array<double, 4> diffuserDelays{ 142.0, 107.0, 379.0, 277.0 };
+    constexpr std::array<float, 4> diffuserGains{ 0.75f, 0.75f, 0.625f, 0.625f };
+    constexpr std::array<double, 8> tankDelays{ 672.0, 4453.0, 1800.0, 3720.0, 908.0, 4217.0, 2656.0, 3163.0 };
+
+    constexpr double maximumPredelaySeconds = 0.2;
+    constexpr float maximumModulationDepth = 16.0f;
+
+    constexpr size_t maximumPredelay = static_cast<size_t> (maximumPredelaySeconds * maximumSampleRate) + 1;
+    constexpr size_t maximumDiffuserDelay = 4096;
+    constexpr size_t maximumTankDelay = 32768;
+
+    // keeps the delay addressable when running above maximumSampleRate
+    float scaleDelay (double delayAtReferenceRate, double sampleRate, size_t maximumDelay)
+    {
+        return static_cast<float> (juce::jmin (delayAtReferenceRate * sampleRate / referenceSampleRate, static_cast<double> (maximumDelay - 2)));
+    }
+} // namespace
+
+PlateReverbAudioProcessor::PlateReverbAudioProcessor()
+    : AudioProcessor (BusesProperties()
+                          .withInput ("Input", juce::AudioChannelSet::stereo(), true)
+                          .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
+      _parameters (*this, nullptr, "PlateReverb", createParameterLayout()),
+      _predelayLine (maximumPredelay),
+      _allpasses{ VariableDelayAllpass<float> (maximumDiffuserDelay),
+                  VariableDelayAllpass<float> (maximumDiffuserDelay),
+                  VariableDelayAllpass<float> (maximumDiffuserDelay),
+                  VariableDelayAllpass<float> (maximumDiffuserDelay) },
+      _tank (maximumTankDelay)
+{
+    _diffuser.addProcessor (_predelayLine);
+    _diffuser.addProcessor (_inputFilter);
+
+    for (auto& allpass : _allpasses)
+        _diffuser.addProcessor (allpass);
+
+    _predelay = _parameters.getRawParameterValue ("predelay");
+    _bandwidth = _parameters.getRawParameterValue ("bandwidth");
+    _diffusion = _parameters.getRawParameterValue ("diffusion");
+    _decay = _parameters.getRawParameterValue ("decay");
+    _damping = _parameters.getRawParameterValue ("damping");
+    _modulationRate = _parameters.getRawParameterValue ("modulationRate");
+    _modulationDepth = _parameters.getRawParameterValue ("modulationDepth");
+    _mix = _parameters.getRawParameterValue ("mix");
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout PlateReverbAudioProcessor::createParameterLayout()
+{
+    auto frequencyRange = juce::NormalisableRange<float> (200.0f, 20000.0f);
+    frequencyRange.setSkewForCentre (4000.0f);
+
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("predelay", "Predelay", juce::NormalisableRange<float> (0.0f, 1000.0f * static_cast<float> (maximumPredelaySeconds)), 10.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("bandwidth", "Bandwidth", frequencyRange, 12000.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("diffusion", "Diffusion", juce::NormalisableRange<float> (0.0f, 1.0f), 1.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("decay", "Decay", juce::NormalisableRange<float> (0.0f, 0.98f), 0.7f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("damping", "Damping", frequencyRange, 8000.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("modulationRate", "Modulation Rate", juce::NormalisableRange<float> (0.0f, 5.0f), 1.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("modulationDepth", "Modulation Depth", juce::NormalisableRange<float> (0.0f, maximumModulationDepth), 4.0f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("mix", "Mix", juce::NormalisableRange<float> (0.0f, 1.0f), 0.3f));
+
+    return layout;
+}
+
+void PlateReverbAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    _sampleRate = sampleRate;
+    _maximumBlockSize = static_cast<size_t> (juce::jmax (1, samplesPerBlock));
+
+    const juce::dsp::ProcessSpec spec{ sampleRate, static_cast<juce::uint32> (_maximumBlockSize), static_cast<juce::uint32> (getTotalNumOutputChannels()) };
+
+    _diffuser.prepare (spec);
+    _tank.prepare (spec);
+    _mixer.prepare (spec);
+
+    for (size_t n = 0; n < _allpasses.size(); n++)
+        _allpasses[n].setDelayInSamples (scaleDelay (diffuserDelays[n], sampleRate, maximumDiffuserDelay), 0, true);
+
+    for (size_t n = 0; n < tankDelays.size(); n++)
+        _tank.setDelayInSamples (scaleDelay (tankDelays[n], sampleRate, maximumTankDelay - static_cast<size_t> (maximumModulationDepth)), n, true);
+
+    updateParameters (true);
+}
+
+void PlateReverbAudioProcessor::releaseResources()
+{
+}
+
+bool PlateReverbAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    if (output != juce::AudioChannelSet::mono() && output != juce::AudioChannelSet::stereo())
+        return false;
+
+    return layouts.getMainInputChannelSet() == output;
+}
+
+void PlateReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto ch = getTotalNumInputChannels(); ch < getTotalNumOutputChannels(); ch++)
+        buffer.clear (ch, 0, buffer.getNumSamples());
+
+    updateParameters (false);
+
+    // some hosts call back with more samples than they prepared for
+    juce::dsp::AudioBlock<float> block (buffer);
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += _maximumBlockSize)
+    {
+        auto chunk = block.getSubBlock (start, juce::jmin (_maximumBlockSize, numSamples - start));
+        processChunk (chunk);
+    }
+}
+
+void PlateReverbAudioProcessor::processChunk (juce::dsp::AudioBlock<float>& block)
+{
+    juce::dsp::ProcessContextReplacing<float> context (block);
+
+    _mixer.pushDrySamples (block);
+    _diffuser.process (context);
+    _tank.process (context);
+    _mixer.mixWetSamples (block);
+}
+
+void PlateReverbAudioProcessor::updateParameters (bool force)
+{
+    const auto predelay = juce::jmin (_predelay->load() * 0.001 * _sampleRate, static_cast<double> (maximumPredelay - 1));
+    const auto nyquistLimit = static_cast<float> (0.45 * _sampleRate);
+    const auto diffusion = _diffusion->load();
+
+    _predelayLine.setDelayInSamples (static_cast<float> (predelay), 0, force);
+    _inputFilter.setCutoffFrequency (juce::jmin (_bandwidth->load(), nyquistLimit), force);
+
+    for (size_t n = 0; n < _allpasses.size(); n++)
+        _allpasses[n].setGain (diffuserGains[n] * diffusion, force);
+
+    _tank.setFeedback (_decay->load(), force);
+    _tank.setDampingFrequency (juce::jmin (_damping->load(), nyquistLimit), force);
+    _tank.setModulation (_modulationRate->load(), _modulationDepth->load());
+
+    _mixer.setWetMixProportion (_mix->load());
+}
+
+juce::AudioProcessorEditor* PlateReverbAudioProcessor::createEditor()
+{
+    return new juce::GenericAudioProcessorEditor (*this);
+}
+
+bool PlateReverbAudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+const juce::String PlateReverbAudioProcessor::getName() const
+{
+    return "Plate Reverb";
+}
+
+bool PlateReverbAudioProcessor::acceptsMidi() const
+{
+    return false;
+}
+
+bool PlateReverbAudioProcessor::producesMidi() const
+{
+    return false;
+}
+
+bool PlateReverbAudioProcessor::isMidiEffect() const
+{
+    return false;
+}
+
+double PlateReverbAudioProcessor::getTailLengthSeconds() const
+{
+    return 20.0;
+}
+
+int PlateReverbAudioProcessor::getNumPrograms()
+{
+    return 1;
+}
+
+int PlateReverbAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void PlateReverbAudioProcessor::setCurrentProgram (int index)
+{
+    juce::ignoreUnused (index);
+}
+
+const juce::String PlateReverbAudioProcessor::getProgramName (int index)
+{
+    juce::ignoreUnused (index);
+    return {};
+}
+
+void PlateReverbAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+    juce::ignoreUnused (index, newName);
+}
+
+void PlateReverbAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    if (auto xml = _parameters.copyState().createXml())
+        copyXmlToBinary (*xml, destData);
+}
+
+void PlateReverbAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    if (auto xml = getXmlFromBinary (data, sizeInBytes))
+        if (xml->hasTagName (_parameters.state.getType()))
+            _parameters.replaceState (juce::ValueTree::fromXml (*xml));
+}
+
+juce::AudioProcessorValueTreeState& PlateReverbAudioProcessor::getValueTreeState()
+{
+    return _parameters;
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new PlateReverbAudioProcessor();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <shared_modules/shared_modules.h>
+
+// Plate reverb in the shape of Dattorro's: predelay, input bandwidth, four diffusing allpasses and a
+// modulated, damped feedback delay network as the tank.
+class PlateReverbAudioProcessor : public juce::AudioProcessor
+{
+public:
+    PlateReverbAudioProcessor();
+
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+
+    using AudioProcessor::processBlock;
+    void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    juce::AudioProcessorValueTreeState& getValueTreeState();
+
+private:
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void updateParameters (bool force);
+    void processChunk (juce::dsp::AudioBlock<float>& block);
+
+    juce::AudioProcessorValueTreeState _parameters;
+    std::atomic<float>* _predelay = nullptr;
+    std::atomic<float>* _bandwidth = nullptr;
+    std::atomic<float>* _diffusion = nullptr;
+    std::atomic<float>* _decay = nullptr;
+    std::atomic<float>* _damping = nullptr;
+    std::atomic<float>* _modulationRate = nullptr;
+    std::atomic<float>* _modulationDepth = nullptr;
+    std::atomic<float>* _mix = nullptr;
+
+    VariableDelayLine<float> _predelayLine;
+    OnePoleFilter::Lowpass<float> _inputFilter;
+    std::array<VariableDelayAllpass<float>, 4> _allpasses;
+    TiledChain _diffuser;
+    FDN<8> _tank;
+    juce::dsp::DryWetMixer<float> _mixer;
+
+    double _sampleRate = 0.0;
+    size_t _maximumBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlateReverbAudioProcessor)
+};
@@ -0,0 +1,197 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    const size_t numInstances = 5;
+    const size_t channelsPerInstance = 2;
+    const size_t maxDelayInSamples = 300;
+
+    std::vector<SimdKernels::Variant> getSupportedVariants()
+    {
+        std::vector<SimdKernels::Variant> variants;
+
+        for (const auto variant : { SimdKernels::Variant::generic, SimdKernels::Variant::avx2, SimdKernels::Variant::avx512 })
+            if (SimdKernels::isSupported (variant))
+                variants.push_back (variant);
+
+        return variants;
+    }
+
+    // Runs the batched processor and numInstances single instance processors over the same noise, in
+    // blocks of random length, and requires identical output. Before every block the automation may
+    // move the parameters of each instance, on the batched processor and on its single counterpart.
+    template <typename IOType, typename BatchedProcessor, typename SingleProcessor, typename Automation>
+    void checkMatchesSingleInstances (SimdKernels::Variant variant, BatchedProcessor& batched, std::vector<SingleProcessor>& singles, Automation&& automate)
+    {
+        const int maxBlockSize = 200;
+        const int numSamples = 1 << 14;
+
+        SimdKernels::forceVariant (variant);
+        batched.prepare ({ 48000.0, maxBlockSize, static_cast<juce::uint32> (numInstances * channelsPerInstance) });
+        SimdKernels::clearForcedVariant();
+
+        for (auto& single : singles)
+            single.prepare ({ 48000.0, maxBlockSize, static_cast<juce::uint32> (channelsPerInstance) });
+
+        juce::AudioBuffer<IOType> batchedBuffer (static_cast<int> (numInstances * channelsPerInstance), numSamples);
+        std::vector<juce::AudioBuffer<IOType>> singleBuffers (numInstances, juce::AudioBuffer<IOType> (static_cast<int> (channelsPerInstance), numSamples));
+        juce::Random random (3);
+
+        for (size_t k = 0; k < numInstances; k++)
+        {
+            for (size_t ch = 0; ch < channelsPerInstance; ch++)
+            {
+                for (auto i = 0; i < numSamples; i++)
+                {
+                    const auto sample = static_cast<IOType> (2.0f * random.nextFloat() - 1.0f);
+
+                    batchedBuffer.setSample (static_cast<int> (k * channelsPerInstance + ch), i, sample);
+                    singleBuffers[k].setSample (static_cast<int> (ch), i, sample);
+                }
+            }
+        }
+
+        for (auto start = 0; start < numSamples;)
+        {
+            const auto blockSize = juce::jmin (1 + random.nextInt (maxBlockSize), numSamples - start);
+
+            for (size_t k = 0; k < numInstances; k++)
+            {
+                automate (random, k, batched, singles[k]);
+
+                auto block = juce::dsp::AudioBlock<IOType> (singleBuffers[k]).getSubBlock (static_cast<size_t> (start), static_cast<size_t> (blockSize));
+                singles[k].process (juce::dsp::ProcessContextReplacing<IOType> (block));
+            }
+
+            auto block = juce::dsp::AudioBlock<IOType> (batchedBuffer).getSubBlock (static_cast<size_t> (start), static_cast<size_t> (blockSize));
+            batched.process (juce::dsp::ProcessContextReplacing<IOType> (block));
+
+            start += blockSize;
+        }
+
+        for (size_t k = 0; k < numInstances; k++)
+            for (size_t ch = 0; ch < channelsPerInstance; ch++)
+                for (auto i = 0; i < numSamples; i++)
+                    if (batchedBuffer.getSample (static_cast<int> (k * channelsPerInstance + ch), i) != singleBuffers[k].getSample (static_cast<int> (ch), i))
+                    {
+                        FAIL_CHECK ("instance " << k << " channel " << ch << " sample " << i << ": "
+                                                << batchedBuffer.getSample (static_cast<int> (k * channelsPerInstance + ch), i) << " != " << singleBuffers[k].getSample (static_cast<int> (ch), i));
+                        return;
+                    }
+    }
+
+    const auto automateCutoff = [] (juce::Random& random, size_t instance, auto& batched, auto& single)
+    {
+        if (random.nextInt (4) == 0)
+        {
+            const auto cutoff = 20.0f * std::pow (1000.0f, random.nextFloat());
+            const auto force = random.nextBool();
+
+            batched.setCutoffFrequency (instance, cutoff, force);
+            single.setCutoffFrequency (cutoff, force);
+        }
+    };
+
+    // delays down to zero, where a lane reads the slot it is about to write
+    const auto automateAllpass = [] (juce::Random& random, size_t instance, auto& batched, auto& single)
+    {
+        if (random.nextInt (4) == 0)
+        {
+            const auto delay = random.nextBool() ? random.nextFloat() * 3.0f : random.nextFloat() * (maxDelayInSamples - 1);
+            const auto force = random.nextBool();
+
+            batched.setDelayInSamples (instance, delay, force);
+            single.setDelayInSamples (delay, 0, force);
+        }
+
+        if (random.nextInt (4) == 0)
+        {
+            const auto gain = 1.9f * random.nextFloat() - 0.95f;
+            const auto force = random.nextBool();
+
+            batched.setGain (instance, gain, force);
+            single.setGain (gain, force);
+        }
+    };
+} // namespace
+
+TEST_CASE ("Batched one pole filters match single instances", "[BatchedProcessors]")
+{
+    for (const auto variant : getSupportedVariants())
+    {
+        INFO (SimdKernels::getName (variant));
+
+        {
+            Batched::Lowpass<float> batched (numInstances);
+            std::vector<OnePoleFilter::Lowpass<float>> singles (numInstances);
+
+            checkMatchesSingleInstances<float> (variant, batched, singles, automateCutoff);
+        }
+
+        {
+            Batched::Highpass<double> batched (numInstances);
+            std::vector<OnePoleFilter::Highpass<double>> singles (numInstances);
+
+            checkMatchesSingleInstances<double> (variant, batched, singles, automateCutoff);
+        }
+    }
+}
+
+TEST_CASE ("Batched allpasses match single instances", "[BatchedProcessors]")
+{
+    for (const auto variant : getSupportedVariants())
+    {
+        INFO (SimdKernels::getName (variant));
+
+        {
+            Batched::VariableDelayAllpass<float> batched (numInstances, maxDelayInSamples);
+            std::vector<VariableDelayAllpass<float>> singles;
+
+            for (size_t k = 0; k < numInstances; k++)
+                singles.emplace_back (maxDelayInSamples);
+
+            checkMatchesSingleInstances<float> (variant, batched, singles, automateAllpass);
+        }
+
+        {
+            Batched::VariableDelayAllpass<double> batched (numInstances, maxDelayInSamples);
+            std::vector<VariableDelayAllpass<double>> singles;
+
+            for (size_t k = 0; k < numInstances; k++)
+                singles.emplace_back (maxDelayInSamples);
+
+            checkMatchesSingleInstances<float> (variant, batched, singles, automateAllpass);
+        }
+    }
+}
+
+TEST_CASE ("Batched processors keep their cutoffs across sample rate changes", "[BatchedProcessors]")
+{
+    Batched::Lowpass<float> batched (2);
+    OnePoleFilter::Lowpass<float> single;
+
+    batched.prepare ({ 48000.0, 64, 2 });
+    single.prepare ({ 48000.0, 64, 1 });
+
+    batched.setCutoffFrequency (1, 300.0f, true);
+    single.setCutoffFrequency (300.0f, true);
+
+    batched.prepare ({ 96000.0, 64, 2 });
+    single.prepare ({ 96000.0, 64, 1 });
+
+    juce::AudioBuffer<float> batchedBuffer (2, 64);
+    juce::AudioBuffer<float> singleBuffer (1, 64);
+    batchedBuffer.clear();
+    batchedBuffer.setSample (1, 0, 1.0f);
+    singleBuffer.clear();
+    singleBuffer.setSample (0, 0, 1.0f);
+
+    juce::dsp::AudioBlock<float> batchedBlock (batchedBuffer);
+    juce::dsp::AudioBlock<float> singleBlock (singleBuffer);
+    batched.process (juce::dsp::ProcessContextReplacing<float> (batchedBlock));
+    single.process (juce::dsp::ProcessContextReplacing<float> (singleBlock));
+
+    for (auto i = 0; i < 64; i++)
+        REQUIRE (batchedBuffer.getSample (1, i) == singleBuffer.getSample (0, i));
+}
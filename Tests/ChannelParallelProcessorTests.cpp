@@ -0,0 +1,97 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    juce::AudioBuffer<float> generateNoise (size_t numChannels, size_t numSamples)
+    {
+        juce::AudioBuffer<float> buffer (static_cast<int> (numChannels), static_cast<int> (numSamples));
+        juce::Random random (42);
+
+        for (auto ch = 0; ch < buffer.getNumChannels(); ch++)
+            for (auto i = 0; i < buffer.getNumSamples(); i++)
+                buffer.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+        return buffer;
+    }
+} // namespace
+
+TEST_CASE ("Test channel parallel processing matches a single processor", "[ChannelParallelProcessor]")
+{
+    const auto numThreads = static_cast<size_t> (GENERATE (1, 2, 3, 4));
+    const auto parallelThreshold = static_cast<size_t> (GENERATE (0, 1 << 20));
+
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 7 };
+
+    const auto makeAllpass = [] { return std::make_unique<VariableDelayAllpass<>> (100, 2); };
+
+    ChannelParallelProcessor parallelProcessor (makeAllpass, numThreads);
+    parallelProcessor.setParallelThreshold (parallelThreshold);
+    parallelProcessor.prepare (spec);
+
+    auto serialProcessor = makeAllpass();
+    serialProcessor->prepare (spec);
+
+    const auto setParameters = [] (VariableDelayAllpass<>& allpass) {
+        allpass.setGain (0.6f, true);
+        allpass.setDelayInSamples (17.3f, 0, true);
+        allpass.setDelayInSamples (5.0f, 1, true);
+    };
+
+    parallelProcessor.forEachProcessor<VariableDelayAllpass<>> (setParameters);
+    setParameters (*serialProcessor);
+
+    CHECK (parallelProcessor.getNumGroups() == juce::jmin (numThreads, (size_t) spec.numChannels));
+
+    auto parallelBuffer = generateNoise (spec.numChannels, spec.maximumBlockSize);
+    auto serialBuffer = parallelBuffer;
+
+    for (int block = 0; block < 4; block++)
+    {
+        TestHelpers::runProcess (parallelProcessor, parallelBuffer);
+        TestHelpers::runProcess (*serialProcessor, serialBuffer);
+
+        for (auto ch = 0; ch < serialBuffer.getNumChannels(); ch++)
+            for (auto i = 0; i < serialBuffer.getNumSamples(); i++)
+                REQUIRE (parallelBuffer.getSample (ch, i) == serialBuffer.getSample (ch, i));
+    }
+}
+
+TEST_CASE ("Test worker pool runs every task exactly once", "[ChannelParallelProcessor]")
+{
+    RealtimeWorkerPool workerPool (3);
+
+    std::array<std::atomic<int>, 10> counters;
+
+    for (auto& c : counters)
+        c = 0;
+
+    for (int run = 0; run < 100; run++)
+        workerPool.run ([] (void* context, size_t taskIndex) { (*static_cast<std::array<std::atomic<int>, 10>*> (context))[taskIndex]++; },
+                        &counters,
+                        counters.size());
+
+    for (auto& c : counters)
+        CHECK (c == 100);
+}
+
+TEST_CASE ("Test worker pool takes over the tasks of a stalled worker", "[ChannelParallelProcessor]")
+{
+    RealtimeWorkerPool workerPool (2);
+    workerPool.setTakeoverDeadline (std::chrono::microseconds (100));
+
+    // tasks 1 and 4 are worker 0's, task 1 stalls whichever thread runs it
+    std::array<std::thread::id, 6> threads;
+
+    workerPool.run ([] (void* context, size_t taskIndex)
+                    {
+                        if (taskIndex == 1)
+                            std::this_thread::sleep_for (std::chrono::milliseconds (100));
+
+                        (*static_cast<std::array<std::thread::id, 6>*> (context))[taskIndex] = std::this_thread::get_id();
+                    },
+                    &threads,
+                    threads.size());
+
+    CHECK (threads[4] != threads[1]);
+}
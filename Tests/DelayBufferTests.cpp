@@ -0,0 +1,265 @@
+#include "ReferenceModels.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    template <typename SampleType>
+    void checkMatchesJuceDelayLine (size_t maximumDelayInSamples)
+    {
+        const size_t numChannels = 3;
+        juce::dsp::ProcessSpec spec{ 48000.0, 512, static_cast<juce::uint32> (numChannels) };
+
+        DelayBuffer<SampleType> buffer (maximumDelayInSamples);
+        ReferenceModels::DelayLine<SampleType> reference (maximumDelayInSamples);
+
+        buffer.prepare (spec);
+        reference.prepare (numChannels);
+
+        REQUIRE (buffer.getMaximumDelayInSamples() == reference.getMaximumDelayInSamples());
+
+        juce::Random random (maximumDelayInSamples);
+        const auto maxDelay = static_cast<float> (buffer.getMaximumDelayInSamples());
+
+        for (size_t i = 0; i < 10 * (maximumDelayInSamples + 2); i++)
+            for (size_t ch = 0; ch < numChannels; ch++)
+            {
+                const auto input = static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f);
+                buffer.pushSample (ch, input);
+                reference.pushSample (ch, input);
+
+                // a read-only tap, then the main one; delays run a little past both ends to test the clamping
+                const auto tapDelay = static_cast<SampleType> ((maxDelay + 2.0f) * random.nextFloat() - 1.0f);
+                const auto mainDelay = static_cast<SampleType> ((maxDelay + 2.0f) * random.nextFloat() - 1.0f);
+
+                REQUIRE (buffer.popSample (ch, tapDelay, false) == reference.popSample (ch, tapDelay, false));
+                REQUIRE (buffer.popSample (ch, mainDelay) == reference.popSample (ch, mainDelay));
+            }
+    }
+} // namespace
+
+TEST_CASE ("Delay buffer matches the reference delay line, clamping included", "[DelayBuffer]")
+{
+    for (const size_t maximumDelayInSamples : { 0, 1, 2, 3, 17, 1000 })
+    {
+        checkMatchesJuceDelayLine<float> (maximumDelayInSamples);
+        checkMatchesJuceDelayLine<double> (maximumDelayInSamples);
+    }
+}
+
+TEST_CASE ("Delay buffer matches juce::dsp::DelayLine<Linear>", "[DelayBuffer]")
+{
+    // the JUCE class itself, not a model of it; delays stay in range, which JUCE asserts on
+    const auto check = [] (auto sampleType, size_t maximumDelayInSamples)
+    {
+        using SampleType = decltype (sampleType);
+
+        const size_t numChannels = 2;
+        juce::dsp::ProcessSpec spec{ 48000.0, 512, static_cast<juce::uint32> (numChannels) };
+
+        DelayBuffer<SampleType> buffer (maximumDelayInSamples);
+        juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::Linear> juceDelayLine (static_cast<int> (maximumDelayInSamples));
+
+        buffer.prepare (spec);
+        juceDelayLine.prepare (spec);
+
+        REQUIRE (buffer.getMaximumDelayInSamples() == static_cast<size_t> (juceDelayLine.getMaximumDelayInSamples()));
+
+        juce::Random random (static_cast<juce::int64> (maximumDelayInSamples) + 7);
+        const auto maxDelay = static_cast<float> (juceDelayLine.getMaximumDelayInSamples());
+
+        for (size_t i = 0; i < 10 * (maximumDelayInSamples + 2); i++)
+            for (size_t ch = 0; ch < numChannels; ch++)
+            {
+                const auto input = static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f);
+                buffer.pushSample (ch, input);
+                juceDelayLine.pushSample (static_cast<int> (ch), input);
+
+                const auto tapDelay = static_cast<SampleType> (maxDelay * random.nextFloat());
+                const auto mainDelay = static_cast<SampleType> (maxDelay * random.nextFloat());
+
+                REQUIRE (buffer.popSample (ch, tapDelay, false) == juceDelayLine.popSample (static_cast<int> (ch), tapDelay, false));
+                REQUIRE (buffer.popSample (ch, mainDelay) == juceDelayLine.popSample (static_cast<int> (ch), mainDelay));
+            }
+    };
+
+    for (const size_t maximumDelayInSamples : { 0, 1, 2, 3, 17, 1000 })
+    {
+        check (0.0f, maximumDelayInSamples);
+        check (0.0, maximumDelayInSamples);
+    }
+}
+
+TEST_CASE ("Delay buffer prepare clears the state", "[DelayBuffer]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+
+    DelayBuffer<float> buffer (100);
+    buffer.prepare (spec);
+
+    for (size_t i = 0; i < 50; i++)
+    {
+        buffer.pushSample (0, 1.0f);
+        buffer.pushSample (1, 1.0f);
+        buffer.popSample (0, 10.0f);
+        buffer.popSample (1, 10.0f);
+    }
+
+    // fewer channels, then back to two: the second channel must not come back with old samples
+    buffer.prepare ({ spec.sampleRate, spec.maximumBlockSize, 1 });
+    buffer.prepare (spec);
+
+    for (size_t ch = 0; ch < 2; ch++)
+        for (size_t d = 0; d <= buffer.getMaximumDelayInSamples(); d++)
+            CHECK (buffer.popSample (ch, static_cast<float> (d), false) == 0.0f);
+}
+
+namespace
+{
+    template <typename ProcessorType>
+    juce::AudioBuffer<float> processRampingDelays (ProcessorType& processor)
+    {
+        const juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+        processor.prepare (spec);
+        REQUIRE (processor.reserveDelayInSamples (701));
+        processor.setDelayInSamples (300.5f, 0, true);
+        processor.setDelayInSamples (700.0f, 1, true);
+
+        auto signal = juce::AudioBuffer<float> (2, 48000);
+        juce::Random random (7);
+
+        for (int ch = 0; ch < signal.getNumChannels(); ch++)
+            for (int i = 0; i < signal.getNumSamples(); i++)
+                signal.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+        for (int start = 0; start < signal.getNumSamples(); start += static_cast<int> (spec.maximumBlockSize))
+        {
+            // ramps over 0.05 s, slower than a sample per sample, past where the ring started; the
+            // ring grows between blocks, as it would from the message thread with processing stopped
+            if (start == 9600)
+            {
+                REQUIRE (processor.reserveDelayInSamples (2201));
+                processor.setDelayInSamples (2200.25f, 0);
+                processor.setDelayInSamples (1500.0f, 1);
+            }
+
+            juce::dsp::AudioBlock<float> block (signal);
+            auto subBlock = block.getSubBlock (static_cast<size_t> (start), juce::jmin<size_t> (spec.maximumBlockSize, static_cast<size_t> (signal.getNumSamples() - start)));
+            processor.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+        }
+
+        return signal;
+    }
+
+    template <typename ProcessorType>
+    void checkReservedMatchesAllocated()
+    {
+        ProcessorType allocated (48000, 2);
+        ProcessorType reserved (48000, 2, DelayMemory::reserved);
+
+        const auto expected = processRampingDelays (allocated);
+        const auto actual = processRampingDelays (reserved);
+
+        for (int ch = 0; ch < expected.getNumChannels(); ch++)
+            for (int i = 0; i < expected.getNumSamples(); i++)
+                REQUIRE (actual.getSample (ch, i) == expected.getSample (ch, i));
+    }
+} // namespace
+
+TEST_CASE ("Reserved delay memory reproduces allocated memory", "[DelayBuffer]")
+{
+    SECTION ("VariableDelayLine")
+    {
+        checkReservedMatchesAllocated<VariableDelayLine<float>>();
+    }
+
+    SECTION ("VariableDelayAllpass")
+    {
+        checkReservedMatchesAllocated<VariableDelayAllpass<float>>();
+    }
+}
+
+TEST_CASE ("Reserved delay memory only holds the delays in use", "[DelayBuffer]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+    const size_t oneMinute = 60 * 48000;
+
+    DelayBuffer<double> allocated (oneMinute);
+    DelayBuffer<double> reserved (oneMinute, DelayMemory::reserved);
+
+    allocated.prepare (spec);
+    reserved.prepare (spec);
+
+    CHECK (allocated.getResidentBytes() >= 2 * oneMinute * sizeof (double));
+    CHECK (reserved.getResidentBytes() <= 2 * ReservedMemory::getPageSize());
+    CHECK (reserved.getMaximumDelayInSamples() == oneMinute);
+
+    CHECK (allocated.commitDelay (4800));
+    CHECK (reserved.commitDelay (4800));
+
+    CHECK (allocated.getCommittedDelayInSamples() == oneMinute);
+    CHECK (reserved.getCommittedDelayInSamples() >= 4800);
+    CHECK (reserved.getCommittedDelayInSamples() < 4800 + ReservedMemory::getPageSize());
+
+    for (size_t i = 0; i < 3 * oneMinute / 10; i++)
+        for (size_t ch = 0; ch < 2; ch++)
+        {
+            const auto input = std::sin (0.01 * static_cast<double> (i + ch));
+
+            allocated.pushSample (ch, input);
+            reserved.pushSample (ch, input);
+
+            REQUIRE (reserved.popSample (ch, 4799.5) == allocated.popSample (ch, 4799.5));
+        }
+
+    // the ring and at most a page either side of it, per channel
+    CHECK (reserved.getResidentBytes() <= 2 * (4802 * sizeof (double) + 2 * ReservedMemory::getPageSize()));
+}
+
+TEST_CASE ("Reserved delay memory is saved and restored", "[DelayBuffer]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 64, 1 };
+
+    VariableDelayLine<float> first (100000, 1, DelayMemory::reserved);
+    VariableDelayLine<float> second (100000, 1, DelayMemory::reserved);
+
+    first.prepare (spec);
+    second.prepare (spec);
+    REQUIRE (first.reserveDelayInSamples (5000));
+    first.setDelayInSamples (5000.0f, 0, true);
+
+    juce::AudioBuffer<float> buffer (1, 64);
+
+    for (int block = 0; block < 100; block++)
+    {
+        for (int i = 0; i < buffer.getNumSamples(); i++)
+            buffer.setSample (0, i, static_cast<float> (block * 64 + i));
+
+        TestHelpers::runProcess (first, buffer);
+    }
+
+    juce::MemoryBlock state;
+    StateWriter writer (state);
+    first.saveState (writer);
+
+    StateReader reader (state);
+    REQUIRE (second.restoreState (reader));
+
+    for (int block = 0; block < 100; block++)
+    {
+        juce::AudioBuffer<float> other (1, 64);
+
+        for (int i = 0; i < buffer.getNumSamples(); i++)
+        {
+            buffer.setSample (0, i, static_cast<float> (i));
+            other.setSample (0, i, static_cast<float> (i));
+        }
+
+        TestHelpers::runProcess (first, buffer);
+        TestHelpers::runProcess (second, other);
+
+        for (int i = 0; i < buffer.getNumSamples(); i++)
+            REQUIRE (other.getSample (0, i) == buffer.getSample (0, i));
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+// Renders the same long random signal through a reference and an optimised processor, in random
+// block sizes, with random parameter automation applied before every block, and reports the first
+// output sample where the two disagree by more than the tolerance.
+namespace EquivalenceHarness
+{
+    // A sample passes if it is within maxUlps of the reference, or if the error is below
+    // maxErrorDecibels relative to full scale, so values close to zero don't need ULP accuracy.
+    struct Tolerance
+    {
+        juce::int64 maxUlps = 0;
+        double maxErrorDecibels = -200.0;
+    };
+
+    struct Config
+    {
+        juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+        size_t numSamples = 1 << 16;
+        juce::int64 seed = 1;
+        Tolerance tolerance;
+    };
+
+    struct Divergence
+    {
+        bool found = false;
+        size_t sample = 0;
+        size_t channel = 0;
+        size_t blockStart = 0;
+        float reference = 0.0f;
+        float optimised = 0.0f;
+        juce::int64 ulps = 0;
+    };
+
+    static juce::int64 getUlpDistance (float a, float b)
+    {
+        if (a == b)
+            return 0;
+
+        if (std::isnan (a) || std::isnan (b))
+            return std::numeric_limits<juce::int64>::max();
+
+        // maps the float bit patterns onto a monotonic integer line
+        const auto toOrdered = [] (float value) {
+            juce::int32 bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+            return bits < 0 ? static_cast<juce::int64> (std::numeric_limits<juce::int32>::min()) - bits : static_cast<juce::int64> (bits);
+        };
+
+        return std::abs (toOrdered (a) - toOrdered (b));
+    }
+
+    static std::string toString (const Divergence& divergence)
+    {
+        if (! divergence.found)
+            return "no divergence";
+
+        std::ostringstream stream;
+        stream << "first divergence at sample " << divergence.sample << " (block starting at " << divergence.blockStart
+               << "), channel " << divergence.channel << ": reference " << divergence.reference << ", optimised "
+               << divergence.optimised << ", " << divergence.ulps << " ulps";
+
+        return stream.str();
+    }
+
+    // Both processors must already be constructed; they are prepared here. automate (random, processor)
+    // is called for each processor before every block, with identically seeded generators, so it
+    // can draw random parameter values and apply them to whatever processor type it is given.
+    template <typename Reference, typename Optimised, typename Automate>
+    static Divergence run (Reference& reference, Optimised& optimised, const Config& config, Automate automate)
+    {
+        const auto numChannels = static_cast<int> (config.spec.numChannels);
+        const auto maxBlockSize = static_cast<int> (config.spec.maximumBlockSize);
+        const auto maxError = juce::Decibels::decibelsToGain (config.tolerance.maxErrorDecibels, -400.0);
+
+        reference.prepare (config.spec);
+        optimised.prepare (config.spec);
+
+        juce::Random random (config.seed);
+        juce::AudioBuffer<float> referenceBuffer (numChannels, maxBlockSize);
+        juce::AudioBuffer<float> optimisedBuffer (numChannels, maxBlockSize);
+
+        for (size_t start = 0; start < config.numSamples;)
+        {
+            const auto blockSize = juce::jmin (1 + random.nextInt (maxBlockSize), static_cast<int> (config.numSamples - start));
+            const auto automationSeed = random.nextInt64();
+
+            juce::Random referenceAutomation (automationSeed);
+            juce::Random optimisedAutomation (automationSeed);
+            automate (referenceAutomation, reference);
+            automate (optimisedAutomation, optimised);
+
+            // noise with occasional silent and full scale blocks
+            const auto level = random.nextInt (8) == 0 ? 0.0f : random.nextInt (8) == 0 ? 1.0f : random.nextFloat();
+
+            for (auto ch = 0; ch < numChannels; ch++)
+                for (auto i = 0; i < blockSize; i++)
+                    referenceBuffer.setSample (ch, i, level * (2.0f * random.nextFloat() - 1.0f));
+
+            for (auto ch = 0; ch < numChannels; ch++)
+                optimisedBuffer.copyFrom (ch, 0, referenceBuffer, ch, 0, blockSize);
+
+            juce::dsp::AudioBlock<float> referenceBlock (referenceBuffer);
+            juce::dsp::AudioBlock<float> optimisedBlock (optimisedBuffer);
+            auto referenceSubBlock = referenceBlock.getSubBlock (0, static_cast<size_t> (blockSize));
+            auto optimisedSubBlock = optimisedBlock.getSubBlock (0, static_cast<size_t> (blockSize));
+
+            reference.process (juce::dsp::ProcessContextReplacing<float> (referenceSubBlock));
+            optimised.process (juce::dsp::ProcessContextReplacing<float> (optimisedSubBlock));
+
+            // report the earliest sample over all channels, not the first channel that diverges
+            Divergence divergence;
+
+            for (auto ch = 0; ch < numChannels; ch++)
+                for (auto i = 0; i < blockSize; i++)
+                {
+                    const auto expected = referenceBuffer.getSample (ch, i);
+                    const auto actual = optimisedBuffer.getSample (ch, i);
+                    const auto ulps = getUlpDistance (expected, actual);
+
+                    if (ulps <= config.tolerance.maxUlps || std::abs (static_cast<double> (actual) - static_cast<double> (expected)) <= maxError)
+                        continue;
+
+                    if (! divergence.found || start + static_cast<size_t> (i) < divergence.sample)
+                        divergence = { true, start + static_cast<size_t> (i), static_cast<size_t> (ch), start, expected, actual, ulps };
+
+                    break;
+                }
+
+            if (divergence.found)
+                return divergence;
+
+            start += static_cast<size_t> (blockSize);
+        }
+
+        return {};
+    }
+} // namespace EquivalenceHarness
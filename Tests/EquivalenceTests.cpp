@@ -0,0 +1,207 @@
+#include "EquivalenceHarness.h"
+#include "ReferenceModels.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // passes samples through unchanged, except for one which is nudged by a few ulps
+    class PerturbingProcessor : public juce::dsp::ProcessorBase
+    {
+    public:
+        PerturbingProcessor (size_t sampleToPerturb, size_t channelToPerturb)
+            : _sampleToPerturb (sampleToPerturb),
+              _channelToPerturb (channelToPerturb)
+        {
+        }
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            (void) spec;
+            _position = 0;
+        }
+        virtual void reset() override
+        {
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            auto& block = context.getOutputBlock();
+
+            if (_sampleToPerturb >= _position && _sampleToPerturb < _position + block.getNumSamples())
+            {
+                auto* sample = block.getChannelPointer (_channelToPerturb) + (_sampleToPerturb - _position);
+                *sample = std::nextafter (std::nextafter (std::nextafter (*sample, 2.0f), 2.0f), 2.0f);
+            }
+
+            _position += block.getNumSamples();
+        }
+
+    private:
+        size_t _sampleToPerturb;
+        size_t _channelToPerturb;
+        size_t _position = 0;
+    };
+
+    EquivalenceHarness::Config getConfig()
+    {
+        EquivalenceHarness::Config config;
+        config.seed = GENERATE (1, 2, 3);
+        config.spec.numChannels = static_cast<juce::uint32> (GENERATE (1, 2, 5));
+
+        return config;
+    }
+
+    template <typename Filter>
+    void automateCutoff (juce::Random& random, Filter& filter)
+    {
+        if (random.nextInt (4) == 0)
+            filter.setCutoffFrequency (20.0f * std::pow (1000.0f, random.nextFloat()), random.nextBool());
+    }
+} // namespace
+
+TEST_CASE ("Reference delay line matches juce::dsp::DelayLine<Linear>", "[EquivalenceHarness]")
+{
+    // the models' delay line stands in for the JUCE class, so it is held to the real one; delays stay
+    // in range, which JUCE asserts on
+    const auto check = [] (auto sampleType, size_t maximumDelayInSamples)
+    {
+        using SampleType = decltype (sampleType);
+
+        const size_t numChannels = 2;
+        juce::dsp::ProcessSpec spec{ 48000.0, 512, static_cast<juce::uint32> (numChannels) };
+
+        ReferenceModels::DelayLine<SampleType> model (maximumDelayInSamples);
+        juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::Linear> juceDelayLine (static_cast<int> (maximumDelayInSamples));
+
+        model.prepare (numChannels);
+        juceDelayLine.prepare (spec);
+
+        REQUIRE (model.getMaximumDelayInSamples() == static_cast<size_t> (juceDelayLine.getMaximumDelayInSamples()));
+
+        juce::Random random (static_cast<juce::int64> (maximumDelayInSamples) + 11);
+        const auto maxDelay = static_cast<float> (juceDelayLine.getMaximumDelayInSamples());
+
+        for (size_t i = 0; i < 10 * (maximumDelayInSamples + 2); i++)
+            for (size_t ch = 0; ch < numChannels; ch++)
+            {
+                const auto input = static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f);
+                model.pushSample (ch, input);
+                juceDelayLine.pushSample (static_cast<int> (ch), input);
+
+                const auto tapDelay = static_cast<SampleType> (maxDelay * random.nextFloat());
+                const auto mainDelay = static_cast<SampleType> (maxDelay * random.nextFloat());
+
+                REQUIRE (model.popSample (ch, tapDelay, false) == juceDelayLine.popSample (static_cast<int> (ch), tapDelay, false));
+                REQUIRE (model.popSample (ch, mainDelay) == juceDelayLine.popSample (static_cast<int> (ch), mainDelay));
+            }
+    };
+
+    for (const size_t maximumDelayInSamples : { 0, 1, 2, 3, 17, 1000 })
+    {
+        check (0.0f, maximumDelayInSamples);
+        check (0.0, maximumDelayInSamples);
+    }
+}
+
+TEST_CASE ("Test that the equivalence harness reports the first divergence", "[EquivalenceHarness]")
+{
+    EquivalenceHarness::Config config;
+    config.spec.numChannels = 3;
+    config.tolerance.maxErrorDecibels = -400.0;
+
+    TestHelpers::SimpleMultiplier reference (1.0f);
+    PerturbingProcessor perturbed (12345, 2);
+
+    auto divergence = EquivalenceHarness::run (reference, perturbed, config, [] (juce::Random&, auto&) {});
+
+    REQUIRE (divergence.found);
+    CHECK (divergence.sample == 12345);
+    CHECK (divergence.channel == 2);
+    CHECK (divergence.ulps == 3);
+
+    SECTION ("Within tolerance")
+    {
+        config.tolerance.maxUlps = 3;
+
+        divergence = EquivalenceHarness::run (reference, perturbed, config, [] (juce::Random&, auto&) {});
+
+        CHECK_FALSE (divergence.found);
+    }
+}
+
+TEST_CASE ("Test that getUlpDistance counts representable floats", "[EquivalenceHarness]")
+{
+    CHECK (EquivalenceHarness::getUlpDistance (1.0f, 1.0f) == 0);
+    CHECK (EquivalenceHarness::getUlpDistance (1.0f, std::nextafter (1.0f, 2.0f)) == 1);
+    CHECK (EquivalenceHarness::getUlpDistance (0.0f, -0.0f) == 0);
+    CHECK (EquivalenceHarness::getUlpDistance (std::numeric_limits<float>::denorm_min(), -std::numeric_limits<float>::denorm_min()) == 2);
+}
+
+TEST_CASE ("One pole filters match their reference models", "[EquivalenceHarness][OnePoleFilter]")
+{
+    auto config = getConfig();
+
+    SECTION ("Lowpass")
+    {
+        ReferenceModels::Lowpass<> reference;
+        OnePoleFilter::Lowpass<> optimised;
+
+        auto divergence = EquivalenceHarness::run (reference, optimised, config, [] (juce::Random& random, auto& filter) { automateCutoff (random, filter); });
+
+        INFO (EquivalenceHarness::toString (divergence));
+        CHECK_FALSE (divergence.found);
+    }
+
+    SECTION ("Highpass")
+    {
+        ReferenceModels::Highpass<> reference;
+        OnePoleFilter::Highpass<> optimised;
+
+        auto divergence = EquivalenceHarness::run (reference, optimised, config, [] (juce::Random& random, auto& filter) { automateCutoff (random, filter); });
+
+        INFO (EquivalenceHarness::toString (divergence));
+        CHECK_FALSE (divergence.found);
+    }
+}
+
+TEST_CASE ("Delay lines match their reference models", "[EquivalenceHarness][VariableDelayLine][VariableDelayAllpass]")
+{
+    auto config = getConfig();
+
+    const size_t maxDelayInSamples = 700;
+    const size_t numTaps = 3;
+
+    const auto automateDelays = [&] (juce::Random& random, auto& delayLine) {
+        for (size_t n = 0; n < numTaps; n++)
+            if (random.nextInt (4) == 0)
+                delayLine.setDelayInSamples (random.nextFloat() * (maxDelayInSamples - 1), n, random.nextBool());
+    };
+
+    SECTION ("VariableDelayLine")
+    {
+        ReferenceModels::VariableDelayLine<> reference (maxDelayInSamples, numTaps);
+        VariableDelayLine<> optimised (maxDelayInSamples, numTaps);
+
+        auto divergence = EquivalenceHarness::run (reference, optimised, config, automateDelays);
+
+        INFO (EquivalenceHarness::toString (divergence));
+        CHECK_FALSE (divergence.found);
+    }
+
+    SECTION ("VariableDelayAllpass")
+    {
+        ReferenceModels::VariableDelayAllpass<> reference (maxDelayInSamples, numTaps);
+        VariableDelayAllpass<> optimised (maxDelayInSamples, numTaps);
+
+        auto automate = [&] (juce::Random& random, auto& allpass) {
+            automateDelays (random, allpass);
+
+            if (random.nextInt (4) == 0)
+                allpass.setGain (1.9f * random.nextFloat() - 0.95f, random.nextBool());
+        };
+
+        auto divergence = EquivalenceHarness::run (reference, optimised, config, automate);
+
+        INFO (EquivalenceHarness::toString (divergence));
+        CHECK_FALSE (divergence.found);
+    }
+}
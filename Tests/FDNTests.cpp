@@ -0,0 +1,156 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    template <size_t N>
+    void checkMixingMatrixIsOrthogonal (typename FDN<N>::MixingMatrix matrix)
+    {
+        std::array<std::array<float, N>, N> columns;
+
+        for (size_t k = 0; k < N; k++)
+        {
+            columns[k].fill (0.0f);
+            columns[k][k] = 1.0f;
+
+            FDN<N>::applyMixingMatrix (matrix, columns[k]);
+        }
+
+        for (size_t a = 0; a < N; a++)
+            for (size_t b = 0; b < N; b++)
+            {
+                float dot = 0.0f;
+
+                for (size_t n = 0; n < N; n++)
+                    dot += columns[a][n] * columns[b][n];
+
+                CHECK_THAT (dot, Catch::Matchers::WithinAbs (a == b ? 1.0 : 0.0, 1e-6));
+            }
+    }
+
+    template <size_t N>
+    void checkImpulseResponseStartsAtShortestDelay()
+    {
+        juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+
+        FDN<N> fdn (1000);
+        fdn.prepare (spec);
+        fdn.setFeedback (0.5f, true);
+        fdn.setDampingFrequency (1.0e6f, true);
+
+        for (size_t n = 0; n < N; n++)
+            fdn.setDelayInSamples (100.0f + 37.0f * n, n, true);
+
+        auto impulseResponse = TestHelpers::impulseResponseGenerator (fdn, spec.numChannels, spec.maximumBlockSize);
+
+        for (auto ch = 0; ch < impulseResponse.getNumChannels(); ch++)
+        {
+            for (auto i = 0; i < 100; i++)
+                CHECK (impulseResponse.getSample (ch, i) == 0.0f);
+
+            CHECK_THAT (std::abs (impulseResponse.getSample (ch, 100)), Catch::Matchers::WithinAbs (1.0 / std::sqrt (N), 1e-6));
+        }
+    }
+
+    template <size_t N>
+    void checkDecayIsStable (typename FDN<N>::MixingMatrix matrix)
+    {
+        const juce::uint32 blockSize = 480;
+        juce::dsp::ProcessSpec spec{ 48000.0, blockSize, 2 };
+
+        FDN<N> fdn (4000);
+        fdn.setMixingMatrix (matrix);
+        fdn.prepare (spec);
+        fdn.setModulation (0.7f, 8.0f);
+        fdn.setFeedback (0.97f, true);
+        fdn.setDampingFrequency (6000.0f, true);
+
+        for (size_t n = 0; n < N; n++)
+            fdn.setDelayInSamples (1000.0f + 2500.0f * n / N, n, true);
+
+        juce::AudioBuffer<float> buffer (static_cast<int> (spec.numChannels), static_cast<int> (blockSize));
+        juce::Random random (42);
+
+        std::vector<double> energyPerSecond (10, 0.0);
+        bool isFinite = true;
+
+        // one second of noise, then nine seconds of tail
+        for (size_t block = 0; block < 1000; block++)
+        {
+            for (auto ch = 0; ch < buffer.getNumChannels(); ch++)
+                for (auto i = 0; i < buffer.getNumSamples(); i++)
+                    buffer.setSample (ch, i, block < 100 ? 2.0f * random.nextFloat() - 1.0f : 0.0f);
+
+            TestHelpers::runProcess (fdn, buffer);
+
+            for (auto ch = 0; ch < buffer.getNumChannels(); ch++)
+                for (auto i = 0; i < buffer.getNumSamples(); i++)
+                {
+                    const auto sample = buffer.getSample (ch, i);
+                    isFinite &= std::isfinite (sample);
+                    energyPerSecond[block / 100] += sample * sample;
+                }
+        }
+
+        CHECK (isFinite);
+
+        for (size_t second = 2; second < energyPerSecond.size(); second++)
+        {
+            CHECK (energyPerSecond[second] < energyPerSecond[second - 1]);
+            CHECK (energyPerSecond[second] > 0.0);
+        }
+    }
+} // namespace
+
+TEST_CASE ("FDN mixing matrices are orthogonal", "[FDN]")
+{
+    checkMixingMatrixIsOrthogonal<4> (FDN<4>::MixingMatrix::Hadamard);
+    checkMixingMatrixIsOrthogonal<8> (FDN<8>::MixingMatrix::Hadamard);
+    checkMixingMatrixIsOrthogonal<16> (FDN<16>::MixingMatrix::Hadamard);
+    checkMixingMatrixIsOrthogonal<4> (FDN<4>::MixingMatrix::Householder);
+    checkMixingMatrixIsOrthogonal<8> (FDN<8>::MixingMatrix::Householder);
+    checkMixingMatrixIsOrthogonal<16> (FDN<16>::MixingMatrix::Householder);
+}
+
+TEST_CASE ("FDN impulse response starts at the shortest delay", "[FDN]")
+{
+    checkImpulseResponseStartsAtShortestDelay<4>();
+    checkImpulseResponseStartsAtShortestDelay<8>();
+    checkImpulseResponseStartsAtShortestDelay<16>();
+}
+
+TEST_CASE ("FDN tail decays without blowing up under modulation", "[FDN]")
+{
+    checkDecayIsStable<4> (FDN<4>::MixingMatrix::Hadamard);
+    checkDecayIsStable<8> (FDN<8>::MixingMatrix::Householder);
+    checkDecayIsStable<16> (FDN<16>::MixingMatrix::Hadamard);
+}
+
+TEST_CASE ("FDN with double precision state matches the float response", "[FDN]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 2048, 2 };
+
+    FDN<8, float> floatFdn (1000);
+    FDN<8, double> doubleFdn (1000);
+
+    floatFdn.prepare (spec);
+    doubleFdn.prepare (spec);
+
+    floatFdn.setFeedback (0.8f, true);
+    doubleFdn.setFeedback (0.8, true);
+    floatFdn.setDampingFrequency (5000.0f, true);
+    doubleFdn.setDampingFrequency (5000.0, true);
+
+    for (size_t n = 0; n < 8; n++)
+    {
+        floatFdn.setDelayInSamples (101.0f + 53.0f * n, n, true);
+        doubleFdn.setDelayInSamples (101.0 + 53.0 * n, n, true);
+    }
+
+    auto floatResponse = TestHelpers::impulseResponseGenerator (floatFdn, spec.numChannels, spec.maximumBlockSize);
+    auto doubleResponse = TestHelpers::impulseResponseGenerator (doubleFdn, spec.numChannels, spec.maximumBlockSize);
+
+    for (auto ch = 0; ch < floatResponse.getNumChannels(); ch++)
+        for (auto i = 0; i < floatResponse.getNumSamples(); i++)
+            CHECK_THAT (doubleResponse.getSample (ch, i), Catch::Matchers::WithinAbs (floatResponse.getSample (ch, i), 1e-5));
+}
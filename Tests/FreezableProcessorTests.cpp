@@ -0,0 +1,195 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    class CountingAllpass : public VariableDelayAllpass<float>
+    {
+    public:
+        CountingAllpass (size_t& numCalls)
+            : VariableDelayAllpass<float> (64),
+              _numCalls (numCalls)
+        {
+        }
+
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            _numCalls++;
+            VariableDelayAllpass<float>::process (context);
+        }
+
+    private:
+        size_t& _numCalls;
+    };
+
+    std::unique_ptr<juce::dsp::ProcessorBase> makeAllpass (size_t& numCalls, const juce::dsp::ProcessSpec& spec)
+    {
+        auto allpass = std::make_unique<CountingAllpass> (numCalls);
+        allpass->prepare (spec);
+        allpass->setDelayInSamples (37.0f, 0, true);
+        allpass->setGain (0.5f, true);
+
+        return allpass;
+    }
+
+    juce::AudioBuffer<float> generateNoise (size_t numChannels, size_t numSamples, juce::int64 seed)
+    {
+        juce::Random random (seed);
+        juce::AudioBuffer<float> noise (static_cast<int> (numChannels), static_cast<int> (numSamples));
+
+        for (auto ch = 0; ch < noise.getNumChannels(); ch++)
+            for (auto i = 0; i < noise.getNumSamples(); i++)
+                noise.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+        return noise;
+    }
+
+    void processInBlocks (juce::dsp::ProcessorBase& processor, juce::AudioBuffer<float>& buffer, int start, int end, int blockSize)
+    {
+        for (auto i = start; i < end; i += blockSize)
+        {
+            auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock (static_cast<size_t> (i), static_cast<size_t> (juce::jmin (blockSize, end - i)));
+            processor.process (juce::dsp::ProcessContextReplacing<float> (block));
+        }
+    }
+
+    void checkBuffersMatch (const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected, int start, int end, double tolerance)
+    {
+        for (auto ch = 0; ch < expected.getNumChannels(); ch++)
+            for (auto i = start; i < end; i++)
+                if (std::abs (actual.getSample (ch, i) - expected.getSample (ch, i)) > tolerance)
+                {
+                    FAIL_CHECK ("channel " << ch << " sample " << i << ": " << actual.getSample (ch, i) << " != " << expected.getSample (ch, i));
+                    return;
+                }
+    }
+} // namespace
+
+TEST_CASE ("Partitioned convolver matches direct convolution", "[FreezableProcessor]")
+{
+    const size_t numChannels = 2;
+    const auto impulseResponse = generateNoise (numChannels, 1000, 1);
+    auto input = generateNoise (numChannels, 4096, 2);
+
+    for (const size_t partitionSize : { 1, 16, 64, 2048 })
+    {
+        PartitionedConvolver convolver (impulseResponse, numChannels, partitionSize);
+        juce::AudioBuffer<float> output (static_cast<int> (numChannels), input.getNumSamples());
+        juce::Random random (3);
+
+        for (auto i = 0; i < input.getNumSamples();)
+        {
+            const auto numSamples = juce::jmin (1 + random.nextInt (300), input.getNumSamples() - i);
+
+            convolver.process (juce::dsp::AudioBlock<float> (input).getSubBlock (static_cast<size_t> (i), static_cast<size_t> (numSamples)),
+                               juce::dsp::AudioBlock<float> (output).getSubBlock (static_cast<size_t> (i), static_cast<size_t> (numSamples)));
+            i += numSamples;
+        }
+
+        juce::AudioBuffer<float> expected (static_cast<int> (numChannels), input.getNumSamples());
+
+        for (auto ch = 0; ch < expected.getNumChannels(); ch++)
+            for (auto n = 0; n < expected.getNumSamples(); n++)
+            {
+                double sum = 0.0;
+
+                for (auto m = 0; m <= juce::jmin (n, impulseResponse.getNumSamples() - 1); m++)
+                    sum += static_cast<double> (impulseResponse.getSample (ch, m)) * input.getSample (ch, n - m);
+
+                expected.setSample (ch, n, static_cast<float> (sum));
+            }
+
+        checkBuffersMatch (output, expected, 0, expected.getNumSamples(), 1e-3);
+    }
+}
+
+TEST_CASE ("Freezing captures a trimmed impulse response", "[FreezableProcessor]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+    size_t numCalls = 0;
+
+    FreezableProcessor processor ([&] { return makeAllpass (numCalls, spec); }, 1 << 14, 64);
+    processor.prepare (spec);
+    processor.freeze();
+
+    CHECK (processor.isFrozen());
+
+    // every 37 samples the response is halved, -120 dB is reached after about 20 round trips
+    const auto& impulseResponse = processor.getImpulseResponse();
+    CHECK (impulseResponse.getNumChannels() == 2);
+    CHECK (impulseResponse.getNumSamples() > 37 * 18);
+    CHECK (impulseResponse.getNumSamples() < 37 * 22);
+
+    size_t referenceCalls = 0;
+    auto reference = makeAllpass (referenceCalls, spec);
+    auto expected = TestHelpers::impulseResponseGenerator (*reference, spec.numChannels, spec.maximumBlockSize);
+
+    checkBuffersMatch (impulseResponse, expected, 0, static_cast<int> (spec.maximumBlockSize), 1e-7);
+}
+
+TEST_CASE ("Frozen processor crossfades to the convolver without changing the output", "[FreezableProcessor]")
+{
+    const int blockSize = 256;
+    juce::dsp::ProcessSpec spec{ 48000.0, blockSize, 2 };
+    size_t numLiveCalls = 0;
+    size_t numReferenceCalls = 0;
+
+    FreezableProcessor processor ([&] { return makeAllpass (numLiveCalls, spec); }, 1 << 14, 128);
+    processor.setCrossfadeTime (0.01);
+    processor.prepare (spec);
+
+    auto reference = makeAllpass (numReferenceCalls, spec);
+
+    auto output = generateNoise (spec.numChannels, 48000, 4);
+    auto expected = output;
+    processInBlocks (*reference, expected, 0, expected.getNumSamples(), blockSize);
+
+    processInBlocks (processor, output, 0, 4096, blockSize);
+    processor.freeze();
+    processInBlocks (processor, output, 4096, 24000, blockSize);
+
+    // warm-up and crossfade are long done, so the live allpass should not run anymore
+    const auto numCallsBefore = numLiveCalls;
+    processInBlocks (processor, output, 24000, output.getNumSamples(), blockSize);
+    CHECK (numLiveCalls == numCallsBefore);
+
+    checkBuffersMatch (output, expected, 0, output.getNumSamples(), 1e-4);
+}
+
+TEST_CASE ("Unfreezing hands over to the live processor without cutting the tail", "[FreezableProcessor]")
+{
+    const int blockSize = 100;
+    juce::dsp::ProcessSpec spec{ 48000.0, blockSize, 2 };
+    size_t numLiveCalls = 0;
+    size_t numReferenceCalls = 0;
+
+    FreezableProcessor processor ([&] { return makeAllpass (numLiveCalls, spec); }, 1 << 14, 64);
+    processor.setCrossfadeTime (0.01);
+    processor.prepare (spec);
+    processor.freeze();
+
+    auto reference = makeAllpass (numReferenceCalls, spec);
+
+    auto output = generateNoise (spec.numChannels, 48000, 5);
+    auto expected = output;
+    processInBlocks (*reference, expected, 0, expected.getNumSamples(), blockSize);
+
+    processInBlocks (processor, output, 0, 10000, blockSize);
+    processor.unfreeze();
+
+    CHECK (! processor.isFrozen());
+
+    const auto numCallsBefore = numLiveCalls;
+    processInBlocks (processor, output, 10000, output.getNumSamples(), blockSize);
+    CHECK (numLiveCalls - numCallsBefore == (output.getNumSamples() - 10000) / blockSize);
+
+    // the convolver's tail and the live allpass, restarted from silence, add up to the reference
+    // through the handover
+    checkBuffersMatch (output, expected, 0, output.getNumSamples(), 1e-4);
+
+    // the retired convolver can be released and the processor frozen again
+    processor.releaseUnusedConvolvers();
+    processor.freeze();
+
+    CHECK (processor.isFrozen());
+}
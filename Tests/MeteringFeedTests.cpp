@@ -0,0 +1,250 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Test that the metering feed publishes decimated tap levels and delays", "[MeteringFeed]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 160, 2 };
+
+    MeteringFeed feed;
+    feed.prepare (spec.sampleRate, spec.numChannels, 2, 100.0); // a frame every 480 samples
+
+    VariableDelayLine<float> delayLine (1000, 2);
+    delayLine.prepare (spec);
+    delayLine.setDelayInSamples (10.0f, 0, true);
+    delayLine.setDelayInSamples (20.0f, 1, true);
+    delayLine.setMeteringFeed (&feed);
+
+    auto frame = feed.makeFrame();
+
+    for (int block = 0; block < 3; block++)
+    {
+        juce::AudioBuffer<float> buffer (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+            for (int i = 0; i < buffer.getNumSamples(); i++)
+                buffer.setSample (ch, i, 0.5f);
+
+        TestHelpers::runProcess (delayLine, buffer);
+
+        CHECK_FALSE (feed.pop (frame));
+        feed.endBlock (spec.maximumBlockSize);
+    }
+
+    REQUIRE (feed.pop (frame));
+    CHECK_FALSE (feed.pop (frame));
+
+    CHECK (frame.endSample == 480);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+    {
+        CHECK (frame.getPeak (ch, 0) == 0.5f);
+        CHECK (frame.getPeak (ch, 1) == 0.5f);
+        CHECK (frame.getDelayInSamples (ch, 0) == 10.0f);
+        CHECK (frame.getDelayInSamples (ch, 1) == 20.0f);
+
+        // silent for the first 10 and 20 samples of 480
+        CHECK_THAT (frame.getRms (ch, 0), Catch::Matchers::WithinRel (0.5 * std::sqrt (470.0 / 480.0), 1.0e-5));
+        CHECK_THAT (frame.getRms (ch, 1), Catch::Matchers::WithinRel (0.5 * std::sqrt (460.0 / 480.0), 1.0e-5));
+    }
+
+    // every frame starts from zero, here with only the tails of the delayed input
+    for (int block = 0; block < 3; block++)
+    {
+        juce::AudioBuffer<float> buffer (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+        buffer.clear();
+        TestHelpers::runProcess (delayLine, buffer);
+        feed.endBlock (spec.maximumBlockSize);
+    }
+
+    REQUIRE (feed.pop (frame));
+    CHECK (frame.endSample == 960);
+    CHECK (frame.getPeak (0, 1) == 0.5f);
+    CHECK_THAT (frame.getRms (0, 0), Catch::Matchers::WithinRel (0.5 * std::sqrt (10.0 / 480.0), 1.0e-5));
+    CHECK_THAT (frame.getRms (0, 1), Catch::Matchers::WithinRel (0.5 * std::sqrt (20.0 / 480.0), 1.0e-5));
+}
+
+TEST_CASE ("Test that processors sharing a metering feed report to their own taps", "[MeteringFeed]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 240, 1 };
+
+    MeteringFeed feed;
+    feed.prepare (spec.sampleRate, spec.numChannels, 3, 200.0); // a frame every 240 samples
+
+    VariableDelayLine<float> delayLine (1000, 2);
+    VariableDelayAllpass<float> allpass (1000);
+
+    delayLine.prepare (spec);
+    delayLine.setDelayInSamples (10.0f, 0, true);
+    delayLine.setDelayInSamples (20.0f, 1, true);
+    delayLine.setMeteringFeed (&feed);
+
+    allpass.prepare (spec);
+    allpass.setDelayInSamples (30.0f, 0, true);
+    allpass.setMeteringFeed (&feed, 2);
+
+    auto frame = feed.makeFrame();
+
+    CHECK (frame.numTaps == 3);
+    CHECK (frame.peak.size() == 3);
+
+    juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+    buffer.clear();
+    buffer.setSample (0, 0, 1.0f);
+
+    TestHelpers::runProcess (delayLine, buffer);
+    TestHelpers::runProcess (allpass, buffer);
+    feed.endBlock (spec.maximumBlockSize);
+
+    REQUIRE (feed.pop (frame));
+
+    CHECK (frame.getDelayInSamples (0, 0) == 10.0f);
+    CHECK (frame.getDelayInSamples (0, 1) == 20.0f);
+    CHECK (frame.getDelayInSamples (0, 2) == 30.0f);
+    CHECK (frame.getPeak (0, 0) == 1.0f);
+}
+
+TEST_CASE ("Test that a full metering feed drops frames instead of blocking", "[MeteringFeed]")
+{
+    MeteringFeed feed (4);
+    feed.prepare (1000.0, 1, 1, 1000.0); // a frame every sample
+
+    for (int i = 0; i < 10; i++)
+    {
+        const auto value = static_cast<float> (i);
+        feed.addTapBlock (0, 0, &value, 1);
+        feed.endBlock (1);
+    }
+
+    CHECK (feed.getNumDroppedFrames() == 6);
+
+    auto frame = feed.makeFrame();
+
+    REQUIRE (feed.pop (frame));
+    CHECK (frame.getPeak (0, 0) == 0.0f);
+
+    REQUIRE (feed.popLatest (frame));
+    CHECK (frame.getPeak (0, 0) == 3.0f);
+    CHECK (frame.endSample == 4);
+
+    CHECK_FALSE (feed.popLatest (frame));
+
+    // channels and taps the feed wasn't prepared for are ignored
+    const float value = 1.0f;
+    feed.addTapBlock (1, 0, &value, 1);
+    feed.addTapBlock (0, 1, &value, 1);
+    feed.setDelayInSamples (3, 3, 1.0f);
+    feed.endBlock (1);
+
+    REQUIRE (feed.pop (frame));
+    CHECK (frame.getPeak (0, 0) == 0.0f);
+}
+
+TEST_CASE ("Test that the metering feed reports the modulator output", "[MeteringFeed]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 1 };
+
+    MeteringFeed feed;
+    feed.prepare (spec.sampleRate, spec.numChannels, 1);
+
+    VariableDelayLine<float> delayLine (1000);
+    OscillatorWrapper oscillator;
+    ProcessorModulator<float> modulator (oscillator, 16);
+
+    float lastTarget = 0.0f;
+
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (delayLine);
+    modulator.setModulationTarget ([&] (float value) {
+        lastTarget = value;
+        delayLine.setDelayInSamples (value);
+    });
+    modulator.setModulationRange ({ 10.0f, 100.0f });
+    modulator.setModulationFrequency (2.0f);
+    modulator.setMeteringFeed (&feed);
+    delayLine.setMeteringFeed (&feed);
+
+    delayLine.prepare (spec);
+    modulator.prepare (spec);
+
+    auto frame = feed.makeFrame();
+    juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+
+    for (int block = 0; block < 100; block++)
+    {
+        buffer.clear();
+        TestHelpers::runProcess (modulator, buffer);
+        feed.endBlock (spec.maximumBlockSize);
+
+        if (feed.pop (frame))
+        {
+            CHECK (frame.modulation == lastTarget);
+            CHECK (frame.getDelayInSamples (0, 0) >= 10.0f);
+            CHECK (frame.getDelayInSamples (0, 0) <= 100.0f);
+        }
+    }
+}
+
+TEST_CASE ("Test that frames cross threads whole and in order", "[MeteringFeed]")
+{
+    MeteringFeed feed (8);
+    feed.prepare (1000.0, 2, 4, 1000.0);
+
+    const int numFrames = 20000;
+    std::atomic<bool> done{ false };
+    std::vector<std::string> errors;
+
+    std::thread reader ([&]
+    {
+        auto frame = feed.makeFrame();
+        juce::uint64 lastEndSample = 0;
+
+        for (;;)
+        {
+            // read before popping, so that once it is set the last frame is already in the feed
+            const auto finished = done.load();
+
+            if (! feed.pop (frame))
+            {
+                if (finished)
+                    break;
+
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (frame.endSample <= lastEndSample)
+                errors.push_back ("out of order");
+
+            lastEndSample = frame.endSample;
+
+            // every value of a frame was written for the same sample
+            const auto expected = static_cast<float> (frame.endSample);
+
+            for (size_t i = 0; i < frame.peak.size(); i++)
+                if (frame.peak[i] != expected || frame.delayInSamples[i] != expected || frame.modulation != expected)
+                    errors.push_back ("torn frame");
+        }
+    });
+
+    for (int i = 1; i <= numFrames; i++)
+    {
+        const auto value = static_cast<float> (i);
+
+        for (size_t ch = 0; ch < 2; ch++)
+        {
+            for (size_t tap = 0; tap < 4; tap++)
+            {
+                feed.addTapBlock (ch, tap, &value, 1);
+                feed.setDelayInSamples (ch, tap, value);
+            }
+        }
+
+        feed.setModulation (value);
+        feed.endBlock (1);
+    }
+
+    done = true;
+    reader.join();
+
+    CHECK (errors.empty());
+}
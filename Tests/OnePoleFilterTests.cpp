@@ -1,3 +1,4 @@
+#include "ParameterSweep.h"
 #include "TestHelpers.h"
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <shared_modules/shared_modules.h>
@@ -6,6 +7,8 @@ TEST_CASE ("One pole lowpass filter has correct frequency response for different
 {
     OnePoleFilter::Lowpass lowpassFilter;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const float fs)
     {
         juce::uint32 blockSize = 256;
@@ -22,8 +25,8 @@ TEST_CASE ("One pole lowpass filter has correct frequency response for different
         lowpassFilter.setCutoffFrequency (fc, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (lowpassFilter, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize, false);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
 
         // check result per channel for DC, fc, and last possible index
         for (size_t ch = 0; ch < spec.numChannels; ch++)
@@ -53,6 +56,8 @@ TEST_CASE ("One pole lowpass filter has correct frequency response for different
 
     size_t fftSize = spec.maximumBlockSize;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const size_t frequencyIndex)
     {
         float fc = frequencyIndex * spec.sampleRate / static_cast<float> (fftSize);
@@ -60,8 +65,8 @@ TEST_CASE ("One pole lowpass filter has correct frequency response for different
         lowpassFilter.setCutoffFrequency (fc, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (lowpassFilter, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize, false);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
 
         // check result per channel for DC, fc, and last possible index
         for (size_t ch = 0; ch < spec.numChannels; ch++)
@@ -82,6 +87,8 @@ TEST_CASE ("One pole highpass filter has correct frequency response for differen
 {
     OnePoleFilter::Highpass highpassFilter;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const float fs)
     {
         juce::uint32 blockSize = 256;
@@ -98,8 +105,8 @@ TEST_CASE ("One pole highpass filter has correct frequency response for differen
         highpassFilter.setCutoffFrequency (fc, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (highpassFilter, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize, false);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
 
         // check result per channel for DC, fc, and last possible index
         for (size_t ch = 0; ch < spec.numChannels; ch++)
@@ -129,6 +136,8 @@ TEST_CASE ("One pole highpass filter has correct frequency response for differen
 
     size_t fftSize = spec.maximumBlockSize;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const size_t frequencyIndex)
     {
         float fc = frequencyIndex * spec.sampleRate / static_cast<float> (fftSize);
@@ -136,8 +145,8 @@ TEST_CASE ("One pole highpass filter has correct frequency response for differen
         highpassFilter.setCutoffFrequency (fc, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (highpassFilter, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize, false);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
 
         // check result per channel for DC, fc, and last possible index
         for (size_t ch = 0; ch < spec.numChannels; ch++)
@@ -153,3 +162,191 @@ TEST_CASE ("One pole highpass filter has correct frequency response for differen
     for (auto& f : frequencyIndices)
         runTest (f);
 }
+
+TEST_CASE ("One pole filters with double precision state match the float response", "[OnePoleFilter]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+
+    OnePoleFilter::Lowpass<float> floatLowpass;
+    OnePoleFilter::Lowpass<double> doubleLowpass;
+    OnePoleFilter::Highpass<float> floatHighpass;
+    OnePoleFilter::Highpass<double> doubleHighpass;
+
+    floatLowpass.prepare (spec);
+    doubleLowpass.prepare (spec);
+    floatHighpass.prepare (spec);
+    doubleHighpass.prepare (spec);
+
+    floatLowpass.setCutoffFrequency (1000.0f, true);
+    doubleLowpass.setCutoffFrequency (1000.0, true);
+    floatHighpass.setCutoffFrequency (1000.0f, true);
+    doubleHighpass.setCutoffFrequency (1000.0, true);
+
+    auto floatLowpassResponse = TestHelpers::impulseResponseGenerator (floatLowpass, spec.numChannels, spec.maximumBlockSize);
+    auto floatHighpassResponse = TestHelpers::impulseResponseGenerator (floatHighpass, spec.numChannels, spec.maximumBlockSize);
+
+    // float I/O through double state, and double I/O
+    auto mixedLowpassResponse = TestHelpers::impulseResponseGenerator (doubleLowpass, spec.numChannels, spec.maximumBlockSize);
+
+    juce::AudioBuffer<double> doubleHighpassResponse (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    doubleHighpassResponse.clear();
+
+    for (auto ch = 0; ch < doubleHighpassResponse.getNumChannels(); ch++)
+        doubleHighpassResponse.setSample (ch, 0, 1.0);
+
+    TestHelpers::runProcess (doubleHighpass, doubleHighpassResponse);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+        for (size_t i = 0; i < spec.maximumBlockSize; i++)
+        {
+            CHECK_THAT (mixedLowpassResponse.getSample (ch, i), Catch::Matchers::WithinAbs (floatLowpassResponse.getSample (ch, i), 1e-6));
+            CHECK_THAT (doubleHighpassResponse.getSample (ch, i), Catch::Matchers::WithinAbs (floatHighpassResponse.getSample (ch, i), 1e-6));
+        }
+}
+
+TEST_CASE ("One pole filters match the analytic response across a parameter sweep", "[OnePoleFilter][ParameterSweep]")
+{
+    const size_t fftSize = 4096;
+    const juce::uint32 numChannels = 2;
+
+    ParameterSweep::Grid grid;
+    grid.sampleRates = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+    grid.cutoffFrequencies = { 200.0, 500.0, 1000.0, 4000.0, 10000.0, 20000.0 };
+    grid.blockSizes = { 1, 16, 64, 333, 4096 };
+
+    // compares against |H(e^jw)| of the difference equations, over the bins above -60 dB
+    const auto makeCheck = [&] (bool isHighpass) {
+        return [=] (auto& filter, const ParameterSweep::Point& point, TestHelpers::FrequencyResponseAnalyser& analyser) -> std::string {
+            filter.prepare ({ point.sampleRate, point.blockSize, numChannels });
+            filter.setCutoffFrequency (static_cast<float> (point.cutoffFrequency), true);
+
+            auto impulseResponse = ParameterSweep::getImpulseResponse (filter, numChannels, fftSize, point.blockSize);
+            analyser.analyse (impulseResponse, fftSize, false);
+
+            const auto& magnitudeResponse = analyser.getMagnitudeResponse();
+            const auto alpha = std::exp (-2.0 * M_PI * point.cutoffFrequency / point.sampleRate);
+
+            for (size_t ch = 0; ch < numChannels; ch++)
+                for (size_t i = 0; i < fftSize / 2; i++)
+                {
+                    const auto z = std::polar (1.0, -2.0 * M_PI * static_cast<double> (i) / fftSize);
+                    const auto expected = isHighpass ? std::abs ((1.0 + alpha) / 2.0 * (1.0 - z) / (1.0 - alpha * z))
+                                                     : std::abs ((1.0 - alpha) / (1.0 - alpha * z));
+
+                    const auto expectedDecibels = juce::Decibels::gainToDecibels (expected, -200.0);
+                    const auto actualDecibels = juce::Decibels::gainToDecibels (static_cast<double> (magnitudeResponse.getSample (ch, i)), -200.0);
+
+                    if (expectedDecibels > -60.0 && std::abs (actualDecibels - expectedDecibels) > 1e-2)
+                        return "channel " + std::to_string (ch) + ", bin " + std::to_string (i) + ": " + std::to_string (actualDecibels)
+                               + " dB, expected " + std::to_string (expectedDecibels) + " dB";
+                }
+
+            return {};
+        };
+    };
+
+    SECTION ("Lowpass")
+    {
+        const auto makeLowpass = [] { return std::make_unique<OnePoleFilter::Lowpass<>>(); };
+        ParameterSweep::requireNoFailures (ParameterSweep::run (grid, makeLowpass, makeCheck (false)));
+    }
+
+    SECTION ("Highpass")
+    {
+        const auto makeHighpass = [] { return std::make_unique<OnePoleFilter::Highpass<>>(); };
+        ParameterSweep::requireNoFailures (ParameterSweep::run (grid, makeHighpass, makeCheck (true)));
+    }
+}
+
+TEST_CASE ("One pole filters keep their cutoff when re-prepared at another sample rate", "[OnePoleFilter]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+    juce::dsp::ProcessSpec newSpec{ 96000.0, 256, 2 };
+
+    OnePoleFilter::Lowpass lowpass;
+    OnePoleFilter::Highpass highpass;
+    lowpass.prepare (spec);
+    highpass.prepare (spec);
+    lowpass.setCutoffFrequency (1000.0f, true);
+    highpass.setCutoffFrequency (1000.0f, true);
+    lowpass.prepare (newSpec);
+    highpass.prepare (newSpec);
+
+    OnePoleFilter::Lowpass freshLowpass;
+    OnePoleFilter::Highpass freshHighpass;
+    freshLowpass.prepare (newSpec);
+    freshHighpass.prepare (newSpec);
+    freshLowpass.setCutoffFrequency (1000.0f, true);
+    freshHighpass.setCutoffFrequency (1000.0f, true);
+
+    const auto lowpassResponse = TestHelpers::impulseResponseGenerator (lowpass, newSpec.numChannels, newSpec.maximumBlockSize);
+    const auto highpassResponse = TestHelpers::impulseResponseGenerator (highpass, newSpec.numChannels, newSpec.maximumBlockSize);
+    const auto freshLowpassResponse = TestHelpers::impulseResponseGenerator (freshLowpass, newSpec.numChannels, newSpec.maximumBlockSize);
+    const auto freshHighpassResponse = TestHelpers::impulseResponseGenerator (freshHighpass, newSpec.numChannels, newSpec.maximumBlockSize);
+
+    for (auto ch = 0; ch < lowpassResponse.getNumChannels(); ch++)
+        for (auto i = 0; i < lowpassResponse.getNumSamples(); i++)
+        {
+            CHECK (lowpassResponse.getSample (ch, i) == freshLowpassResponse.getSample (ch, i));
+            CHECK (highpassResponse.getSample (ch, i) == freshHighpassResponse.getSample (ch, i));
+        }
+}
+
+namespace
+{
+    template <typename SampleType>
+    void checkBlockScanMatchesSerialFilter (double tolerance)
+    {
+        // odd block sizes leave a few samples past the last full step of eight
+        for (const juce::uint32 numChannels : { 1u, 2u })
+            for (const size_t blockSize : { 5, 64, 509 })
+            {
+                const juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32> (blockSize), numChannels };
+
+                OnePoleFilter::Lowpass<SampleType> serial;
+                OnePoleFilter::Lowpass<SampleType> scan;
+
+                serial.prepare (spec);
+                scan.prepare (spec);
+                scan.setBlockScan (true);
+
+                juce::Random random (static_cast<juce::int64> (blockSize));
+                juce::AudioBuffer<SampleType> expected (static_cast<int> (numChannels), static_cast<int> (blockSize));
+                juce::AudioBuffer<SampleType> actual (static_cast<int> (numChannels), static_cast<int> (blockSize));
+
+                for (int block = 0; block < 400; block++)
+                {
+                    // settled cutoffs from 20 Hz to 20 kHz, and every so often a ramp through the serial path
+                    if (block % 40 == 0)
+                    {
+                        const auto cutoff = static_cast<SampleType> (20.0 * std::pow (1000.0, random.nextDouble()));
+                        const auto force = block % 80 == 0;
+
+                        serial.setCutoffFrequency (cutoff, force);
+                        scan.setCutoffFrequency (cutoff, force);
+                    }
+
+                    for (int ch = 0; ch < expected.getNumChannels(); ch++)
+                        for (int i = 0; i < expected.getNumSamples(); i++)
+                        {
+                            const auto input = static_cast<SampleType> (2.0 * random.nextDouble() - 1.0);
+                            expected.setSample (ch, i, input);
+                            actual.setSample (ch, i, input);
+                        }
+
+                    TestHelpers::runProcess (serial, expected);
+                    TestHelpers::runProcess (scan, actual);
+
+                    for (int ch = 0; ch < expected.getNumChannels(); ch++)
+                        for (int i = 0; i < expected.getNumSamples(); i++)
+                            REQUIRE_THAT (actual.getSample (ch, i), Catch::Matchers::WithinAbs (expected.getSample (ch, i), tolerance));
+                }
+            }
+    }
+} // namespace
+
+TEST_CASE ("One pole lowpass block scan matches the serial filter", "[OnePoleFilter]")
+{
+    checkBlockScanMatchesSerialFilter<float> (1.0e-5);
+    checkBlockScanMatchesSerialFilter<double> (1.0e-13);
+}
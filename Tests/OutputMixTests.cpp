@@ -0,0 +1,406 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 480, 2 };
+
+    template <typename SampleType>
+    void fillWithNoise (juce::Random& random, juce::AudioBuffer<SampleType>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+            for (int i = 0; i < buffer.getNumSamples(); i++)
+                buffer.setSample (ch, i, static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f));
+    }
+
+    template <typename SampleType>
+    void processOutOfPlace (MultiPrecisionProcessor& processor, juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output)
+    {
+        juce::dsp::AudioBlock<SampleType> inputBlock (input);
+        juce::dsp::AudioBlock<SampleType> outputBlock (output);
+
+        processor.process (juce::dsp::ProcessContextNonReplacing<SampleType> (inputBlock, outputBlock));
+    }
+
+    // setParameters (processor, blockIndex) is called before every block, so later blocks can ramp
+    template <typename SampleType, typename Processor, typename SetParameters>
+    void checkOutOfPlaceMatchesInPlace (Processor& inPlace, Processor& outOfPlace, SetParameters setParameters)
+    {
+        inPlace.prepare (spec);
+        outOfPlace.prepare (spec);
+
+        juce::Random random (3);
+        juce::AudioBuffer<SampleType> input (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+        juce::AudioBuffer<SampleType> inPlaceBuffer;
+        juce::AudioBuffer<SampleType> inputCopy;
+        juce::AudioBuffer<SampleType> output (input.getNumChannels(), input.getNumSamples());
+
+        for (int block = 0; block < 6; block++)
+        {
+            setParameters (inPlace, block);
+            setParameters (outOfPlace, block);
+
+            fillWithNoise (random, input);
+            inPlaceBuffer.makeCopyOf (input);
+            inputCopy.makeCopyOf (input);
+            output.clear();
+
+            TestHelpers::runProcess (inPlace, inPlaceBuffer);
+            processOutOfPlace (outOfPlace, input, output);
+
+            for (int ch = 0; ch < input.getNumChannels(); ch++)
+                for (int i = 0; i < input.getNumSamples(); i++)
+                {
+                    if (input.getSample (ch, i) != inputCopy.getSample (ch, i))
+                    {
+                        FAIL_CHECK ("block " << block << " channel " << ch << " sample " << i << ": the input was modified");
+                        return;
+                    }
+
+                    if (output.getSample (ch, i) != inPlaceBuffer.getSample (ch, i))
+                    {
+                        FAIL_CHECK ("block " << block << " channel " << ch << " sample " << i << ": " << output.getSample (ch, i) << " != " << inPlaceBuffer.getSample (ch, i));
+                        return;
+                    }
+                }
+        }
+    }
+
+    template <typename SampleType>
+    void checkProcessors()
+    {
+        SECTION ("VariableDelayLine")
+        {
+            VariableDelayLine<SampleType> inPlace (1000, 2);
+            VariableDelayLine<SampleType> outOfPlace (1000, 2);
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       {
+                                                           processor.setDelayInSamples (static_cast<SampleType> (100 + 150 * block), 0, block == 0);
+                                                           processor.setDelayInSamples (static_cast<SampleType> (30.5), 1, true);
+                                                       });
+        }
+
+        SECTION ("VariableDelayAllpass")
+        {
+            VariableDelayAllpass<SampleType> inPlace (1000);
+            VariableDelayAllpass<SampleType> outOfPlace (1000);
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       {
+                                                           processor.setDelayInSamples (static_cast<SampleType> (block < 3 ? 141.5 : 0.5), 0, block == 0);
+                                                           processor.setGain (static_cast<SampleType> (block < 2 ? 0.6 : -0.4), block == 0);
+                                                       });
+        }
+
+        SECTION ("Lowpass")
+        {
+            OnePoleFilter::Lowpass<SampleType> inPlace;
+            OnePoleFilter::Lowpass<SampleType> outOfPlace;
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       { processor.setCutoffFrequency (static_cast<SampleType> (block < 3 ? 2000 : 9000), block == 0); });
+        }
+
+        SECTION ("Highpass")
+        {
+            OnePoleFilter::Highpass<SampleType> inPlace;
+            OnePoleFilter::Highpass<SampleType> outOfPlace;
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       { processor.setCutoffFrequency (static_cast<SampleType> (block < 3 ? 200 : 900), block == 0); });
+        }
+
+        SECTION ("FDN")
+        {
+            FDN<4, SampleType> inPlace (2000);
+            FDN<4, SampleType> outOfPlace (2000);
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       {
+                                                           if (block == 0)
+                                                               processor.setParameters ({ { 443, 577, 829, 1117 }, static_cast<SampleType> (0.8), 6000, 0.7f, 12 }, true);
+                                                       });
+        }
+
+        SECTION ("Batched lowpass")
+        {
+            Batched::Lowpass<SampleType> inPlace (2);
+            Batched::Lowpass<SampleType> outOfPlace (2);
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto& processor, int block)
+                                                       {
+                                                           processor.setCutoffFrequency (0, static_cast<SampleType> (block < 3 ? 1000 : 5000), block == 0);
+                                                           processor.setCutoffFrequency (1, static_cast<SampleType> (3000), block == 0);
+                                                       });
+        }
+
+        SECTION ("Modulated delay in a tiled chain")
+        {
+            struct Modulated : public MultiPrecisionProcessor
+            {
+                Modulated()
+                    : modulator (oscillator, 100)
+                {
+                    oscillator.setWaveform (OscillatorWrapper::Sine);
+                    modulator.setProcessorToModulate (delayLine);
+                    modulator.setModulationTarget ([this] (SampleType value) { delayLine.setDelayInSamples (value); });
+                    modulator.setModulationRange ({ static_cast<SampleType> (100), static_cast<SampleType> (300) });
+                    modulator.setModulationFrequency (3.0f);
+
+                    chain.addProcessor (modulator);
+                    chain.addProcessor (allpass);
+                }
+
+                virtual void prepare (const juce::dsp::ProcessSpec& newSpec) override
+                {
+                    delayLine.prepare (newSpec);
+                    chain.prepare (newSpec);
+                    delayLine.setDelayInSamples (static_cast<SampleType> (200), 0, true);
+                    allpass.setDelayInSamples (static_cast<SampleType> (141.5), 0, true);
+                    allpass.setGain (static_cast<SampleType> (0.6), true);
+                }
+                virtual void reset() override
+                {
+                }
+
+                using MultiPrecisionProcessor::process;
+
+                virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+                {
+                    chain.process (context);
+                }
+                virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override
+                {
+                    chain.process (context);
+                }
+                virtual void process (const juce::dsp::ProcessContextNonReplacing<float>& context) override
+                {
+                    chain.process (context);
+                }
+                virtual void process (const juce::dsp::ProcessContextNonReplacing<double>& context) override
+                {
+                    chain.process (context);
+                }
+
+                VariableDelayLine<SampleType> delayLine{ 1000 };
+                OscillatorWrapper oscillator;
+                ProcessorModulator<SampleType> modulator;
+                VariableDelayAllpass<SampleType> allpass{ 400 };
+                TiledChain chain{ 128 };
+            };
+
+            Modulated inPlace;
+            Modulated outOfPlace;
+
+            checkOutOfPlaceMatchesInPlace<SampleType> (inPlace, outOfPlace, [] (auto&, int) {});
+        }
+    }
+
+    // the same levels smoothed sample by sample, as a separate mixing pass would do it
+    template <typename SampleType>
+    struct ReferenceMix
+    {
+        ReferenceMix()
+        {
+            dryGain.reset (spec.sampleRate, 0.05);
+            wetGain.reset (spec.sampleRate, 0.05);
+            wetGain.setCurrentAndTargetValue (1);
+        }
+
+        void setLevels (SampleType dry, SampleType wet, SampleType gain, bool force)
+        {
+            if (force)
+            {
+                dryGain.setCurrentAndTargetValue (dry * gain);
+                wetGain.setCurrentAndTargetValue (wet * gain);
+            }
+            else
+            {
+                dryGain.setTargetValue (dry * gain);
+                wetGain.setTargetValue (wet * gain);
+            }
+        }
+
+        juce::LinearSmoothedValue<SampleType> dryGain;
+        juce::LinearSmoothedValue<SampleType> wetGain;
+    };
+
+    // setParameters (processor) is called once both are prepared
+    template <typename SampleType, typename Processor, typename SetParameters>
+    void checkFusedMixMatchesSeparateMix (Processor& fused, Processor& wetOnly, bool outOfPlace, SetParameters setParameters)
+    {
+        fused.prepare (spec);
+        wetOnly.prepare (spec);
+        setParameters (fused);
+        setParameters (wetOnly);
+
+        ReferenceMix<SampleType> reference;
+        juce::Random random (11);
+        juce::AudioBuffer<SampleType> input (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+        juce::AudioBuffer<SampleType> wet;
+        juce::AudioBuffer<SampleType> output (input.getNumChannels(), input.getNumSamples());
+
+        const auto setLevels = [&] (SampleType dry, SampleType wetLevel, SampleType gain, bool force)
+        {
+            fused.getOutputMix().setDryLevel (dry, force);
+            fused.getOutputMix().setWetLevel (wetLevel, force);
+            fused.getOutputMix().setOutputGain (gain, force);
+            reference.setLevels (dry, wetLevel, gain, force);
+        };
+
+        setLevels (static_cast<SampleType> (0.3), static_cast<SampleType> (0.7), static_cast<SampleType> (0.5), true);
+
+        // the reference accumulates its steps, the block ramps compute every value from the start
+        const auto tolerance = static_cast<SampleType> (std::is_same_v<SampleType, float> ? 1.0e-4 : 1.0e-9);
+
+        // 2400 samples of ramp are five whole blocks, which the block ramps follow exactly
+        for (int block = 0; block < 8; block++)
+        {
+            if (block == 2)
+                setLevels (static_cast<SampleType> (1), static_cast<SampleType> (0.25), static_cast<SampleType> (2), false);
+
+            fillWithNoise (random, input);
+            wet.makeCopyOf (input);
+
+            TestHelpers::runProcess (wetOnly, wet);
+
+            if (outOfPlace)
+            {
+                processOutOfPlace (fused, input, output);
+            }
+            else
+            {
+                output.makeCopyOf (input);
+                TestHelpers::runProcess (fused, output);
+            }
+
+            std::vector<SampleType> dryGains;
+            std::vector<SampleType> wetGains;
+
+            for (int i = 0; i < input.getNumSamples(); i++)
+            {
+                dryGains.push_back (reference.dryGain.getNextValue());
+                wetGains.push_back (reference.wetGain.getNextValue());
+            }
+
+            for (int ch = 0; ch < input.getNumChannels(); ch++)
+                for (int i = 0; i < input.getNumSamples(); i++)
+                {
+                    const auto expected = dryGains[static_cast<size_t> (i)] * input.getSample (ch, i) + wetGains[static_cast<size_t> (i)] * wet.getSample (ch, i);
+
+                    if (std::abs (output.getSample (ch, i) - expected) > tolerance)
+                    {
+                        FAIL_CHECK ("block " << block << " channel " << ch << " sample " << i << ": " << output.getSample (ch, i) << " != " << expected);
+                        return;
+                    }
+                }
+        }
+    }
+
+    template <typename SampleType>
+    void checkMixes (bool outOfPlace)
+    {
+        SECTION ("VariableDelayLine")
+        {
+            VariableDelayLine<SampleType> fused (1000);
+            VariableDelayLine<SampleType> wetOnly (1000);
+
+            checkFusedMixMatchesSeparateMix<SampleType> (fused, wetOnly, outOfPlace, [] (auto& processor)
+                                                         { processor.setDelayInSamples (static_cast<SampleType> (50.5), 0, true); });
+        }
+
+        SECTION ("VariableDelayAllpass")
+        {
+            VariableDelayAllpass<SampleType> fused (1000);
+            VariableDelayAllpass<SampleType> wetOnly (1000);
+
+            checkFusedMixMatchesSeparateMix<SampleType> (fused, wetOnly, outOfPlace, [] (auto& processor)
+                                                         {
+                                                             processor.setDelayInSamples (static_cast<SampleType> (141.5), 0, true);
+                                                             processor.setGain (static_cast<SampleType> (0.5), true);
+                                                         });
+        }
+
+        SECTION ("Lowpass")
+        {
+            OnePoleFilter::Lowpass<SampleType> fused;
+            OnePoleFilter::Lowpass<SampleType> wetOnly;
+
+            checkFusedMixMatchesSeparateMix<SampleType> (fused, wetOnly, outOfPlace, [] (auto& processor)
+                                                         { processor.setCutoffFrequency (static_cast<SampleType> (2000), true); });
+        }
+
+        SECTION ("Highpass")
+        {
+            OnePoleFilter::Highpass<SampleType> fused;
+            OnePoleFilter::Highpass<SampleType> wetOnly;
+
+            checkFusedMixMatchesSeparateMix<SampleType> (fused, wetOnly, outOfPlace, [] (auto& processor)
+                                                         { processor.setCutoffFrequency (static_cast<SampleType> (500), true); });
+        }
+
+        SECTION ("FDN")
+        {
+            FDN<8, SampleType> fused (2000);
+            FDN<8, SampleType> wetOnly (2000);
+
+            checkFusedMixMatchesSeparateMix<SampleType> (fused, wetOnly, outOfPlace, [] (auto& processor)
+                                                         { processor.setFeedback (static_cast<SampleType> (0.7), true); });
+        }
+    }
+} // namespace
+
+TEST_CASE ("Out of place processing matches in place processing", "[OutputMix]")
+{
+    SECTION ("Float")
+    {
+        checkProcessors<float>();
+    }
+
+    SECTION ("Double")
+    {
+        checkProcessors<double>();
+    }
+}
+
+TEST_CASE ("Fused output mixes match a separate mixing pass", "[OutputMix]")
+{
+    const auto outOfPlace = GENERATE (false, true);
+
+    SECTION ("Float")
+    {
+        checkMixes<float> (outOfPlace);
+    }
+
+    SECTION ("Double")
+    {
+        checkMixes<double> (outOfPlace);
+    }
+}
+
+TEST_CASE ("Output mixes at their defaults leave the output untouched", "[OutputMix]")
+{
+    OutputMix<float> mix;
+    mix.prepare (spec.sampleRate);
+    mix.beginBlock (4);
+
+    CHECK_FALSE (mix.isActive());
+
+    const std::array<float, 4> dry{ 1.0f, 2.0f, 3.0f, 4.0f };
+    const std::array<float, 4> wet{ 0.1f, -0.2f, 0.3f, -0.4f };
+    std::array<float, 4> out{};
+
+    mix.write (dry.data(), wet.data(), out.data(), 0, out.size());
+    CHECK (out == wet);
+
+    // a level left back at its default keeps the stage active until its ramp is over
+    mix.setDryLevel (0.5f);
+    mix.setDryLevel (0.0f);
+    mix.beginBlock (4);
+    CHECK (mix.isActive());
+
+    mix.beginBlock (static_cast<size_t> (spec.sampleRate));
+    mix.beginBlock (4);
+    CHECK_FALSE (mix.isActive());
+}
@@ -0,0 +1,155 @@
+#include "RealtimeSafetyChecker.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+#include <thread>
+
+namespace
+{
+    struct TestSnapshot
+    {
+        int a = 0;
+        int b = 0;
+    };
+
+    struct AllpassPreset
+    {
+        VariableDelayAllpass<>::Parameters allpass;
+        OnePoleFilter::Lowpass<>::Parameters lowpass;
+    };
+} // namespace
+
+TEST_CASE ("Test acquire returns nothing until a snapshot is published", "[ParameterSnapshot]")
+{
+    ParameterSnapshot<TestSnapshot> snapshot ({ 1, 2 });
+
+    CHECK (snapshot.acquire() == nullptr);
+    CHECK (snapshot.getCurrentSnapshot().a == 1);
+    CHECK (snapshot.getCurrentSnapshot().b == 2);
+
+    snapshot.publish ({ 3, 4 });
+
+    auto* acquired = snapshot.acquire();
+    REQUIRE (acquired != nullptr);
+    CHECK (acquired->a == 3);
+    CHECK (acquired->b == 4);
+
+    CHECK (snapshot.acquire() == nullptr);
+    CHECK (snapshot.getCurrentSnapshot().a == 3);
+}
+
+TEST_CASE ("Test acquire returns the latest of several published snapshots", "[ParameterSnapshot]")
+{
+    ParameterSnapshot<TestSnapshot> snapshot;
+
+    for (int i = 1; i <= 5; i++)
+    {
+        snapshot.getWriteSnapshot().a = i;
+        snapshot.publish();
+    }
+
+    auto* acquired = snapshot.acquire();
+    REQUIRE (acquired != nullptr);
+    CHECK (acquired->a == 5);
+
+    // the write snapshot starts from the last published one, so single fields can be edited
+    snapshot.getWriteSnapshot().b = 7;
+    snapshot.publish();
+
+    acquired = snapshot.acquire();
+    REQUIRE (acquired != nullptr);
+    CHECK (acquired->a == 5);
+    CHECK (acquired->b == 7);
+}
+
+TEST_CASE ("Test snapshots are never torn under concurrent publishing", "[ParameterSnapshot]")
+{
+    ParameterSnapshot<TestSnapshot> snapshot;
+    std::atomic<bool> isDone{ false };
+    constexpr int numSnapshots = 200000;
+
+    std::thread writer ([&] {
+        for (int i = 1; i <= numSnapshots; i++)
+            snapshot.publish ({ i, 2 * i });
+
+        isDone = true;
+    });
+
+    int previous = 0;
+    bool isConsistent = true;
+    bool isMonotonic = true;
+
+    while (! isDone || previous != numSnapshots)
+    {
+        if (auto* acquired = snapshot.acquire())
+        {
+            isConsistent &= acquired->b == 2 * acquired->a;
+            isMonotonic &= acquired->a > previous;
+            previous = acquired->a;
+        }
+    }
+
+    writer.join();
+
+    CHECK (isConsistent);
+    CHECK (isMonotonic);
+    CHECK (previous == numSnapshots);
+}
+
+TEST_CASE ("Test setParameters matches the individual setters", "[ParameterSnapshot]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+
+    VariableDelayAllpass expected (100, 3);
+    VariableDelayAllpass actual (100, 3);
+    expected.prepare (spec);
+    actual.prepare (spec);
+
+    VariableDelayAllpass<>::Parameters parameters{ { 10.0f, 20.5f, 30.0f }, 0.5f };
+
+    for (size_t n = 0; n < 3; n++)
+        expected.setDelayInSamples (parameters.delayInSamples[n], n);
+
+    expected.setGain (parameters.gain);
+    actual.setParameters (parameters);
+
+    auto expectedBuffer = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+    auto actualBuffer = expectedBuffer;
+
+    TestHelpers::runProcess (expected, expectedBuffer);
+    TestHelpers::runProcess (actual, actualBuffer);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+        for (size_t n = 0; n < 3; n++)
+            for (size_t i = 0; i < spec.maximumBlockSize; i++)
+                CHECK (actual.getTapOutBuffer (ch, n)[i] == expected.getTapOutBuffer (ch, n)[i]);
+}
+
+TEST_CASE ("Test publishing and applying a snapshot is realtime safe", "[ParameterSnapshot][RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    VariableDelayAllpass allpass (1000, 3);
+    OnePoleFilter::Lowpass lowpass;
+    allpass.prepare (spec);
+    lowpass.prepare (spec);
+
+    ParameterSnapshot<AllpassPreset> presets ({ { { 100.0f, 200.0f, 300.0f }, 0.5f }, { 1000.0f } });
+
+    // building and publishing a whole snapshot may not allocate either, so the writer can be a
+    // realtime thread too
+    RealtimeSafety::ScopedRealtimeCheck check;
+
+    presets.publish ({ { { 150.0f, 250.0f, 300.0f }, 0.7f }, { 2000.0f } });
+
+    if (auto* preset = presets.acquire())
+    {
+        allpass.setParameters (preset->allpass);
+        lowpass.setParameters (preset->lowpass);
+    }
+
+    for (auto& violation : check.getViolations())
+        FAIL_CHECK (RealtimeSafety::toString (violation));
+
+    CHECK (presets.getCurrentSnapshot().allpass.gain == 0.7f);
+    CHECK (presets.getCurrentSnapshot().allpass.delayInSamples[2] == 300.0f);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "TestHelpers.h"
+#include <sstream>
+#include <thread>
+
+namespace ParameterSweep
+{
+    struct Point
+    {
+        double sampleRate;
+        double cutoffFrequency;
+        double delayInSamples;
+        double gain;
+        juce::uint32 blockSize;
+    };
+
+    // Every combination of the axis values is one grid point. Axes a processor doesn't use keep
+    // their single default value.
+    struct Grid
+    {
+        std::vector<double> sampleRates{ 48000.0 };
+        std::vector<double> cutoffFrequencies{ 1000.0 };
+        std::vector<double> delaysInSamples{ 1.0 };
+        std::vector<double> gains{ 0.0 };
+        std::vector<juce::uint32> blockSizes{ 256 };
+
+        size_t getNumPoints() const
+        {
+            return sampleRates.size() * cutoffFrequencies.size() * delaysInSamples.size() * gains.size() * blockSizes.size();
+        }
+
+        Point getPoint (size_t index) const
+        {
+            Point point;
+
+            point.blockSize = blockSizes[index % blockSizes.size()];
+            index /= blockSizes.size();
+            point.gain = gains[index % gains.size()];
+            index /= gains.size();
+            point.delayInSamples = delaysInSamples[index % delaysInSamples.size()];
+            index /= delaysInSamples.size();
+            point.cutoffFrequency = cutoffFrequencies[index % cutoffFrequencies.size()];
+            index /= cutoffFrequencies.size();
+            point.sampleRate = sampleRates[index];
+
+            return point;
+        }
+    };
+
+    struct Failure
+    {
+        Point point;
+        std::string message;
+    };
+
+    static std::string toString (const Point& point)
+    {
+        std::ostringstream stream;
+        stream << "fs=" << point.sampleRate << " fc=" << point.cutoffFrequency << " delay=" << point.delayInSamples
+               << " gain=" << point.gain << " blockSize=" << point.blockSize;
+
+        return stream.str();
+    }
+
+    // Processes a unit impulse of the given length in blocks of blockSize, so block boundaries
+    // fall where they would inside a host.
+    static juce::AudioBuffer<float> getImpulseResponse (juce::dsp::ProcessorBase& processor, size_t numChannels, size_t length, juce::uint32 blockSize)
+    {
+        auto impulseResponse = TestHelpers::generateInputBuffer (static_cast<juce::uint32> (numChannels), static_cast<juce::uint32> (length), 1.0f);
+        juce::dsp::AudioBlock<float> block (impulseResponse);
+
+        for (size_t start = 0; start < length; start += blockSize)
+        {
+            auto subBlock = block.getSubBlock (start, juce::jmin<size_t> (blockSize, length - start));
+            processor.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+        }
+
+        return impulseResponse;
+    }
+
+    // Runs check on every grid point, spread over numThreads threads. Each thread creates its own
+    // processor with makeProcessor and its own analyser, and reuses both for all of its points, so
+    // check (processor, point, analyser) must prepare the processor for the point. check returns an
+    // empty string when the point passes, or a description of what went wrong. Catch assertions
+    // aren't thread safe, so failures are only collected here and reported by the caller, see
+    // requireNoFailures().
+    template <typename ProcessorFactory, typename Check>
+    static std::vector<Failure> run (const Grid& grid, ProcessorFactory makeProcessor, Check check, size_t numThreads = std::thread::hardware_concurrency())
+    {
+        const auto numPoints = grid.getNumPoints();
+        numThreads = juce::jlimit<size_t> (1, juce::jmax<size_t> (1, numPoints), numThreads);
+
+        std::atomic<size_t> nextPoint{ 0 };
+        std::vector<std::vector<Failure>> failuresPerThread (numThreads);
+
+        const auto runWorker = [&] (size_t thread) {
+            auto processor = makeProcessor();
+            TestHelpers::FrequencyResponseAnalyser analyser;
+
+            for (auto index = nextPoint++; index < numPoints; index = nextPoint++)
+            {
+                auto point = grid.getPoint (index);
+                auto message = check (*processor, point, analyser);
+
+                if (! message.empty())
+                    failuresPerThread[thread].push_back ({ point, message });
+            }
+        };
+
+        std::vector<std::thread> workers;
+
+        for (size_t t = 1; t < numThreads; t++)
+            workers.emplace_back (runWorker, t);
+
+        runWorker (0);
+
+        for (auto& worker : workers)
+            worker.join();
+
+        std::vector<Failure> failures;
+
+        for (auto& threadFailures : failuresPerThread)
+            failures.insert (failures.end(), threadFailures.begin(), threadFailures.end());
+
+        return failures;
+    }
+
+    static void requireNoFailures (const std::vector<Failure>& failures, size_t maxReported = 20)
+    {
+        for (size_t f = 0; f < juce::jmin (maxReported, failures.size()); f++)
+            FAIL_CHECK (toString (failures[f].point) << ": " << failures[f].message);
+
+        CHECK (failures.empty());
+    }
+} // namespace ParameterSweep
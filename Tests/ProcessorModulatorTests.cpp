@@ -0,0 +1,58 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Double blocks reach processors that only process float", "[ProcessorModulator]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 64, 2 };
+    const auto inPlace = GENERATE (true, false);
+
+    TestHelpers::SimpleMultiplier multiplier (0.5f);
+    OscillatorWrapper oscillator;
+    ProcessorModulator<double> modulator (oscillator, 10);
+
+    modulator.setProcessorToModulate (multiplier);
+    modulator.setModulationTarget ([&] (double value) { multiplier.setValue (static_cast<float> (value)); });
+    modulator.setModulationRange ({ 0.5, 0.5 });
+    modulator.setModulationFrequency (100.0f);
+    modulator.prepare (spec);
+
+    juce::AudioBuffer<double> input (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    juce::AudioBuffer<double> output (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    juce::Random random (3);
+
+    for (int ch = 0; ch < input.getNumChannels(); ch++)
+        for (int i = 0; i < input.getNumSamples(); i++)
+            input.setSample (ch, i, 2.0 * random.nextDouble() - 1.0);
+
+    if (inPlace)
+    {
+        output.makeCopyOf (input);
+        TestHelpers::runProcess (modulator, output);
+    }
+    else
+    {
+        juce::dsp::AudioBlock<double> inputBlock (input);
+        juce::dsp::AudioBlock<double> outputBlock (output);
+        modulator.process (juce::dsp::ProcessContextNonReplacing<double> (inputBlock, outputBlock));
+    }
+
+    // the processor runs in float, so the input is rounded to float first
+    for (int ch = 0; ch < output.getNumChannels(); ch++)
+        for (int i = 0; i < output.getNumSamples(); i++)
+            REQUIRE (output.getSample (ch, i) == static_cast<double> (static_cast<float> (input.getSample (ch, i)) * 0.5f));
+}
+
+TEST_CASE ("Update counters are valid before prepare", "[ProcessorModulator]")
+{
+    OscillatorWrapper oscillator;
+    ProcessorModulator<float> modulator (oscillator, 16);
+
+    // the quality governor and TiledChain read and change the rate before anything is prepared
+    CHECK (modulator.getSamplesUntilNextUpdate() == 16);
+
+    modulator.setUpdateRate (4);
+    CHECK (modulator.getSamplesUntilNextUpdate() == 4);
+
+    modulator.setUpdateRate (32);
+    CHECK (modulator.getSamplesUntilNextUpdate() == 4);
+}
@@ -0,0 +1,87 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+TEST_CASE ("Test that the profiler reports percentiles and maximum", "[ProcessorProfiler]")
+{
+    ProcessorProfiler profiler;
+
+    for (int i = 0; i < 98; i++)
+        profiler.record (1.0);
+
+    profiler.record (10.0);
+    profiler.record (100.0);
+
+    auto statistics = profiler.getStatistics();
+
+    CHECK (statistics.numCalls == 100);
+    CHECK (statistics.maxNsPerSample == 100.0);
+
+    // percentiles are quantised to the histogram bins, which are 1/8 octave wide
+    CHECK_THAT (statistics.p50NsPerSample, Catch::Matchers::WithinRel (1.0, 0.1));
+    CHECK_THAT (statistics.p99NsPerSample, Catch::Matchers::WithinRel (10.0, 0.1));
+}
+
+TEST_CASE ("Test that clearing the profiler takes effect on the next record", "[ProcessorProfiler]")
+{
+    ProcessorProfiler profiler;
+
+    profiler.record (50.0);
+    profiler.clear();
+    profiler.record (2.0);
+
+    auto statistics = profiler.getStatistics();
+
+    CHECK (statistics.numCalls == 1);
+    CHECK (statistics.maxNsPerSample == 2.0);
+}
+
+TEST_CASE ("Test that a profiled processor records every call", "[ProcessorProfiler]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    Profiled<OnePoleFilter::Lowpass<>> lowpassFilter;
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+
+    auto input = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+
+    for (int i = 0; i < 10; i++)
+        TestHelpers::runProcess (lowpassFilter, input);
+
+    auto statistics = lowpassFilter.getProfiler().getStatistics();
+
+    CHECK (statistics.numCalls == 10);
+    CHECK (statistics.maxNsPerSample > 0.0);
+    CHECK (statistics.p50NsPerSample <= statistics.p99NsPerSample);
+}
+
+TEST_CASE ("Test that a profiled processor records double and out of place blocks", "[ProcessorProfiler]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    Profiled<VariableDelayAllpass<double>> allpass (100);
+    allpass.prepare (spec);
+    allpass.setDelayInSamples (10.0, 0, true);
+    allpass.setGain (0.5, true);
+
+    juce::AudioBuffer<double> input (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    juce::AudioBuffer<double> output (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    input.clear();
+    juce::dsp::AudioBlock<double> inputBlock (input);
+    juce::dsp::AudioBlock<double> outputBlock (output);
+
+    TestHelpers::runProcess (allpass, input);
+
+    // chains and modulators call through the base class
+    MultiPrecisionProcessor& processor = allpass;
+    processor.process (juce::dsp::ProcessContextReplacing<double> (inputBlock));
+    processor.process (juce::dsp::ProcessContextNonReplacing<double> (inputBlock, outputBlock));
+
+    auto floatBuffer = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+    auto floatOutput = floatBuffer;
+    juce::dsp::AudioBlock<float> floatInputBlock (floatBuffer);
+    juce::dsp::AudioBlock<float> floatOutputBlock (floatOutput);
+    processor.process (juce::dsp::ProcessContextNonReplacing<float> (floatInputBlock, floatOutputBlock));
+
+    CHECK (allpass.getProfiler().getStatistics().numCalls == 4);
+}
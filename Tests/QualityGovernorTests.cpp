@@ -0,0 +1,293 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // 48 blocks of 1000 samples make one second
+    constexpr double sampleRate = 48000.0;
+    constexpr size_t blockSize = 1000;
+    constexpr double blockSeconds = static_cast<double> (blockSize) / sampleRate;
+
+    bool recordLoad (QualityGovernor& governor, double load)
+    {
+        return governor.recordBlock (load * blockSeconds, blockSize);
+    }
+} // namespace
+
+TEST_CASE ("Test that the governor downgrades after consecutive blocks over budget", "[QualityGovernor]")
+{
+    OnePoleFilter::Lowpass<float> lowpassFilter;
+    std::vector<int> appliedTiers;
+
+    QualityGovernor governor (lowpassFilter, 3, [&] (int tier) { appliedTiers.push_back (tier); });
+    governor.prepare ({ sampleRate, static_cast<juce::uint32> (blockSize), 2 });
+
+    CHECK (governor.getTier() == 0);
+    CHECK (appliedTiers.empty());
+
+    // a single spike is not enough
+    CHECK_FALSE (recordLoad (governor, 0.9));
+    CHECK_FALSE (recordLoad (governor, 0.9));
+    CHECK_FALSE (recordLoad (governor, 0.5));
+    CHECK_FALSE (recordLoad (governor, 0.9));
+    CHECK_FALSE (recordLoad (governor, 0.9));
+    CHECK (recordLoad (governor, 0.9));
+
+    CHECK (governor.getTier() == 1);
+    CHECK_THAT (governor.getLoad(), Catch::Matchers::WithinRel (0.9, 1.0e-9));
+
+    for (int i = 0; i < 3; i++)
+        recordLoad (governor, 1.5);
+
+    CHECK (governor.getTier() == 2);
+
+    // the last tier is as cheap as it gets
+    for (int i = 0; i < 30; i++)
+        CHECK_FALSE (recordLoad (governor, 1.5));
+
+    CHECK (governor.getTier() == 2);
+    CHECK (appliedTiers == std::vector<int>{ 1, 2 });
+    CHECK (governor.getNumTierChanges() == 2);
+}
+
+TEST_CASE ("Test that the governor upgrades only after holding under the upgrade load", "[QualityGovernor]")
+{
+    OnePoleFilter::Lowpass<float> lowpassFilter;
+    std::vector<int> appliedTiers;
+
+    QualityGovernor::Settings settings;
+    settings.upgradeHoldSeconds = 1.0;
+
+    QualityGovernor governor (lowpassFilter, 2, [&] (int tier) { appliedTiers.push_back (tier); }, settings);
+    governor.prepare ({ sampleRate, static_cast<juce::uint32> (blockSize), 2 });
+
+    for (int i = 0; i < 3; i++)
+        recordLoad (governor, 0.8);
+
+    REQUIRE (governor.getTier() == 1);
+
+    // between the thresholds, nothing changes and the hold starts over
+    for (int i = 0; i < 47; i++)
+        CHECK_FALSE (recordLoad (governor, 0.1));
+
+    CHECK_FALSE (recordLoad (governor, 0.6));
+
+    for (int i = 0; i < 47; i++)
+        CHECK_FALSE (recordLoad (governor, 0.1));
+
+    CHECK (recordLoad (governor, 0.1));
+    CHECK (governor.getTier() == 0);
+
+    // the first tier is as good as it gets
+    for (int i = 0; i < 200; i++)
+        CHECK_FALSE (recordLoad (governor, 0.1));
+
+    CHECK (appliedTiers == std::vector<int>{ 1, 0 });
+}
+
+TEST_CASE ("Test that resetting the governor returns to full quality", "[QualityGovernor]")
+{
+    OnePoleFilter::Lowpass<float> lowpassFilter;
+    int appliedTier = -1;
+
+    QualityGovernor governor (lowpassFilter, 4, [&] (int tier) { appliedTier = tier; });
+    governor.prepare ({ sampleRate, static_cast<juce::uint32> (blockSize), 2 });
+
+    for (int i = 0; i < 2; i++)
+        recordLoad (governor, 2.0);
+
+    for (int i = 0; i < 3; i++)
+        recordLoad (governor, 2.0);
+
+    REQUIRE (appliedTier == 1);
+
+    governor.reset();
+
+    CHECK (governor.getTier() == 0);
+    CHECK (appliedTier == 0);
+
+    // the count of blocks over budget starts over too
+    for (int i = 0; i < 2; i++)
+        recordLoad (governor, 2.0);
+
+    CHECK (governor.getTier() == 0);
+}
+
+TEST_CASE ("Test that the governor times the processor it wraps", "[QualityGovernor]")
+{
+    juce::dsp::ProcessSpec spec{ sampleRate, 256, 2 };
+
+    OnePoleFilter::Lowpass<float> lowpassFilter;
+    QualityGovernor governor (lowpassFilter, 2, nullptr);
+    governor.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+
+    auto input = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+    auto expected = input;
+
+    OnePoleFilter::Lowpass<float> reference;
+    reference.prepare (spec);
+    reference.setCutoffFrequency (1000.0f, true);
+
+    TestHelpers::runProcess (governor, input);
+    TestHelpers::runProcess (reference, expected);
+
+    CHECK (governor.getLoad() > 0.0);
+
+    for (int ch = 0; ch < input.getNumChannels(); ch++)
+        for (int i = 0; i < input.getNumSamples(); i++)
+            CHECK (input.getSample (ch, i) == expected.getSample (ch, i));
+}
+
+TEST_CASE ("Test that inactive taps fade out and leave the main tap untouched", "[QualityGovernor]")
+{
+    juce::dsp::ProcessSpec spec{ sampleRate, 256, 1 };
+    const auto fadeBlocks = static_cast<int> (sampleRate * 0.05) / static_cast<int> (spec.maximumBlockSize) + 1;
+
+    VariableDelayLine<float> delayLine (1000, 3);
+    VariableDelayLine<float> reference (1000, 3);
+
+    for (auto* line : { &delayLine, &reference })
+    {
+        line->prepare (spec);
+        line->setDelayInSamples (100.0f, 0, true);
+        line->setDelayInSamples (200.0f, 1, true);
+        line->setDelayInSamples (300.0f, 2, true);
+    }
+
+    juce::Random random (3);
+    juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+
+    auto processBoth = [&]
+    {
+        for (int i = 0; i < buffer.getNumSamples(); i++)
+            buffer.setSample (0, i, 2.0f * random.nextFloat() - 1.0f);
+
+        auto expected = buffer;
+
+        TestHelpers::runProcess (delayLine, buffer);
+        TestHelpers::runProcess (reference, expected);
+
+        for (int i = 0; i < buffer.getNumSamples(); i++)
+            REQUIRE (buffer.getSample (0, i) == expected.getSample (0, i));
+    };
+
+    for (int block = 0; block < 4; block++)
+        processBoth();
+
+    delayLine.setNumActiveTaps (1);
+    CHECK (delayLine.getNumActiveTaps() == 1);
+
+    processBoth();
+
+    // the fade starts from the tap's full output
+    const auto* fadingTap = delayLine.getTapOutBuffer (0, 2);
+    const auto* referenceTap = reference.getTapOutBuffer (0, 2);
+    CHECK_THAT (fadingTap[0], Catch::Matchers::WithinAbs (referenceTap[0], 1.0e-3));
+    CHECK (std::abs (fadingTap[spec.maximumBlockSize - 1]) < std::abs (referenceTap[spec.maximumBlockSize - 1]) + 1.0e-6f);
+
+    for (int block = 0; block < fadeBlocks; block++)
+        processBoth();
+
+    for (size_t tap = 1; tap < 3; tap++)
+        for (size_t i = 0; i < spec.maximumBlockSize; i++)
+            REQUIRE (delayLine.getTapOutBuffer (0, tap)[i] == 0.0f);
+
+    // and back in
+    delayLine.setNumActiveTaps (3);
+
+    for (int block = 0; block < fadeBlocks + 1; block++)
+        processBoth();
+
+    for (size_t tap = 1; tap < 3; tap++)
+        for (size_t i = 0; i < spec.maximumBlockSize; i++)
+            REQUIRE (delayLine.getTapOutBuffer (0, tap)[i] == reference.getTapOutBuffer (0, tap)[i]);
+}
+
+TEST_CASE ("Test that changing the modulation update rate keeps the modulation continuous", "[QualityGovernor]")
+{
+    juce::dsp::ProcessSpec spec{ sampleRate, 256, 1 };
+
+    VariableDelayLine<float> delayLine (1000);
+    OscillatorWrapper oscillator;
+    ProcessorModulator<float> modulator (oscillator, 16);
+
+    std::vector<float> targets;
+    targets.reserve (1 << 14);
+
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (delayLine);
+    modulator.setModulationTarget ([&] (float value) { targets.push_back (value); });
+    modulator.setModulationRange ({ 10.0f, 100.0f });
+    modulator.setModulationFrequency (5.0f);
+
+    delayLine.prepare (spec);
+    modulator.prepare (spec);
+
+    juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+    buffer.clear();
+
+    for (int block = 0; block < 20; block++)
+        TestHelpers::runProcess (modulator, buffer);
+
+    const auto updatesAtFullRate = targets.size();
+
+    modulator.setUpdateRate (64);
+    CHECK (modulator.getUpdateRate() == 64);
+
+    for (int block = 0; block < 80; block++)
+        TestHelpers::runProcess (modulator, buffer);
+
+    // a quarter of the updates, each covering four times the phase
+    const auto updatesAtQuarterRate = targets.size() - updatesAtFullRate;
+    CHECK (updatesAtQuarterRate + 2 >= updatesAtFullRate);
+    CHECK (updatesAtQuarterRate <= updatesAtFullRate + 2);
+
+    // 5 Hz over 64 samples moves a 90 sample range by at most 2 pi 5 64 / 48000 * 45
+    const auto maxStep = juce::MathConstants<float>::twoPi * 5.0f * 64.0f / static_cast<float> (sampleRate) * 45.0f;
+
+    for (size_t i = updatesAtFullRate - 1; i + 1 < targets.size(); i++)
+        REQUIRE (std::abs (targets[i + 1] - targets[i]) <= maxStep * 1.01f);
+}
+
+TEST_CASE ("Test that disabled modulation parks the target at the centre", "[QualityGovernor]")
+{
+    juce::dsp::ProcessSpec spec{ sampleRate, 256, 1 };
+
+    VariableDelayLine<float> delayLine (1000);
+    OscillatorWrapper oscillator;
+    ProcessorModulator<float> modulator (oscillator, 16);
+
+    std::vector<float> targets;
+    targets.reserve (1024);
+
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (delayLine);
+    modulator.setModulationTarget ([&] (float value) { targets.push_back (value); });
+    modulator.setModulationRange ({ 10.0f, 100.0f });
+    modulator.setModulationFrequency (5.0f);
+
+    delayLine.prepare (spec);
+    modulator.prepare (spec);
+
+    juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+    buffer.clear();
+    TestHelpers::runProcess (modulator, buffer);
+
+    modulator.setModulationEnabled (false);
+    CHECK_FALSE (modulator.isModulationEnabled());
+    REQUIRE_FALSE (targets.empty());
+    CHECK (targets.back() == 55.0f);
+
+    const auto numTargets = targets.size();
+
+    for (int block = 0; block < 10; block++)
+        TestHelpers::runProcess (modulator, buffer);
+
+    CHECK (targets.size() == numTargets);
+
+    modulator.setModulationEnabled (true);
+    TestHelpers::runProcess (modulator, buffer);
+
+    CHECK (targets.size() > numTargets);
+}
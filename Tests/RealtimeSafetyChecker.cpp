@@ -0,0 +1,260 @@
+#include "RealtimeSafetyChecker.h"
+#include <array>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+    #include <dlfcn.h>
+    #include <execinfo.h>
+    #include <pthread.h>
+#endif
+
+namespace RealtimeSafety
+{
+    static constexpr size_t maxStackFrames = 32;
+    static constexpr size_t maxRecordedViolations = 64;
+
+    struct RecordedViolation
+    {
+        ViolationType type;
+        std::array<void*, maxStackFrames> frames;
+        int numFrames;
+    };
+
+    // recording must not allocate, so violations are stored in a fixed array of raw stack frames
+    // and only symbolised once the check has ended
+    static std::array<RecordedViolation, maxRecordedViolations> recordedViolations;
+    static std::atomic<size_t> numRecordedViolations{ 0 };
+
+    static thread_local bool isChecking = false;
+    static thread_local bool isRecording = false;
+
+    static void recordViolation (ViolationType type)
+    {
+        if (! isChecking || isRecording)
+            return;
+
+        isRecording = true;
+
+        auto index = numRecordedViolations.fetch_add (1);
+
+        if (index < maxRecordedViolations)
+        {
+            auto& violation = recordedViolations[index];
+            violation.type = type;
+
+#if JUCE_LINUX || JUCE_MAC
+            violation.numFrames = backtrace (violation.frames.data(), static_cast<int> (maxStackFrames));
+#else
+            violation.numFrames = 0;
+#endif
+        }
+
+        isRecording = false;
+    }
+
+    ScopedRealtimeCheck::ScopedRealtimeCheck()
+    {
+#if JUCE_LINUX || JUCE_MAC
+        // backtrace() loads libgcc lazily on its first call, so do that outside of the check
+        static bool isBacktraceLoaded = [] {
+            void* frame;
+            return backtrace (&frame, 1) > 0;
+        }();
+        (void) isBacktraceLoaded;
+#endif
+
+        jassert (! isChecking);
+
+        numRecordedViolations = 0;
+        isChecking = true;
+    }
+
+    ScopedRealtimeCheck::~ScopedRealtimeCheck()
+    {
+        isChecking = false;
+    }
+
+    std::vector<Violation> ScopedRealtimeCheck::getViolations()
+    {
+        isChecking = false;
+
+        std::vector<Violation> violations;
+        auto numViolations = juce::jmin (numRecordedViolations.load(), maxRecordedViolations);
+
+        for (size_t v = 0; v < numViolations; v++)
+        {
+            auto& recorded = recordedViolations[v];
+            std::string stackTrace;
+
+#if JUCE_LINUX || JUCE_MAC
+            if (char** symbols = backtrace_symbols (recorded.frames.data(), recorded.numFrames))
+            {
+                // skip the frames of the checker itself
+                for (int i = 2; i < recorded.numFrames; i++)
+                    stackTrace += std::string (symbols[i]) + "\n";
+
+                std::free (symbols);
+            }
+#endif
+
+            violations.push_back ({ recorded.type, stackTrace });
+        }
+
+        return violations;
+    }
+
+    std::string toString (const Violation& violation)
+    {
+        std::string type;
+
+        switch (violation.type)
+        {
+            case ViolationType::Allocation:
+                type = "allocation";
+                break;
+
+            case ViolationType::Deallocation:
+                type = "deallocation";
+                break;
+
+            case ViolationType::Lock:
+                type = "lock";
+                break;
+        }
+
+        return type + " inside realtime context:\n" + violation.stackTrace;
+    }
+
+    std::vector<Violation> checkProcess (juce::dsp::ProcessorBase& processor, juce::AudioBuffer<float>& buffer, size_t numBlocks)
+    {
+        juce::dsp::AudioBlock<float> block (buffer);
+        juce::dsp::ProcessContextReplacing<float> context (block);
+
+        processor.process (context);
+
+        ScopedRealtimeCheck check;
+
+        for (size_t b = 1; b < numBlocks; b++)
+            processor.process (context);
+
+        return check.getViolations();
+    }
+} // namespace RealtimeSafety
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+}
+
+static void* allocateUnchecked (size_t size) { return __libc_malloc (size); }
+static void* allocateAlignedUnchecked (size_t alignment, size_t size) { return __libc_memalign (alignment, size); }
+static void freeUnchecked (void* ptr) { __libc_free (ptr); }
+#else
+static void* allocateUnchecked (size_t size) { return std::malloc (size); }
+static void* allocateAlignedUnchecked (size_t alignment, size_t size) { return std::aligned_alloc (alignment, (size + alignment - 1) / alignment * alignment); }
+static void freeUnchecked (void* ptr) { std::free (ptr); }
+#endif
+
+// Global hooks. They are defined in the test binary so they take precedence over the ones
+// from the C++ runtime and, for the C functions, over libc through symbol interposition.
+void* operator new (std::size_t size)
+{
+    RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Allocation);
+
+    if (void* ptr = allocateUnchecked (size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Allocation);
+
+    if (void* ptr = allocateAlignedUnchecked (static_cast<std::size_t> (alignment), size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Deallocation);
+
+    freeUnchecked (ptr);
+}
+
+void operator delete (void* ptr, std::align_val_t) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Deallocation);
+
+    freeUnchecked (ptr);
+}
+
+// deleting an object of known size calls the sized forms where sized deallocation is on, as with GCC
+void operator delete (void* ptr, std::size_t) noexcept
+{
+    operator delete (ptr);
+}
+
+void operator delete (void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete (ptr, alignment);
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    // catches juce::HeapBlock and everything else going straight to the C allocator
+    void* malloc (size_t size)
+    {
+        RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Allocation);
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t numElements, size_t size)
+    {
+        RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Allocation);
+        return __libc_calloc (numElements, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Allocation);
+        return __libc_realloc (ptr, size);
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Deallocation);
+
+        __libc_free (ptr);
+    }
+}
+#endif
+
+#if JUCE_LINUX
+using MutexLockFunction = int (*) (pthread_mutex_t*);
+
+// resolved without a function-local static, whose guard could itself end up locking
+static MutexLockFunction realMutexLock = nullptr;
+
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex)
+{
+    if (realMutexLock == nullptr)
+        realMutexLock = reinterpret_cast<MutexLockFunction> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+
+    RealtimeSafety::recordViolation (RealtimeSafety::ViolationType::Lock);
+
+    return realMutexLock (mutex);
+}
+#endif
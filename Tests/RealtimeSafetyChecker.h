@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+namespace RealtimeSafety
+{
+    // The checker replaces the global operator new/delete of the test binary (and malloc/free and
+    // pthread_mutex_lock where the platform allows interposing them). While a ScopedRealtimeCheck is
+    // alive on a thread, every allocation, deallocation or lock made by that thread is recorded as a
+    // violation together with the call stack that triggered it.
+    enum class ViolationType
+    {
+        Allocation,
+        Deallocation,
+        Lock
+    };
+
+    struct Violation
+    {
+        ViolationType type;
+        std::string stackTrace;
+    };
+
+    class ScopedRealtimeCheck
+    {
+    public:
+        ScopedRealtimeCheck();
+        ~ScopedRealtimeCheck();
+
+        // stops recording and returns the violations seen since construction
+        std::vector<Violation> getViolations();
+    };
+
+    std::string toString (const Violation& violation);
+
+    // Runs process() on the given buffer for numBlocks blocks and returns every violation.
+    // The first block is processed outside of the check, so lazy initialisation done by the
+    // processor on its first call does not count as steady-state behaviour.
+    std::vector<Violation> checkProcess (juce::dsp::ProcessorBase& processor, juce::AudioBuffer<float>& buffer, size_t numBlocks = 16);
+} // namespace RealtimeSafety
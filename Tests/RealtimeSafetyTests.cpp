@@ -0,0 +1,285 @@
+#include "RealtimeSafetyChecker.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    class AllocatingProcessor : public juce::dsp::ProcessorBase
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            (void) spec;
+        }
+        virtual void reset() override
+        {
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            _history.push_back (context.getOutputBlock().getSample (0, 0));
+        }
+
+    private:
+        std::vector<float> _history;
+    };
+
+    class LockingProcessor : public juce::dsp::ProcessorBase
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            (void) spec;
+        }
+        virtual void reset() override
+        {
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            context.getOutputBlock().multiplyBy (0.5f);
+        }
+
+    private:
+        std::mutex _mutex;
+    };
+
+    void requireRealtimeSafe (juce::dsp::ProcessorBase& processor, const juce::dsp::ProcessSpec& spec)
+    {
+        auto buffer = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+
+        for (auto& violation : RealtimeSafety::checkProcess (processor, buffer))
+            FAIL_CHECK (RealtimeSafety::toString (violation));
+    }
+
+    // hosts re-prepare on every sample rate or block size change; with the same or a smaller spec
+    // the memory from the first prepare has to be reused
+    void requireNoAllocationOnRePrepare (juce::dsp::ProcessorBase& processor, const juce::dsp::ProcessSpec& spec)
+    {
+        processor.prepare (spec);
+
+        RealtimeSafety::ScopedRealtimeCheck check;
+
+        processor.prepare (spec);
+        processor.prepare ({ spec.sampleRate * 2.0, spec.maximumBlockSize / 2, spec.numChannels / 2 });
+        processor.prepare (spec);
+
+        for (auto& violation : check.getViolations())
+            FAIL_CHECK (RealtimeSafety::toString (violation));
+    }
+} // namespace
+
+TEST_CASE ("Test that the realtime safety checker detects allocations", "[RealtimeSafety]")
+{
+    AllocatingProcessor processor;
+
+    auto buffer = TestHelpers::generateInputBuffer (2, 64, 1.0f);
+    auto violations = RealtimeSafety::checkProcess (processor, buffer, 64);
+
+    REQUIRE_FALSE (violations.empty());
+    CHECK (violations[0].type == RealtimeSafety::ViolationType::Allocation);
+    CHECK_FALSE (violations[0].stackTrace.empty());
+}
+
+#if JUCE_LINUX
+TEST_CASE ("Test that the realtime safety checker detects locks", "[RealtimeSafety]")
+{
+    LockingProcessor processor;
+
+    auto buffer = TestHelpers::generateInputBuffer (2, 64, 1.0f);
+    auto violations = RealtimeSafety::checkProcess (processor, buffer);
+
+    REQUIRE_FALSE (violations.empty());
+    CHECK (violations[0].type == RealtimeSafety::ViolationType::Lock);
+}
+#endif
+
+TEST_CASE ("Test that one pole filters are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    OnePoleFilter::Lowpass lowpassFilter;
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f);
+
+    OnePoleFilter::Highpass highpassFilter;
+    highpassFilter.prepare (spec);
+    highpassFilter.setCutoffFrequency (1000.0f);
+
+    requireRealtimeSafe (lowpassFilter, spec);
+    requireRealtimeSafe (highpassFilter, spec);
+}
+
+TEST_CASE ("Test that delay lines are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    VariableDelayLine delayLine (1000, 3);
+    delayLine.prepare (spec);
+
+    VariableDelayAllpass allpass (1000, 3);
+    allpass.prepare (spec);
+    allpass.setGain (0.5f);
+
+    for (size_t n = 0; n < 3; n++)
+    {
+        delayLine.setDelayInSamples (100.0f * (n + 1), n);
+        allpass.setDelayInSamples (100.0f * (n + 1), n);
+    }
+
+    requireRealtimeSafe (delayLine, spec);
+    requireRealtimeSafe (allpass, spec);
+}
+
+TEST_CASE ("Test that batched processors are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 8 };
+
+    Batched::Lowpass lowpassFilter (4);
+    lowpassFilter.prepare (spec);
+
+    Batched::VariableDelayAllpass allpass (4, 1000);
+    allpass.prepare (spec);
+
+    for (size_t k = 0; k < 4; k++)
+    {
+        lowpassFilter.setCutoffFrequency (k, 1000.0f * (k + 1));
+        allpass.setDelayInSamples (k, 100.0f * (k + 1));
+        allpass.setGain (k, 0.5f);
+    }
+
+    requireRealtimeSafe (lowpassFilter, spec);
+    requireRealtimeSafe (allpass, spec);
+}
+
+TEST_CASE ("Test that the processor modulator is realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    VariableDelayLine delayLine (1000);
+    OscillatorWrapper oscillator;
+    ProcessorModulator modulator (oscillator, 16);
+
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (delayLine);
+    modulator.setModulationTarget ([&] (float value) { delayLine.setDelayInSamples (value); });
+    modulator.setModulationRange ({ 10.0f, 100.0f });
+    modulator.setModulationFrequency (2.0f);
+
+    delayLine.prepare (spec);
+    modulator.prepare (spec);
+
+    requireRealtimeSafe (modulator, spec);
+}
+
+TEST_CASE ("Test that metering from the audio thread is realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    MeteringFeed feed (4);
+    feed.prepare (spec.sampleRate, spec.numChannels, 3, 1000.0);
+
+    VariableDelayLine delayLine (1000, 3);
+    delayLine.prepare (spec);
+    delayLine.setDelayInSamples (100.0f, 1);
+    delayLine.setMeteringFeed (&feed);
+
+    auto buffer = TestHelpers::generateInputBuffer (spec.numChannels, spec.maximumBlockSize, 1.0f);
+    juce::dsp::AudioBlock<float> block (buffer);
+
+    RealtimeSafety::ScopedRealtimeCheck check;
+
+    // enough blocks to fill the feed and drop frames
+    for (int i = 0; i < 16; i++)
+    {
+        delayLine.process (juce::dsp::ProcessContextReplacing<float> (block));
+        feed.endBlock (spec.maximumBlockSize);
+    }
+
+    for (auto& violation : check.getViolations())
+        FAIL_CHECK (RealtimeSafety::toString (violation));
+
+    CHECK (feed.getNumDroppedFrames() > 0);
+}
+
+TEST_CASE ("Test that feedback delay networks are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 256, 2 };
+
+    FDN<16> fdn (4000);
+    fdn.prepare (spec);
+    fdn.setModulation (0.5f, 4.0f);
+    fdn.setFeedback (0.9f);
+
+    for (size_t n = 0; n < 16; n++)
+        fdn.setDelayInSamples (1000.0f + 100.0f * n, n);
+
+    requireRealtimeSafe (fdn, spec);
+}
+
+TEST_CASE ("Test that freezable processors are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 2 };
+
+    FreezableProcessor processor (
+        [spec]
+        {
+            auto allpass = std::make_unique<VariableDelayAllpass<float>> (64);
+            allpass->prepare (spec);
+            allpass->setDelayInSamples (37.0f, 0, true);
+            allpass->setGain (0.5f, true);
+
+            return allpass;
+        },
+        1 << 12,
+        128);
+    processor.setCrossfadeTime (0.005);
+    processor.prepare (spec);
+    processor.freeze();
+
+    // covers the warm-up, the crossfade and the frozen state
+    requireRealtimeSafe (processor, spec);
+
+    processor.unfreeze();
+    requireRealtimeSafe (processor, spec);
+}
+
+TEST_CASE ("Test that resampled processors are realtime safe", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 192000.0, 512, 2 };
+
+    ResampledProcessor processor ([] (const juce::dsp::ProcessSpec& internalSpec, double delayScale)
+                                  {
+                                      auto fdn = std::make_unique<FDN<8>> (static_cast<size_t> (4000.0 * delayScale));
+                                      fdn->prepare (internalSpec);
+
+                                      for (size_t n = 0; n < 8; n++)
+                                          fdn->setDelayInSamples (static_cast<float> ((1000.0 + 300.0 * n) * delayScale), n, true);
+
+                                      return fdn;
+                                  });
+    processor.prepare (spec);
+
+    requireRealtimeSafe (processor, spec);
+}
+
+TEST_CASE ("Test that re-preparing processors does not allocate", "[RealtimeSafety]")
+{
+    juce::dsp::ProcessSpec spec{ 48000.0, 512, 4 };
+
+    OnePoleFilter::Lowpass lowpassFilter;
+    OnePoleFilter::Highpass highpassFilter;
+    VariableDelayLine delayLine (1000, 3);
+    VariableDelayAllpass allpass (1000, 3);
+    FDN<8> fdn (1000);
+
+    lowpassFilter.prepare (spec);
+    lowpassFilter.setCutoffFrequency (1000.0f, true);
+    highpassFilter.prepare (spec);
+    highpassFilter.setCutoffFrequency (1000.0f, true);
+
+    requireNoAllocationOnRePrepare (lowpassFilter, spec);
+    requireNoAllocationOnRePrepare (highpassFilter, spec);
+    requireNoAllocationOnRePrepare (delayLine, spec);
+    requireNoAllocationOnRePrepare (allpass, spec);
+    requireNoAllocationOnRePrepare (fdn, spec);
+}
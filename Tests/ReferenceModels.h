@@ -0,0 +1,369 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+// Frozen scalar copies of the module processors, kept as the reference for EquivalenceHarness.
+// They must not be changed when the module processors are optimised: any change of output there
+// has to show up as a divergence from these. Only the float I/O path is modelled.
+namespace ReferenceModels
+{
+    // sample-by-sample behaviour of juce::dsp::DelayLine with linear interpolation, checked against it
+    // in EquivalenceTests
+    template <typename SampleType>
+    class DelayLine
+    {
+    public:
+        DelayLine (size_t maximumDelayInSamples)
+            : _totalSize (juce::jmax<size_t> (4, maximumDelayInSamples + 2))
+        {
+        }
+
+        void prepare (size_t numChannels)
+        {
+            _buffer.assign (numChannels, std::vector<SampleType> (_totalSize, 0));
+            _writePos.assign (numChannels, 0);
+            _readPos.assign (numChannels, 0);
+        }
+
+        size_t getMaximumDelayInSamples() const
+        {
+            return _totalSize - 2;
+        }
+
+        void pushSample (size_t ch, SampleType sample)
+        {
+            _buffer[ch][_writePos[ch]] = sample;
+            _writePos[ch] = (_writePos[ch] + _totalSize - 1) % _totalSize;
+        }
+
+        SampleType popSample (size_t ch, SampleType delayInSamples, bool updateReadPointer = true)
+        {
+            const auto delay = juce::jlimit<SampleType> (0, static_cast<SampleType> (getMaximumDelayInSamples()), delayInSamples);
+            const auto delayInt = static_cast<size_t> (std::floor (delay));
+            const auto delayFrac = delay - static_cast<SampleType> (delayInt);
+
+            auto index1 = _readPos[ch] + delayInt;
+            auto index2 = index1 + 1;
+
+            if (index2 >= _totalSize)
+            {
+                index1 %= _totalSize;
+                index2 %= _totalSize;
+            }
+
+            const auto value1 = _buffer[ch][index1];
+            const auto value2 = _buffer[ch][index2];
+
+            if (updateReadPointer)
+                _readPos[ch] = (_readPos[ch] + _totalSize - 1) % _totalSize;
+
+            return value1 + delayFrac * (value2 - value1);
+        }
+
+    private:
+        size_t _totalSize;
+        std::vector<std::vector<SampleType>> _buffer;
+        std::vector<size_t> _writePos;
+        std::vector<size_t> _readPos;
+    };
+
+    template <typename SampleType = float>
+    class Lowpass : public juce::dsp::ProcessorBase
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _fs = spec.sampleRate;
+            _b0.assign (spec.numChannels, {});
+            _a1.assign (spec.numChannels, {});
+            _zPole.assign (spec.numChannels, 0);
+
+            for (size_t ch = 0; ch < spec.numChannels; ch++)
+            {
+                _b0[ch].reset (spec.sampleRate, 0.05);
+                _a1[ch].reset (spec.sampleRate, 0.05);
+            }
+        }
+
+        virtual void reset() override
+        {
+            for (size_t ch = 0; ch < _b0.size(); ch++)
+            {
+                _b0[ch].reset (_fs, 0.05);
+                _a1[ch].reset (_fs, 0.05);
+                _zPole[ch] = 0;
+            }
+        }
+
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            auto& block = context.getOutputBlock();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+                for (size_t i = 0; i < block.getNumSamples(); i++)
+                {
+                    auto* samples = block.getChannelPointer (ch);
+
+                    _zPole[ch] = static_cast<SampleType> (samples[i]) * _b0[ch].getNextValue() + _zPole[ch] * _a1[ch].getNextValue();
+                    samples[i] = static_cast<float> (_zPole[ch]);
+                }
+        }
+
+        void setCutoffFrequency (SampleType fc, bool force = false)
+        {
+            SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
+
+            for (size_t ch = 0; ch < _b0.size(); ch++)
+            {
+                if (force)
+                {
+                    _a1[ch].setCurrentAndTargetValue (alpha);
+                    _b0[ch].setCurrentAndTargetValue (static_cast<SampleType> (1.0 - alpha));
+                }
+                else
+                {
+                    _a1[ch].setTargetValue (alpha);
+                    _b0[ch].setTargetValue (static_cast<SampleType> (1.0 - alpha));
+                }
+            }
+        }
+
+    private:
+        double _fs = 0.0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _a1;
+        std::vector<SampleType> _zPole;
+    };
+
+    template <typename SampleType = float>
+    class Highpass : public juce::dsp::ProcessorBase
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _fs = spec.sampleRate;
+            _b0.assign (spec.numChannels, {});
+            _b1.assign (spec.numChannels, {});
+            _a1.assign (spec.numChannels, {});
+            _zPole.assign (spec.numChannels, 0);
+            _zZero.assign (spec.numChannels, 0);
+
+            for (size_t ch = 0; ch < spec.numChannels; ch++)
+            {
+                _b0[ch].reset (spec.sampleRate, 0.05);
+                _b1[ch].reset (spec.sampleRate, 0.05);
+                _a1[ch].reset (spec.sampleRate, 0.05);
+            }
+        }
+
+        virtual void reset() override
+        {
+            for (size_t ch = 0; ch < _b0.size(); ch++)
+            {
+                _b0[ch].reset (_fs, 0.05);
+                _b1[ch].reset (_fs, 0.05);
+                _a1[ch].reset (_fs, 0.05);
+                _zPole[ch] = 0;
+                _zZero[ch] = 0;
+            }
+        }
+
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            auto& block = context.getOutputBlock();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+                for (size_t i = 0; i < block.getNumSamples(); i++)
+                {
+                    auto* samples = block.getChannelPointer (ch);
+                    const auto input = static_cast<SampleType> (samples[i]);
+
+                    _zPole[ch] = input * _b0[ch].getNextValue() + _zZero[ch] * _b1[ch].getNextValue() + _zPole[ch] * _a1[ch].getNextValue();
+                    _zZero[ch] = input;
+                    samples[i] = static_cast<float> (_zPole[ch]);
+                }
+        }
+
+        void setCutoffFrequency (SampleType fc, bool force = false)
+        {
+            SampleType alpha = static_cast<SampleType> (std::exp (-2.0 * M_PI * fc / _fs));
+            SampleType b0 = static_cast<SampleType> ((1.0 + alpha) / 2.0);
+
+            for (size_t ch = 0; ch < _b0.size(); ch++)
+            {
+                if (force)
+                {
+                    _a1[ch].setCurrentAndTargetValue (alpha);
+                    _b0[ch].setCurrentAndTargetValue (b0);
+                    _b1[ch].setCurrentAndTargetValue (-b0);
+                }
+                else
+                {
+                    _a1[ch].setTargetValue (alpha);
+                    _b0[ch].setTargetValue (b0);
+                    _b1[ch].setTargetValue (-b0);
+                }
+            }
+        }
+
+    private:
+        double _fs = 0.0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b0;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _b1;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _a1;
+        std::vector<SampleType> _zPole;
+        std::vector<SampleType> _zZero;
+    };
+
+    template <typename SampleType = float>
+    class VariableDelayLine : public juce::dsp::ProcessorBase
+    {
+    public:
+        VariableDelayLine (size_t maxDelayInSamples, size_t numTaps = 1)
+            : _delayLine (maxDelayInSamples),
+              _numTaps (numTaps)
+        {
+        }
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _delayLine.prepare (spec.numChannels);
+            _delayInSamples.assign (spec.numChannels, std::vector<juce::LinearSmoothedValue<SampleType>> (_numTaps));
+
+            for (auto& channelDelays : _delayInSamples)
+                for (auto& delay : channelDelays)
+                    delay.reset (spec.sampleRate, 0.05);
+        }
+
+        virtual void reset() override
+        {
+            _delayLine.prepare (_delayInSamples.size());
+        }
+
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            auto& block = context.getOutputBlock();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+                for (size_t i = 0; i < block.getNumSamples(); i++)
+                {
+                    auto* samples = block.getChannelPointer (ch);
+
+                    _delayLine.pushSample (ch, static_cast<SampleType> (samples[i]));
+
+                    for (size_t n = 1; n < _numTaps; n++)
+                        _delayLine.popSample (ch, _delayInSamples[ch][n].getNextValue(), false);
+
+                    samples[i] = static_cast<float> (_delayLine.popSample (ch, _delayInSamples[ch][0].getNextValue()));
+                }
+        }
+
+        void setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex = 0, bool force = false)
+        {
+            for (auto& channelDelays : _delayInSamples)
+            {
+                if (force)
+                    channelDelays[tapIndex].setCurrentAndTargetValue (newDelayInSamples);
+                else
+                    channelDelays[tapIndex].setTargetValue (newDelayInSamples);
+            }
+        }
+
+        size_t getMaximumDelayInSamples() const
+        {
+            return _delayLine.getMaximumDelayInSamples();
+        }
+
+    private:
+        DelayLine<SampleType> _delayLine;
+        size_t _numTaps;
+        std::vector<std::vector<juce::LinearSmoothedValue<SampleType>>> _delayInSamples;
+    };
+
+    template <typename SampleType = float>
+    class VariableDelayAllpass : public juce::dsp::ProcessorBase
+    {
+    public:
+        VariableDelayAllpass (size_t maxDelayInSamples, size_t numTaps = 1)
+            : _delayLine (maxDelayInSamples),
+              _numTaps (numTaps)
+        {
+        }
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _delayLine.prepare (spec.numChannels);
+            _delayInSamples.assign (spec.numChannels, std::vector<juce::LinearSmoothedValue<SampleType>> (_numTaps));
+            _gain.assign (spec.numChannels, {});
+
+            for (size_t ch = 0; ch < spec.numChannels; ch++)
+            {
+                _gain[ch].reset (spec.sampleRate, 0.05);
+
+                for (auto& delay : _delayInSamples[ch])
+                    delay.reset (spec.sampleRate, 0.05);
+            }
+        }
+
+        virtual void reset() override
+        {
+            _delayLine.prepare (_delayInSamples.size());
+        }
+
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            auto& block = context.getOutputBlock();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++)
+                for (size_t i = 0; i < block.getNumSamples(); i++)
+                {
+                    auto* samples = block.getChannelPointer (ch);
+
+                    for (size_t n = 1; n < _numTaps; n++)
+                        _delayLine.popSample (ch, _delayInSamples[ch][n].getNextValue(), false);
+
+                    SampleType mainTapOut = _delayLine.popSample (ch, _delayInSamples[ch][0].getNextValue());
+
+                    // the gain smoother advances twice per sample, as it does in the module
+                    SampleType in = static_cast<SampleType> (samples[i]) - mainTapOut * _gain[ch].getNextValue();
+                    SampleType out = mainTapOut + in * _gain[ch].getNextValue();
+                    _delayLine.pushSample (ch, in);
+
+                    samples[i] = static_cast<float> (out);
+                }
+        }
+
+        void setDelayInSamples (SampleType newDelayInSamples, size_t tapIndex = 0, bool force = false)
+        {
+            for (auto& channelDelays : _delayInSamples)
+            {
+                if (force)
+                    channelDelays[tapIndex].setCurrentAndTargetValue (newDelayInSamples);
+                else
+                    channelDelays[tapIndex].setTargetValue (newDelayInSamples);
+            }
+        }
+
+        void setGain (SampleType newGain, bool force = false)
+        {
+            for (auto& gain : _gain)
+            {
+                if (force)
+                    gain.setCurrentAndTargetValue (newGain);
+                else
+                    gain.setTargetValue (newGain);
+            }
+        }
+
+        size_t getMaximumDelayInSamples() const
+        {
+            return _delayLine.getMaximumDelayInSamples();
+        }
+
+    private:
+        DelayLine<SampleType> _delayLine;
+        size_t _numTaps;
+        std::vector<std::vector<juce::LinearSmoothedValue<SampleType>>> _delayInSamples;
+        std::vector<juce::LinearSmoothedValue<SampleType>> _gain;
+    };
+} // namespace ReferenceModels
@@ -0,0 +1,168 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    class Identity : public juce::dsp::ProcessorBase
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            preparedSpec = spec;
+        }
+        virtual void reset() override {}
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>&) override {}
+
+        juce::dsp::ProcessSpec preparedSpec{ 0.0, 0, 0 };
+    };
+
+    std::unique_ptr<juce::dsp::ProcessorBase> makeIdentity (const juce::dsp::ProcessSpec& internalSpec, double)
+    {
+        auto identity = std::make_unique<Identity>();
+        identity->prepare (internalSpec);
+
+        return identity;
+    }
+
+    juce::AudioBuffer<float> generateSine (double frequency, double sampleRate, int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> sine (numChannels, numSamples);
+
+        for (auto ch = 0; ch < numChannels; ch++)
+            for (auto i = 0; i < numSamples; i++)
+                sine.setSample (ch, i, static_cast<float> (std::sin (juce::MathConstants<double>::twoPi * frequency * i / sampleRate)));
+
+        return sine;
+    }
+
+    // odd block sizes, so decimated samples fall at every position within a block
+    void processInBlocks (juce::dsp::ProcessorBase& processor, juce::AudioBuffer<float>& buffer, int maximumBlockSize)
+    {
+        juce::Random random (11);
+
+        for (auto i = 0; i < buffer.getNumSamples();)
+        {
+            const auto numSamples = juce::jmin (1 + random.nextInt (maximumBlockSize), buffer.getNumSamples() - i);
+            auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock (static_cast<size_t> (i), static_cast<size_t> (numSamples));
+
+            processor.process (juce::dsp::ProcessContextReplacing<float> (block));
+            i += numSamples;
+        }
+    }
+} // namespace
+
+TEST_CASE ("Resampled processor keeps the internal rate within an octave of the design rate", "[ResampledProcessor]")
+{
+    const std::vector<std::tuple<double, size_t, double>> expectations{
+        { 22050.0, 1, 22050.0 },
+        { 44100.0, 1, 44100.0 },
+        { 48000.0, 1, 48000.0 },
+        { 88200.0, 2, 44100.0 },
+        { 96000.0, 3, 32000.0 },
+        { 176400.0, 5, 35280.0 },
+        { 192000.0, 6, 32000.0 },
+    };
+
+    ResampledProcessor processor (makeIdentity);
+
+    for (const auto& [sampleRate, factor, internalSampleRate] : expectations)
+    {
+        processor.prepare ({ sampleRate, 512, 2 });
+
+        CHECK (processor.getFactor() == factor);
+        CHECK (processor.getInternalSampleRate() == internalSampleRate);
+
+        const auto& internalSpec = dynamic_cast<Identity&> (processor.getProcessor()).preparedSpec;
+        CHECK (internalSpec.sampleRate == internalSampleRate);
+        CHECK (internalSpec.maximumBlockSize * factor >= 512);
+        CHECK (internalSpec.numChannels == 2);
+    }
+}
+
+TEST_CASE ("Resampled processor passes the passband with a fixed latency", "[ResampledProcessor]")
+{
+    const auto sampleRate = GENERATE (96000.0, 192000.0);
+    const juce::dsp::ProcessSpec spec{ sampleRate, 300, 2 };
+
+    ResampledProcessor processor (makeIdentity);
+    processor.prepare (spec);
+
+    const auto latency = processor.getLatencyInSamples();
+    CHECK (latency > 0);
+
+    for (const auto frequency : { 100.0, 1000.0, 5000.0, 10000.0 })
+    {
+        processor.reset();
+
+        const auto input = generateSine (frequency, sampleRate, 2, 20000);
+        auto output = input;
+        processInBlocks (processor, output, 300);
+
+        for (auto ch = 0; ch < 2; ch++)
+            for (auto i = latency + 1000; i < output.getNumSamples(); i++)
+                if (std::abs (output.getSample (ch, i) - input.getSample (ch, i - latency)) > 0.01f)
+                {
+                    FAIL_CHECK (frequency << " Hz, channel " << ch << " sample " << i << ": " << output.getSample (ch, i) << " != " << input.getSample (ch, i - latency));
+                    break;
+                }
+    }
+}
+
+TEST_CASE ("Resampled processor rejects content above the internal Nyquist frequency", "[ResampledProcessor]")
+{
+    const juce::dsp::ProcessSpec spec{ 96000.0, 256, 1 };
+
+    ResampledProcessor processor (makeIdentity);
+    processor.prepare (spec);
+
+    // the internal rate is 32 kHz, these would alias to 10, 4 and 0 kHz
+    for (const auto frequency : { 22000.0, 28000.0, 32000.0, 40000.0 })
+    {
+        processor.reset();
+
+        auto output = generateSine (frequency, spec.sampleRate, 1, 20000);
+        processInBlocks (processor, output, 256);
+
+        CHECK (output.getMagnitude (0, 2000, 18000) < juce::Decibels::decibelsToGain (-50.0f));
+    }
+}
+
+TEST_CASE ("Resampled processor scales delays from the design rate", "[ResampledProcessor]")
+{
+    const auto sampleRate = GENERATE (48000.0, 96000.0, 192000.0);
+    const juce::dsp::ProcessSpec spec{ sampleRate, 512, 1 };
+    const auto designSampleRate = 29761.0;
+    const auto designDelay = 1000.0;
+
+    size_t maximumDelay = 0;
+
+    ResampledProcessor processor (
+        [&] (const juce::dsp::ProcessSpec& internalSpec, double delayScale)
+        {
+            maximumDelay = static_cast<size_t> (std::ceil (2000.0 * delayScale));
+
+            auto delayLine = std::make_unique<VariableDelayLine<float>> (maximumDelay);
+            delayLine->prepare (internalSpec);
+            delayLine->setDelayInSamples (static_cast<float> (designDelay * delayScale), 0, true);
+
+            return delayLine;
+        },
+        designSampleRate);
+    processor.prepare (spec);
+
+    // memory stays within an octave whatever the host rate
+    CHECK (maximumDelay >= 2000);
+    CHECK (maximumDelay < 4000);
+
+    auto output = TestHelpers::generateInputBuffer (1, 16384, 1.0f);
+    processInBlocks (processor, output, 512);
+
+    auto peak = 0;
+
+    for (auto i = 0; i < output.getNumSamples(); i++)
+        if (std::abs (output.getSample (0, i)) > std::abs (output.getSample (0, peak)))
+            peak = i;
+
+    const auto expectedPeak = designDelay / designSampleRate * sampleRate + processor.getLatencyInSamples();
+    CHECK (std::abs (peak - expectedPeak) <= static_cast<double> (processor.getFactor()));
+}
@@ -0,0 +1,198 @@
+#include "EquivalenceHarness.h"
+#include "ReferenceModels.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // prepares the processor with the given kernel variant forced
+    template <typename Processor>
+    class WithVariant : public Processor
+    {
+    public:
+        template <typename... Args>
+        WithVariant (SimdKernels::Variant variant, Args&&... args)
+            : Processor (std::forward<Args> (args)...),
+              _variant (variant)
+        {
+        }
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            SimdKernels::forceVariant (_variant);
+            Processor::prepare (spec);
+            SimdKernels::clearForcedVariant();
+        }
+
+    private:
+        SimdKernels::Variant _variant;
+    };
+
+    std::vector<SimdKernels::Variant> getSupportedVariants()
+    {
+        std::vector<SimdKernels::Variant> variants;
+
+        for (const auto variant : { SimdKernels::Variant::generic, SimdKernels::Variant::avx2, SimdKernels::Variant::avx512 })
+            if (SimdKernels::isSupported (variant))
+                variants.push_back (variant);
+
+        return variants;
+    }
+
+    EquivalenceHarness::Config getConfig()
+    {
+        EquivalenceHarness::Config config;
+        config.seed = GENERATE (1, 2);
+        config.spec.numChannels = 2;
+        config.numSamples = 1 << 15;
+
+        return config;
+    }
+} // namespace
+
+TEST_CASE ("Forcing a kernel variant overrides the CPUID choice", "[SimdKernels]")
+{
+    CHECK (SimdKernels::isSupported (SimdKernels::Variant::generic));
+    CHECK (SimdKernels::getActiveVariant() == SimdKernels::getBestSupportedVariant());
+
+    for (const auto variant : getSupportedVariants())
+    {
+        SimdKernels::forceVariant (variant);
+        CHECK (SimdKernels::getActiveVariant() == variant);
+    }
+
+    SimdKernels::clearForcedVariant();
+    CHECK (SimdKernels::getActiveVariant() == SimdKernels::getBestSupportedVariant());
+}
+
+TEST_CASE ("Block delay reads match single sample reads", "[SimdKernels][DelayBuffer]")
+{
+    const size_t maxDelay = 50;
+    const size_t numSamples = 40;
+
+    for (const auto variant : getSupportedVariants())
+    {
+        INFO (SimdKernels::getName (variant));
+
+        SimdKernels::forceVariant (variant);
+        DelayBuffer<float> delayBuffer (maxDelay);
+        delayBuffer.prepare ({ 48000.0, 64, 1 });
+        SimdKernels::clearForcedVariant();
+
+        juce::Random random (5);
+
+        // fill it, and move the pointers somewhere other than the start
+        for (size_t i = 0; i < 137; i++)
+        {
+            delayBuffer.pushSample (0, 2.0f * random.nextFloat() - 1.0f);
+            delayBuffer.popSample (0, 0.0f);
+        }
+
+        // out of range delays are clamped, fractions close to the ends wrap the second index
+        std::vector<float> delays (numSamples);
+
+        for (auto& delay : delays)
+            delay = -5.0f + (maxDelay + 10.0f) * random.nextFloat();
+
+        delays[0] = 0.0f;
+        delays[1] = static_cast<float> (maxDelay);
+        delays[2] = static_cast<float> (maxDelay) - 0.25f;
+        delays[3] = 0.5f;
+
+        std::vector<float> blockOutput (numSamples);
+        delayBuffer.readBlock (0, delays.data(), blockOutput.data(), numSamples);
+
+        for (size_t i = 0; i < numSamples; i++)
+            CHECK (blockOutput[i] == delayBuffer.popSample (0, delays[i]));
+    }
+}
+
+TEST_CASE ("Every kernel variant gives bit-identical output", "[SimdKernels]")
+{
+    using Variant = SimdKernels::Variant;
+
+    auto config = getConfig();
+
+    const auto automateCutoff = [] (juce::Random& random, auto& filter)
+    {
+        if (random.nextInt (4) == 0)
+            filter.setCutoffFrequency (20.0f * std::pow (1000.0f, random.nextFloat()), random.nextBool());
+    };
+
+    // delays down to zero and up to the maximum, so both the chunked and the per sample paths run
+    const size_t maxDelayInSamples = 300;
+    const size_t numTaps = 3;
+
+    const auto automateDelays = [&] (juce::Random& random, auto& delayLine)
+    {
+        for (size_t n = 0; n < numTaps; n++)
+            if (random.nextInt (3) == 0)
+                delayLine.setDelayInSamples (random.nextBool() ? random.nextFloat() * 3.0f : random.nextFloat() * (maxDelayInSamples - 1), n, random.nextBool());
+    };
+
+    for (const auto variant : getSupportedVariants())
+    {
+        INFO (SimdKernels::getName (variant));
+
+        {
+            WithVariant<OnePoleFilter::Lowpass<>> reference (Variant::generic);
+            WithVariant<OnePoleFilter::Lowpass<>> optimised (variant);
+
+            auto divergence = EquivalenceHarness::run (reference, optimised, config, automateCutoff);
+
+            INFO (EquivalenceHarness::toString (divergence));
+            CHECK_FALSE (divergence.found);
+        }
+
+        {
+            WithVariant<OnePoleFilter::Lowpass<double>> reference (Variant::generic);
+            WithVariant<OnePoleFilter::Lowpass<double>> optimised (variant);
+
+            reference.setBlockScan (true);
+            optimised.setBlockScan (true);
+
+            auto divergence = EquivalenceHarness::run (reference, optimised, config, automateCutoff);
+
+            INFO (EquivalenceHarness::toString (divergence));
+            CHECK_FALSE (divergence.found);
+        }
+
+        {
+            WithVariant<OnePoleFilter::Highpass<double>> reference (Variant::generic);
+            WithVariant<OnePoleFilter::Highpass<double>> optimised (variant);
+
+            auto divergence = EquivalenceHarness::run (reference, optimised, config, automateCutoff);
+
+            INFO (EquivalenceHarness::toString (divergence));
+            CHECK_FALSE (divergence.found);
+        }
+
+        {
+            ReferenceModels::VariableDelayLine<> reference (maxDelayInSamples, numTaps);
+            WithVariant<VariableDelayLine<>> optimised (variant, maxDelayInSamples, numTaps);
+
+            auto divergence = EquivalenceHarness::run (reference, optimised, config, automateDelays);
+
+            INFO (EquivalenceHarness::toString (divergence));
+            CHECK_FALSE (divergence.found);
+        }
+
+        {
+            ReferenceModels::VariableDelayAllpass<> reference (maxDelayInSamples, numTaps);
+            WithVariant<VariableDelayAllpass<>> optimised (variant, maxDelayInSamples, numTaps);
+
+            auto automate = [&] (juce::Random& random, auto& allpass)
+            {
+                automateDelays (random, allpass);
+
+                if (random.nextInt (4) == 0)
+                    allpass.setGain (1.9f * random.nextFloat() - 0.95f, random.nextBool());
+            };
+
+            auto divergence = EquivalenceHarness::run (reference, optimised, config, automate);
+
+            INFO (EquivalenceHarness::toString (divergence));
+            CHECK_FALSE (divergence.found);
+        }
+    }
+}
@@ -0,0 +1,361 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // an allpass whose delay is swept by a ProcessorModulator, saved and restored as one unit
+    class ModulatedAllpass : public juce::dsp::ProcessorBase
+    {
+    public:
+        ModulatedAllpass()
+            : _allpass (200),
+              _modulator (_oscillator, 16)
+        {
+            _oscillator.setWaveform (OscillatorWrapper::Sine);
+            _modulator.setProcessorToModulate (_allpass);
+            _modulator.setModulationTarget ([this] (float value) { _allpass.setDelayInSamples (value); });
+            _modulator.setModulationRange ({ 20.0f, 150.0f });
+        }
+
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            _allpass.prepare (spec);
+            _modulator.prepare (spec);
+            _allpass.setDelayInSamples (50.0f, 0, true);
+        }
+        virtual void reset() override
+        {
+            _allpass.reset();
+            _modulator.reset();
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            _modulator.process (context);
+        }
+
+        void setParameters (float frequency, float gain)
+        {
+            _modulator.setModulationFrequency (frequency);
+            _allpass.setGain (gain);
+        }
+
+        void saveState (StateWriter& writer) const
+        {
+            _allpass.saveState (writer);
+            _modulator.saveState (writer);
+        }
+        bool restoreState (StateReader& reader)
+        {
+            return _allpass.restoreState (reader) && _modulator.restoreState (reader);
+        }
+
+    private:
+        VariableDelayAllpass<float> _allpass;
+        OscillatorWrapper _oscillator;
+        ProcessorModulator<float> _modulator;
+    };
+
+    // Renders numBlocks blocks of noise in one go, and again split at every splitBlock: the first
+    // instance is saved there to a file and a fresh one restored from it through a
+    // juce::MemoryMappedFile, as it would be on another machine. Parameters move on every few
+    // blocks, so smoothers are mid-ramp at most split points.
+    template <typename Processor, typename Factory, typename Automation>
+    void checkResumeIsBitIdentical (Factory&& makeProcessor, Automation&& automate, size_t splitBlock)
+    {
+        const size_t numBlocks = 64;
+        const int blockSize = 100;
+        const int numChannels = 2;
+
+        juce::AudioBuffer<float> input (numChannels, blockSize * static_cast<int> (numBlocks));
+        juce::Random random (7);
+
+        for (auto ch = 0; ch < numChannels; ch++)
+            for (auto i = 0; i < input.getNumSamples(); i++)
+                input.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+        const auto render = [&] (Processor& processor, juce::AudioBuffer<float>& buffer, size_t firstBlock, size_t lastBlock)
+        {
+            for (auto block = firstBlock; block < lastBlock; block++)
+            {
+                automate (processor, block);
+
+                auto subBlock = juce::dsp::AudioBlock<float> (buffer).getSubBlock (block * blockSize, blockSize);
+                processor.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+            }
+        };
+
+        auto uninterrupted = input;
+        auto resumed = input;
+
+        std::unique_ptr<Processor> first = makeProcessor();
+        render (*first, uninterrupted, 0, numBlocks);
+
+        first = makeProcessor();
+        render (*first, resumed, 0, splitBlock);
+
+        juce::MemoryBlock state;
+        StateWriter writer (state);
+        first->saveState (writer);
+
+        juce::TemporaryFile file;
+        REQUIRE (file.getFile().replaceWithData (state.getData(), state.getSize()));
+
+        juce::MemoryMappedFile mappedFile (file.getFile(), juce::MemoryMappedFile::readOnly);
+        REQUIRE (mappedFile.getData() != nullptr);
+
+        StateReader reader (mappedFile.getData(), mappedFile.getSize());
+
+        std::unique_ptr<Processor> second = makeProcessor();
+        REQUIRE (second->restoreState (reader));
+        CHECK (reader.isExhausted());
+
+        render (*second, resumed, splitBlock, numBlocks);
+
+        for (auto ch = 0; ch < numChannels; ch++)
+            for (auto i = 0; i < input.getNumSamples(); i++)
+                if (resumed.getSample (ch, i) != uninterrupted.getSample (ch, i))
+                {
+                    FAIL_CHECK ("channel " << ch << " sample " << i << ": " << resumed.getSample (ch, i) << " != " << uninterrupted.getSample (ch, i));
+                    return;
+                }
+    }
+
+    const juce::dsp::ProcessSpec spec{ 48000.0, 100, 2 };
+} // namespace
+
+TEST_CASE ("Oscillator wrapper matches juce::dsp::Oscillator", "[StateSerialization]")
+{
+    const auto waveform = GENERATE (OscillatorWrapper::Sine, OscillatorWrapper::Saw, OscillatorWrapper::Square);
+    const auto useBlocks = GENERATE (false, true);
+
+    const std::function<float (float)> functions[] = {
+        [] (float x) { return std::sin (x); },
+        [] (float x) { return x / juce::MathConstants<float>::pi; },
+        [] (float x) { return x < 0.0f ? -1.0f : 1.0f; }
+    };
+
+    const juce::dsp::ProcessSpec spec{ 3000.0, 100, 2 };
+
+    OscillatorWrapper oscillator;
+    juce::dsp::Oscillator<float> reference;
+
+    oscillator.setWaveform (waveform);
+    reference.initialise (functions[waveform], 256);
+
+    oscillator.prepare (spec);
+    reference.prepare (spec);
+
+    juce::AudioBuffer<float> buffer (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    juce::AudioBuffer<float> expected (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+
+    for (size_t i = 0; i < 20000; i += spec.maximumBlockSize)
+    {
+        // changes land inside blocks, so both the ramping and the settled paths run
+        if (i % 5000 == 0)
+        {
+            oscillator.setFrequency (1.0f + static_cast<float> (i) / 1000.0f);
+            reference.setFrequency (1.0f + static_cast<float> (i) / 1000.0f);
+        }
+
+        if (useBlocks)
+        {
+            buffer.clear();
+            expected.clear();
+
+            TestHelpers::runProcess (oscillator, buffer);
+
+            juce::dsp::AudioBlock<float> block (expected);
+            reference.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+                for (int n = 0; n < buffer.getNumSamples(); n++)
+                    REQUIRE (buffer.getSample (ch, n) == expected.getSample (ch, n));
+        }
+        else
+        {
+            for (size_t n = 0; n < spec.maximumBlockSize; n++)
+                REQUIRE (oscillator.processSample (0.0f) == reference.processSample (0.0f));
+        }
+    }
+}
+
+TEST_CASE ("Resumed one pole filters are bit-identical", "[StateSerialization]")
+{
+    const auto split = GENERATE (1, 13, 40);
+
+    checkResumeIsBitIdentical<OnePoleFilter::Lowpass<float>> (
+        []
+        {
+            auto filter = std::make_unique<OnePoleFilter::Lowpass<float>>();
+            filter->prepare (spec);
+            filter->setCutoffFrequency (500.0f, true);
+            return filter;
+        },
+        [] (auto& filter, size_t block) { if (block % 7 == 0) filter.setCutoffFrequency (200.0f + 100.0f * static_cast<float> (block)); },
+        static_cast<size_t> (split));
+
+    checkResumeIsBitIdentical<OnePoleFilter::Highpass<double>> (
+        []
+        {
+            auto filter = std::make_unique<OnePoleFilter::Highpass<double>>();
+            filter->prepare (spec);
+            filter->setCutoffFrequency (500.0, true);
+            return filter;
+        },
+        [] (auto& filter, size_t block) { if (block % 7 == 0) filter.setCutoffFrequency (200.0 + 100.0 * static_cast<double> (block)); },
+        static_cast<size_t> (split));
+}
+
+TEST_CASE ("Resumed delay lines and allpasses are bit-identical", "[StateSerialization]")
+{
+    const auto split = GENERATE (1, 13, 40);
+
+    checkResumeIsBitIdentical<VariableDelayLine<float>> (
+        []
+        {
+            auto delayLine = std::make_unique<VariableDelayLine<float>> (3000, 2);
+            delayLine->prepare (spec);
+            delayLine->setDelayInSamples (1234.5f, 0, true);
+            delayLine->setDelayInSamples (77.0f, 1, true);
+            return delayLine;
+        },
+        [] (auto& delayLine, size_t block) { if (block % 5 == 0) delayLine.setDelayInSamples (500.0f + 37.3f * static_cast<float> (block)); },
+        static_cast<size_t> (split));
+
+    checkResumeIsBitIdentical<VariableDelayAllpass<double>> (
+        []
+        {
+            auto allpass = std::make_unique<VariableDelayAllpass<double>> (3000);
+            allpass->prepare (spec);
+            allpass->setDelayInSamples (321.25, 0, true);
+            allpass->setGain (0.6, true);
+            return allpass;
+        },
+        [] (auto& allpass, size_t block)
+        {
+            if (block % 5 == 0)
+            {
+                allpass.setDelayInSamples (100.0 + 41.1 * static_cast<double> (block));
+                allpass.setGain (block % 10 == 0 ? 0.3 : 0.7);
+            }
+        },
+        static_cast<size_t> (split));
+}
+
+TEST_CASE ("Resumed processor modulators are bit-identical", "[StateSerialization]")
+{
+    const auto split = GENERATE (1, 13, 40);
+
+    checkResumeIsBitIdentical<ModulatedAllpass> (
+        []
+        {
+            auto processor = std::make_unique<ModulatedAllpass>();
+            processor->prepare (spec);
+            processor->setParameters (3.0f, 0.5f);
+            return processor;
+        },
+        [] (auto& processor, size_t block) { if (block % 9 == 0) processor.setParameters (1.0f + static_cast<float> (block) / 8.0f, 0.4f); },
+        static_cast<size_t> (split));
+}
+
+TEST_CASE ("Smoothers resume their ramp exactly", "[StateSerialization]")
+{
+    const auto numSamplesBeforeSave = GENERATE (0, 1, 999, 2400, 3000);
+
+    const auto check = [numSamplesBeforeSave] (auto initial, auto target, auto nextTarget)
+    {
+        using Smoother = juce::LinearSmoothedValue<decltype (initial)>;
+
+        Smoother smoother;
+        smoother.reset (spec.sampleRate, 0.05);
+        smoother.setCurrentAndTargetValue (initial);
+        smoother.setTargetValue (target);
+
+        for (int i = 0; i < numSamplesBeforeSave; i++)
+            smoother.getNextValue();
+
+        juce::MemoryBlock state;
+        StateWriter writer (state);
+        writer.write (smoother);
+
+        Smoother restored;
+        restored.reset (spec.sampleRate, 0.05);
+
+        StateReader reader (state);
+        REQUIRE (reader.read (restored));
+        CHECK (reader.isExhausted());
+
+        for (int i = 0; i < 3000; i++)
+        {
+            if (i == 1000)
+            {
+                smoother.setTargetValue (nextTarget);
+                restored.setTargetValue (nextTarget);
+            }
+
+            REQUIRE (restored.getNextValue() == smoother.getNextValue());
+        }
+    };
+
+    check (0.3f, 0.9f, -0.1f);
+    check (1234.5, 17.25, 1234.5);
+    check (0.0f, 0.0f, 1.0f);
+}
+
+TEST_CASE ("Restoring into a differently prepared processor fails", "[StateSerialization]")
+{
+    VariableDelayLine<float> stereo (1000);
+    stereo.prepare (spec);
+
+    juce::MemoryBlock state;
+    StateWriter writer (state);
+    stereo.saveState (writer);
+
+    SECTION ("Channel count")
+    {
+        VariableDelayLine<float> mono (1000);
+        mono.prepare ({ spec.sampleRate, spec.maximumBlockSize, 1 });
+
+        StateReader reader (state);
+        CHECK (! mono.restoreState (reader));
+    }
+
+    SECTION ("Maximum delay")
+    {
+        VariableDelayLine<float> longer (2000);
+        longer.prepare (spec);
+
+        StateReader reader (state);
+        CHECK (! longer.restoreState (reader));
+    }
+
+    SECTION ("Processor type")
+    {
+        VariableDelayAllpass<float> allpass (1000);
+        allpass.prepare (spec);
+
+        StateReader reader (state);
+        CHECK (! allpass.restoreState (reader));
+    }
+
+    SECTION ("Other format version")
+    {
+        VariableDelayLine<float> same (1000);
+        same.prepare (spec);
+
+        const juce::uint32 otherVersion = StateWriter::formatVersion + 1;
+        std::memcpy (static_cast<char*> (state.getData()) + 4, &otherVersion, sizeof (otherVersion));
+
+        StateReader reader (state);
+        CHECK (! same.restoreState (reader));
+    }
+
+    SECTION ("Truncated data")
+    {
+        VariableDelayLine<float> same (1000);
+        same.prepare (spec);
+
+        StateReader reader (state.getData(), state.getSize() - 1);
+        CHECK (! same.restoreState (reader));
+    }
+}
@@ -36,6 +36,57 @@ namespace TestHelpers
             }
     }
 
+    TEST_CASE ("Test that getFrequencyResponse analyses every channel")
+    {
+        juce::AudioBuffer<float> impulseResponse (2, 8);
+        impulseResponse.clear();
+        impulseResponse.setSample (0, 0, 1.0f);
+        impulseResponse.setSample (1, 0, 2.0f);
+
+        ComplexBuffer complexBuffer = getFrequencyResponse (impulseResponse, 8);
+
+        for (size_t i = 0; i < 8; i++)
+        {
+            CHECK (complexBuffer[0][i].real() == 1.0f);
+            CHECK (complexBuffer[1][i].real() == 2.0f);
+        }
+    }
+
+    TEST_CASE ("Test that FrequencyResponseAnalyser matches the complex response helpers")
+    {
+        size_t fftSize = static_cast<size_t> (GENERATE (64, 256));
+
+        juce::AudioBuffer<float> impulseResponse (3, static_cast<int> (fftSize));
+        juce::Random random (42);
+
+        for (int ch = 0; ch < impulseResponse.getNumChannels(); ch++)
+            for (int i = 0; i < impulseResponse.getNumSamples(); i++)
+                impulseResponse.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        ComplexBuffer complexBuffer = getFrequencyResponse (impulseResponse, fftSize);
+        auto expectedMagnitude = getMagnitudeResponse (complexBuffer);
+        auto expectedPhase = getPhaseResponse (complexBuffer);
+
+        FrequencyResponseAnalyser analyser;
+
+        // analyse twice to make sure reused buffers don't keep stale data
+        analyser.analyse (impulseResponse, fftSize);
+        analyser.analyse (impulseResponse, fftSize);
+
+        const auto& actualMagnitude = analyser.getMagnitudeResponse();
+        const auto& actualPhase = analyser.getPhaseResponse();
+
+        REQUIRE (actualMagnitude.getNumChannels() == expectedMagnitude.getNumChannels());
+        REQUIRE (actualMagnitude.getNumSamples() == expectedMagnitude.getNumSamples());
+
+        for (int ch = 0; ch < actualMagnitude.getNumChannels(); ch++)
+            for (int i = 0; i < actualMagnitude.getNumSamples(); i++)
+            {
+                CHECK_THAT (actualMagnitude.getSample (ch, i), Catch::Matchers::WithinAbs (expectedMagnitude.getSample (ch, i), 1e-4));
+                CHECK_THAT (actualPhase.getSample (ch, i), Catch::Matchers::WithinAbs (expectedPhase.getSample (ch, i), 1e-4));
+            }
+    }
+
     TEST_CASE ("Test that getMagnitudeResponse returns correct values")
     {
         ComplexBuffer complexBuffer  { { { 1.0, 1.0 }, { 2.0, 2.0 } },
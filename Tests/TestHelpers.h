@@ -4,6 +4,7 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <juce_dsp/juce_dsp.h>
+#include <map>
 
 namespace TestHelpers
 {
@@ -46,6 +47,16 @@ namespace TestHelpers
         processorToRun.process (block);
     }
 
+    // for processors that also accept double buses, see MultiPrecisionProcessor
+    template <typename ProcessorType>
+    static void runProcess (ProcessorType& processorToRun, juce::AudioBuffer<double>& input)
+    {
+        juce::dsp::AudioBlock<double> block (input);
+        juce::dsp::ProcessContextReplacing<double> context (block);
+
+        processorToRun.process (context);
+    }
+
     static juce::AudioBuffer<float> generateInputBuffer (juce::uint32 numChannels, juce::uint32 numSamples, float sampleValue)
     {
         juce::AudioBuffer<float> input (static_cast<int> (numChannels), static_cast<int> (numSamples));
@@ -66,6 +77,19 @@ namespace TestHelpers
         return pulse;
     }
 
+    // FFT plans are expensive to build, so they are cached per size and per thread
+    static juce::dsp::FFT& getCachedFFT (size_t fftSize)
+    {
+        thread_local std::map<size_t, std::unique_ptr<juce::dsp::FFT>> ffts;
+
+        auto& fft = ffts[fftSize];
+
+        if (fft == nullptr)
+            fft = std::make_unique<juce::dsp::FFT> (static_cast<int> (std::log2 (fftSize)));
+
+        return *fft;
+    }
+
     static ComplexBuffer getFrequencyResponse (const juce::AudioBuffer<float>& impulseResponse, size_t fftSize)
     {
         size_t numSamples = static_cast<size_t> (impulseResponse.getNumSamples());
@@ -74,12 +98,12 @@ namespace TestHelpers
         assert (numSamples <= fftSize);
 
         // perform frequency response
-        juce::dsp::FFT fft (std::log2 (fftSize));
+        auto& fft = getCachedFFT (fftSize);
         juce::AudioBuffer<float> fftBuffer (numChannels, 2 * fftSize);
         fftBuffer.clear();
 
         for (size_t ch = 0; ch < numChannels; ch++)
-            fftBuffer.copyFrom (ch, 0, impulseResponse.getReadPointer (0), numSamples);
+            fftBuffer.copyFrom (ch, 0, impulseResponse.getReadPointer (ch), numSamples);
 
         for (size_t ch = 0; ch < numChannels; ch++)
             fft.performRealOnlyForwardTransform (fftBuffer.getWritePointer (ch));
@@ -91,8 +115,8 @@ namespace TestHelpers
         for (size_t ch = 0; ch < numChannels; ch++)
             for (size_t i = 0; i < fftSize; i++)
             {
-                multiChannelsFrequencyResponse[ch][i].real (fftBuffer.getSample (0, i * 2));
-                multiChannelsFrequencyResponse[ch][i].imag (fftBuffer.getSample (0, i * 2 + 1));
+                multiChannelsFrequencyResponse[ch][i].real (fftBuffer.getSample (ch, i * 2));
+                multiChannelsFrequencyResponse[ch][i].imag (fftBuffer.getSample (ch, i * 2 + 1));
             }
 
         return multiChannelsFrequencyResponse;
@@ -152,4 +176,66 @@ namespace TestHelpers
             return unwrappedPhase;
         }
     }
+
+    // Computes magnitude and phase responses for all channels of an impulse response in one pass,
+    // straight from the FFT output. The FFT plan and all buffers are reused between calls, so
+    // analysing thousands of parameter settings does not allocate after the first one of each size.
+    // The returned buffers stay valid until the next call to analyse().
+    class FrequencyResponseAnalyser
+    {
+    public:
+        void analyse (const juce::AudioBuffer<float>& impulseResponse, size_t fftSize, bool unwrap = true)
+        {
+            const auto numSamples = static_cast<size_t> (impulseResponse.getNumSamples());
+            const auto numChannels = impulseResponse.getNumChannels();
+            const auto numBins = static_cast<int> (fftSize / 2);
+
+            jassert (numSamples <= fftSize);
+
+            auto& fft = getCachedFFT (fftSize);
+
+            _fftBuffer.setSize (numChannels, static_cast<int> (2 * fftSize), false, false, true);
+            _magnitudeResponse.setSize (numChannels, numBins, false, false, true);
+            _phaseResponse.setSize (numChannels, numBins, false, false, true);
+            _wrappedPhase.setSize (1, numBins, false, false, true);
+
+            for (auto ch = 0; ch < numChannels; ch++)
+            {
+                auto* data = _fftBuffer.getWritePointer (ch);
+
+                std::copy (impulseResponse.getReadPointer (ch), impulseResponse.getReadPointer (ch) + numSamples, data);
+                std::fill (data + numSamples, data + 2 * fftSize, 0.0f);
+
+                fft.performRealOnlyForwardTransform (data, true);
+
+                auto* magnitude = _magnitudeResponse.getWritePointer (ch);
+                auto* phase = unwrap ? _wrappedPhase.getWritePointer (0) : _phaseResponse.getWritePointer (ch);
+
+                for (auto i = 0; i < numBins; i++)
+                {
+                    magnitude[i] = std::hypot (data[2 * i], data[2 * i + 1]);
+                    phase[i] = std::atan2 (data[2 * i + 1], data[2 * i]);
+                }
+
+                if (unwrap)
+                    unwrapPhase (phase, _phaseResponse.getWritePointer (ch), static_cast<size_t> (numBins));
+            }
+        }
+
+        const juce::AudioBuffer<float>& getMagnitudeResponse() const
+        {
+            return _magnitudeResponse;
+        }
+
+        const juce::AudioBuffer<float>& getPhaseResponse() const
+        {
+            return _phaseResponse;
+        }
+
+    private:
+        juce::AudioBuffer<float> _fftBuffer;
+        juce::AudioBuffer<float> _magnitudeResponse;
+        juce::AudioBuffer<float> _phaseResponse;
+        juce::AudioBuffer<float> _wrappedPhase;
+    };
 } // namespace TestHelpers
@@ -0,0 +1,196 @@
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // passes audio through, remembering the size of every block
+    class BlockSizeRecorder : public MultiPrecisionProcessor
+    {
+    public:
+        virtual void prepare (const juce::dsp::ProcessSpec& spec) override
+        {
+            maximumBlockSize = spec.maximumBlockSize;
+        }
+        virtual void reset() override
+        {
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<float>& context) override
+        {
+            blockSizes.push_back (context.getOutputBlock().getNumSamples());
+        }
+        virtual void process (const juce::dsp::ProcessContextReplacing<double>& context) override
+        {
+            blockSizes.push_back (context.getOutputBlock().getNumSamples());
+        }
+
+        juce::uint32 maximumBlockSize = 0;
+        std::vector<size_t> blockSizes;
+    };
+
+    // predelay swept by a modulator -> lowpass -> allpass
+    template <typename SampleType>
+    struct Chain
+    {
+        Chain()
+            : modulator (oscillator, 100)
+        {
+            oscillator.setWaveform (OscillatorWrapper::Sine);
+            modulator.setProcessorToModulate (delayLine);
+            modulator.setModulationTarget ([this] (SampleType value) { delayLine.setDelayInSamples (value); });
+            modulator.setModulationRange ({ static_cast<SampleType> (100), static_cast<SampleType> (300) });
+            modulator.setModulationFrequency (3.0f);
+        }
+
+        void setParameters()
+        {
+            delayLine.setDelayInSamples (static_cast<SampleType> (200), 0, true);
+            lowpassFilter.setCutoffFrequency (static_cast<SampleType> (3000), true);
+            allpass.setDelayInSamples (static_cast<SampleType> (141.5), 0, true);
+            allpass.setGain (static_cast<SampleType> (0.6), true);
+        }
+
+        VariableDelayLine<SampleType> delayLine{ 1000 };
+        OscillatorWrapper oscillator;
+        ProcessorModulator<SampleType> modulator;
+        OnePoleFilter::Lowpass<SampleType> lowpassFilter;
+        VariableDelayAllpass<SampleType> allpass{ 400 };
+    };
+
+    template <typename SampleType>
+    void checkTiledMatchesWholeBlocks (size_t tileSize)
+    {
+        const juce::dsp::ProcessSpec spec{ 48000.0, 4096, 2 };
+        const int numBlocks = 4;
+
+        Chain<SampleType> tiled;
+        Chain<SampleType> whole;
+
+        TiledChain chain (tileSize);
+        chain.addProcessor (tiled.modulator);
+        chain.addProcessor (tiled.lowpassFilter);
+        chain.addProcessor (tiled.allpass);
+
+        // the modulated line is the caller's to prepare, the chain prepares the rest for tiles
+        tiled.delayLine.prepare (spec);
+        chain.prepare (spec);
+        tiled.setParameters();
+
+        whole.delayLine.prepare (spec);
+        whole.modulator.prepare (spec);
+        whole.lowpassFilter.prepare (spec);
+        whole.allpass.prepare (spec);
+        whole.setParameters();
+
+        juce::Random random (5);
+        juce::AudioBuffer<SampleType> tiledBuffer (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+
+        for (int block = 0; block < numBlocks; block++)
+        {
+            for (int ch = 0; ch < tiledBuffer.getNumChannels(); ch++)
+                for (int i = 0; i < tiledBuffer.getNumSamples(); i++)
+                    tiledBuffer.setSample (ch, i, static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f));
+
+            auto wholeBuffer = tiledBuffer;
+
+            // a ramp across tiles
+            if (block == 2)
+            {
+                tiled.lowpassFilter.setCutoffFrequency (static_cast<SampleType> (6000));
+                whole.lowpassFilter.setCutoffFrequency (static_cast<SampleType> (6000));
+                tiled.allpass.setGain (static_cast<SampleType> (-0.3));
+                whole.allpass.setGain (static_cast<SampleType> (-0.3));
+            }
+
+            TestHelpers::runProcess (chain, tiledBuffer);
+            TestHelpers::runProcess (whole.modulator, wholeBuffer);
+            TestHelpers::runProcess (whole.lowpassFilter, wholeBuffer);
+            TestHelpers::runProcess (whole.allpass, wholeBuffer);
+
+            for (int ch = 0; ch < tiledBuffer.getNumChannels(); ch++)
+                for (int i = 0; i < tiledBuffer.getNumSamples(); i++)
+                    if (tiledBuffer.getSample (ch, i) != wholeBuffer.getSample (ch, i))
+                    {
+                        FAIL_CHECK ("block " << block << " channel " << ch << " sample " << i << ": " << tiledBuffer.getSample (ch, i) << " != " << wholeBuffer.getSample (ch, i));
+                        return;
+                    }
+        }
+    }
+} // namespace
+
+TEST_CASE ("Tiled chains match processing whole blocks", "[TiledChain]")
+{
+    const auto tileSize = GENERATE (as<size_t>{}, 64, 128, 256, 1000);
+
+    SECTION ("Float")
+    {
+        checkTiledMatchesWholeBlocks<float> (tileSize);
+    }
+
+    SECTION ("Double")
+    {
+        checkTiledMatchesWholeBlocks<double> (tileSize);
+    }
+}
+
+TEST_CASE ("Tiled chains prepare processors for tiles", "[TiledChain]")
+{
+    BlockSizeRecorder recorder;
+    TiledChain chain (128);
+    chain.addProcessor (recorder);
+
+    chain.prepare ({ 48000.0, 16384, 2 });
+    CHECK (recorder.maximumBlockSize == 128);
+
+    chain.prepare ({ 48000.0, 32, 2 });
+    CHECK (recorder.maximumBlockSize == 32);
+
+    juce::AudioBuffer<float> buffer (2, 300);
+    buffer.clear();
+    chain.prepare ({ 48000.0, 300, 2 });
+    TestHelpers::runProcess (chain, buffer);
+
+    CHECK (recorder.blockSizes == std::vector<size_t>{ 128, 128, 44 });
+}
+
+TEST_CASE ("Tiles end on modulator control ticks", "[TiledChain]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 4096, 1 };
+
+    BlockSizeRecorder modulated;
+    BlockSizeRecorder tileRecorder;
+    OscillatorWrapper oscillator;
+    ProcessorModulator<float> modulator (oscillator, 100);
+    oscillator.setWaveform (OscillatorWrapper::Sine);
+    modulator.setProcessorToModulate (modulated);
+    modulator.setModulationFrequency (1.0f);
+
+    TiledChain chain (256);
+    chain.addProcessor (modulator);
+    chain.addProcessor (tileRecorder);
+    chain.prepare (spec);
+
+    juce::AudioBuffer<float> buffer (1, 1000);
+    buffer.clear();
+
+    // 70 samples leave 30 until the next tick
+    auto firstBlock = juce::dsp::AudioBlock<float> (buffer).getSubBlock (0, 70);
+    chain.process (juce::dsp::ProcessContextReplacing<float> (firstBlock));
+    CHECK (modulator.getSamplesUntilNextUpdate() == 30);
+
+    tileRecorder.blockSizes.clear();
+    modulated.blockSizes.clear();
+    TestHelpers::runProcess (chain, buffer);
+
+    // 30 + 200 ends on a tick and is the longest such length under 256, the last tile is what's left
+    CHECK (tileRecorder.blockSizes == std::vector<size_t>{ 230, 200, 200, 200, 170 });
+
+    // so the modulator only ever sees whole update periods, up to the end of the block
+    CHECK (modulated.blockSizes == std::vector<size_t>{ 30, 100, 100, 100, 100, 100, 100, 100, 100, 100, 70 });
+
+    // without modulation the tiles are left alone
+    modulator.setModulationEnabled (false);
+    tileRecorder.blockSizes.clear();
+    TestHelpers::runProcess (chain, buffer);
+
+    CHECK (tileRecorder.blockSizes == std::vector<size_t>{ 256, 256, 256, 232 });
+}
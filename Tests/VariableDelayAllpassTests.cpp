@@ -1,3 +1,4 @@
+#include "ParameterSweep.h"
 #include "TestHelpers.h"
 #include <shared_modules/shared_modules.h>
 
@@ -14,6 +15,8 @@ TEST_CASE ("Test allpass filter with different cutoff frequencies", "[VariableDe
 
     size_t fftSize = spec.maximumBlockSize;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const size_t frequencyIndex)
     {
         float fc = spec.sampleRate / static_cast<float> (fftSize) * (frequencyIndex);
@@ -23,9 +26,9 @@ TEST_CASE ("Test allpass filter with different cutoff frequencies", "[VariableDe
         allpass.setGain (c, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (allpass, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
-        juce::AudioBuffer<float> phaseResponse = TestHelpers::getPhaseResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
+        const auto& phaseResponse = analyser.getPhaseResponse();
 
         for (size_t ch = 0; ch < spec.numChannels; ch++)
         {
@@ -63,14 +66,16 @@ TEST_CASE ("Test allpass filter with different delays", "[VariableDelayAllpass]"
     float c = (tan (M_PI * fc / fs) - 1) / (tan (M_PI * fc / fs) + 1);
     allpass.setGain (c, true);
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (std::pair<float, float> expectedPhasePerDelay)
     {
         allpass.setDelayInSamples (expectedPhasePerDelay.first, 0, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (allpass, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
-        juce::AudioBuffer<float> phaseResponse = TestHelpers::getPhaseResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
+        const auto& phaseResponse = analyser.getPhaseResponse();
 
         for (size_t ch = 0; ch < spec.numChannels; ch++)
         {
@@ -129,6 +134,8 @@ TEST_CASE ("Test process with different sample rates", "[VariableDelayAllpass]")
 
     size_t frequencyIndex = 10;
 
+    TestHelpers::FrequencyResponseAnalyser analyser;
+
     const auto runTest = [&] (const float& fs)
     {
         juce::dsp::ProcessSpec spec{ fs, 256, 2 };
@@ -143,9 +150,9 @@ TEST_CASE ("Test process with different sample rates", "[VariableDelayAllpass]")
         allpass.setGain (c, true);
 
         juce::AudioBuffer<float> impulseResponse = TestHelpers::impulseResponseGenerator (allpass, spec.numChannels, spec.maximumBlockSize);
-        TestHelpers::ComplexBuffer frequencyResponse = TestHelpers::getFrequencyResponse (impulseResponse, fftSize);
-        juce::AudioBuffer<float> magnitudeResponse = TestHelpers::getMagnitudeResponse (frequencyResponse);
-        juce::AudioBuffer<float> phaseResponse = TestHelpers::getPhaseResponse (frequencyResponse);
+        analyser.analyse (impulseResponse, fftSize);
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
+        const auto& phaseResponse = analyser.getPhaseResponse();
 
         for (size_t ch = 0; ch < spec.numChannels; ch++)
         {
@@ -163,3 +170,159 @@ TEST_CASE ("Test process with different sample rates", "[VariableDelayAllpass]")
     for (auto& s : sampleRates)
         runTest (s);
 }
+
+TEST_CASE ("Test allpass filter with double precision state", "[VariableDelayAllpass]")
+{
+    float fs = 48000;
+
+    VariableDelayAllpass<float> floatAllpass (50);
+    VariableDelayAllpass<double> doubleAllpass (50);
+
+    juce::dsp::ProcessSpec spec{ fs, 1024, 2 };
+    floatAllpass.prepare (spec);
+    doubleAllpass.prepare (spec);
+
+    floatAllpass.setGain (0.7f, true);
+    doubleAllpass.setGain (0.7, true);
+    floatAllpass.setDelayInSamples (15.0f, 0, true);
+    doubleAllpass.setDelayInSamples (15.0, 0, true);
+
+    juce::AudioBuffer<float> floatResponse = TestHelpers::impulseResponseGenerator (floatAllpass, spec.numChannels, spec.maximumBlockSize);
+
+    juce::AudioBuffer<double> doubleResponse (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    doubleResponse.clear();
+
+    for (auto ch = 0; ch < doubleResponse.getNumChannels(); ch++)
+        doubleResponse.setSample (ch, 0, 1.0);
+
+    TestHelpers::runProcess (doubleAllpass, doubleResponse);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+    {
+        double energy = 0.0;
+
+        for (size_t i = 0; i < spec.maximumBlockSize; i++)
+        {
+            CHECK_THAT (doubleResponse.getSample (ch, i), Catch::Matchers::WithinAbs (floatResponse.getSample (ch, i), 1e-5));
+            energy += doubleResponse.getSample (ch, i) * doubleResponse.getSample (ch, i);
+        }
+
+        // an allpass preserves the energy of the impulse
+        CHECK_THAT (energy, Catch::Matchers::WithinAbs (1.0, 1e-6));
+    }
+}
+
+TEST_CASE ("Test allpass filter stays allpass across a parameter sweep", "[VariableDelayAllpass][ParameterSweep]")
+{
+    const size_t fftSize = 8192;
+    const juce::uint32 numChannels = 2;
+
+    ParameterSweep::Grid grid;
+    grid.sampleRates = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    grid.delaysInSamples = { 1.0, 2.0, 7.0, 15.0, 32.0, 50.0 };
+    grid.gains = { -0.9, -0.5, 0.0, 0.3, 0.7, 0.9 };
+    grid.blockSizes = { 1, 64, 1000 };
+
+    const auto makeAllpass = [] { return std::make_unique<VariableDelayAllpass<>> (64); };
+
+    const auto check = [&] (VariableDelayAllpass<>& allpass, const ParameterSweep::Point& point, TestHelpers::FrequencyResponseAnalyser& analyser) -> std::string {
+        allpass.prepare ({ point.sampleRate, point.blockSize, numChannels });
+        allpass.setDelayInSamples (static_cast<float> (point.delayInSamples), 0, true);
+        allpass.setGain (static_cast<float> (point.gain), true);
+
+        auto impulseResponse = ParameterSweep::getImpulseResponse (allpass, numChannels, fftSize, point.blockSize);
+        analyser.analyse (impulseResponse, fftSize, false);
+
+        const auto& magnitudeResponse = analyser.getMagnitudeResponse();
+
+        for (size_t ch = 0; ch < numChannels; ch++)
+            for (size_t i = 0; i < fftSize / 2; i++)
+            {
+                const auto decibels = juce::Decibels::gainToDecibels (magnitudeResponse.getSample (ch, i));
+
+                if (std::abs (decibels) > 1e-2f)
+                    return "channel " + std::to_string (ch) + ", bin " + std::to_string (i) + ": " + std::to_string (decibels) + " dB";
+            }
+
+        return {};
+    };
+
+    ParameterSweep::requireNoFailures (ParameterSweep::run (grid, makeAllpass, check));
+}
+
+TEST_CASE ("Test allpass parameters survive re-preparing with fewer channels", "[VariableDelayAllpass]")
+{
+    const juce::dsp::ProcessSpec stereo{ 48000.0, 256, 2 };
+    const juce::dsp::ProcessSpec mono{ 48000.0, 256, 1 };
+    const VariableDelayAllpass<>::Parameters parameters{ { 15.0f }, 0.5f };
+
+    VariableDelayAllpass<> allpass (50);
+    allpass.prepare (stereo);
+    allpass.prepare (mono);
+    allpass.setParameters (parameters, true);
+
+    // the idle second channel keeps what was set while it was idle
+    allpass.prepare (stereo);
+
+    VariableDelayAllpass<> expected (50);
+    expected.prepare (stereo);
+    expected.setParameters (parameters, true);
+
+    const auto response = TestHelpers::impulseResponseGenerator (allpass, stereo.numChannels, stereo.maximumBlockSize);
+    const auto expectedResponse = TestHelpers::impulseResponseGenerator (expected, stereo.numChannels, stereo.maximumBlockSize);
+
+    for (int ch = 0; ch < response.getNumChannels(); ch++)
+        for (int i = 0; i < response.getNumSamples(); i++)
+            REQUIRE (response.getSample (ch, i) == expectedResponse.getSample (ch, i));
+}
+
+TEST_CASE ("Test allpass blocks longer than the prepared maximum are processed in chunks", "[VariableDelayAllpass]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 64, 2 };
+    const auto blockSize = static_cast<int> (spec.maximumBlockSize);
+    const auto smoothing = GENERATE (false, true);
+
+    VariableDelayAllpass<float> chunked (1000, 2);
+    VariableDelayAllpass<float> reference (1000, 2);
+
+    for (auto* allpass : { &chunked, &reference })
+    {
+        allpass->prepare (spec);
+        allpass->setDelayInSamples (10.5f, 0, true);
+        allpass->setDelayInSamples (30.0f, 1, true);
+        allpass->setGain (0.6f, true);
+
+        if (smoothing)
+            allpass->setGain (-0.3f);
+    }
+
+    juce::AudioBuffer<float> input (static_cast<int> (spec.numChannels), 2 * blockSize);
+    juce::Random random (5);
+
+    for (int ch = 0; ch < input.getNumChannels(); ch++)
+        for (int i = 0; i < input.getNumSamples(); i++)
+            input.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+    auto expected = input;
+    juce::dsp::AudioBlock<float> expectedBlock (expected);
+
+    for (int start = 0; start < expected.getNumSamples(); start += blockSize)
+    {
+        auto subBlock = expectedBlock.getSubBlock (static_cast<size_t> (start), spec.maximumBlockSize);
+        reference.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+    }
+
+    auto actual = input;
+    TestHelpers::runProcess (chunked, actual);
+
+    for (int ch = 0; ch < actual.getNumChannels(); ch++)
+    {
+        for (int i = 0; i < actual.getNumSamples(); i++)
+            REQUIRE (actual.getSample (ch, i) == expected.getSample (ch, i));
+
+        // the tap outputs of the last chunk
+        for (size_t n = 0; n < 2; n++)
+            for (size_t i = 0; i < spec.maximumBlockSize; i++)
+                REQUIRE (chunked.getTapOutBuffer (static_cast<size_t> (ch), n)[i] == reference.getTapOutBuffer (static_cast<size_t> (ch), n)[i]);
+    }
+}
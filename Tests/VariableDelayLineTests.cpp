@@ -1,3 +1,4 @@
+#include "ParameterSweep.h"
 #include "TestHelpers.h"
 #include <shared_modules/shared_modules.h>
 
@@ -101,3 +102,125 @@ TEST_CASE ("Test process calling setDelayInSamples", "[VariableDelayLine]")
     for (auto& expected : expectedBufferIndexPerDelay)
         runTest (expected);
 }
+
+TEST_CASE ("Test process with double precision", "[VariableDelayLine]")
+{
+    float fs = 48000;
+    double sampleValue = 0.1234567890123;
+    std::vector<double> delayInSamples = { 5.25, 3.0, 1.5 };
+
+    VariableDelayLine<double> delayLine (10, 3);
+
+    juce::dsp::ProcessSpec spec{ fs, static_cast<juce::uint32> (delayLine.getMaximumDelayInSamples()), 2 };
+    delayLine.prepare (spec);
+
+    for (size_t i = 0; i < delayInSamples.size(); i++)
+        delayLine.setDelayInSamples (delayInSamples[i], i, true);
+
+    juce::AudioBuffer<double> input (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    input.clear();
+
+    for (auto ch = 0; ch < input.getNumChannels(); ch++)
+        input.setSample (ch, 0, sampleValue);
+
+    TestHelpers::runProcess (delayLine, input);
+
+    for (size_t ch = 0; ch < spec.numChannels; ch++)
+    {
+        // the output is the main tap, read without any float rounding
+        CHECK (input.getSample (ch, 5) == sampleValue * 0.75);
+        CHECK (input.getSample (ch, 6) == sampleValue * 0.25);
+
+        CHECK (delayLine.getTapOutBuffer (ch, 1)[3] == sampleValue);
+        CHECK (delayLine.getTapOutBuffer (ch, 2)[1] == sampleValue * 0.5);
+    }
+}
+
+TEST_CASE ("Test delayed impulses across a parameter sweep", "[VariableDelayLine][ParameterSweep]")
+{
+    const size_t length = 512;
+    const juce::uint32 numChannels = 2;
+
+    ParameterSweep::Grid grid;
+    grid.sampleRates = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    grid.delaysInSamples = { 0.0, 1.0, 2.5, 7.25, 63.0, 100.75, 255.5 };
+    grid.blockSizes = { 1, 3, 64, 256, 512 };
+
+    const auto makeDelayLine = [] { return std::make_unique<VariableDelayLine<>> (300); };
+
+    // linear interpolation splits the impulse over the two neighbouring samples
+    const auto check = [&] (VariableDelayLine<>& delayLine, const ParameterSweep::Point& point, TestHelpers::FrequencyResponseAnalyser&) -> std::string {
+        delayLine.prepare ({ point.sampleRate, point.blockSize, numChannels });
+        delayLine.setDelayInSamples (static_cast<float> (point.delayInSamples), 0, true);
+
+        auto impulseResponse = ParameterSweep::getImpulseResponse (delayLine, numChannels, length, point.blockSize);
+
+        const auto delayInteger = static_cast<size_t> (point.delayInSamples);
+        const auto delayFraction = static_cast<float> (point.delayInSamples - delayInteger);
+
+        for (size_t ch = 0; ch < numChannels; ch++)
+            for (size_t i = 0; i < length; i++)
+            {
+                auto expected = i == delayInteger ? 1.0f - delayFraction : i == delayInteger + 1 ? delayFraction : 0.0f;
+                auto actual = impulseResponse.getSample (static_cast<int> (ch), static_cast<int> (i));
+
+                if (std::abs (actual - expected) > 1e-6f)
+                    return "channel " + std::to_string (ch) + ", sample " + std::to_string (i) + ": " + std::to_string (actual)
+                           + ", expected " + std::to_string (expected);
+            }
+
+        return {};
+    };
+
+    ParameterSweep::requireNoFailures (ParameterSweep::run (grid, makeDelayLine, check));
+}
+
+TEST_CASE ("Test blocks longer than the prepared maximum are processed in chunks", "[VariableDelayLine]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 64, 2 };
+    const auto blockSize = static_cast<int> (spec.maximumBlockSize);
+    const auto smoothing = GENERATE (false, true);
+
+    VariableDelayLine<float> chunked (1000, 2);
+    VariableDelayLine<float> reference (1000, 2);
+
+    for (auto* delayLine : { &chunked, &reference })
+    {
+        delayLine->prepare (spec);
+        delayLine->setDelayInSamples (10.5f, 0, true);
+        delayLine->setDelayInSamples (30.0f, 1, true);
+
+        if (smoothing)
+            delayLine->setDelayInSamples (20.25f);
+    }
+
+    juce::AudioBuffer<float> input (static_cast<int> (spec.numChannels), 2 * blockSize);
+    juce::Random random (5);
+
+    for (int ch = 0; ch < input.getNumChannels(); ch++)
+        for (int i = 0; i < input.getNumSamples(); i++)
+            input.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+    auto expected = input;
+    juce::dsp::AudioBlock<float> expectedBlock (expected);
+
+    for (int start = 0; start < expected.getNumSamples(); start += blockSize)
+    {
+        auto subBlock = expectedBlock.getSubBlock (static_cast<size_t> (start), spec.maximumBlockSize);
+        reference.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+    }
+
+    auto actual = input;
+    TestHelpers::runProcess (chunked, actual);
+
+    for (int ch = 0; ch < actual.getNumChannels(); ch++)
+    {
+        for (int i = 0; i < actual.getNumSamples(); i++)
+            REQUIRE (actual.getSample (ch, i) == expected.getSample (ch, i));
+
+        // the tap outputs of the last chunk
+        for (size_t n = 0; n < 2; n++)
+            for (size_t i = 0; i < spec.maximumBlockSize; i++)
+                REQUIRE (chunked.getTapOutBuffer (static_cast<size_t> (ch), n)[i] == reference.getTapOutBuffer (static_cast<size_t> (ch), n)[i]);
+    }
+}
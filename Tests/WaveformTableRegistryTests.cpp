@@ -0,0 +1,144 @@
+#include "RealtimeSafetyChecker.h"
+#include "TestHelpers.h"
+#include <shared_modules/shared_modules.h>
+
+namespace
+{
+    // one period at the given rate, x in [-pi, pi)
+    std::vector<float> renderPeriod (OscillatorWrapper& oscillator, size_t numSamples)
+    {
+        oscillator.prepare ({ static_cast<double> (numSamples), 1, 1 });
+        oscillator.setFrequency (1.0f);
+        oscillator.reset();
+
+        std::vector<float> period;
+
+        for (size_t i = 0; i < numSamples; i++)
+            period.push_back (oscillator.processSample (0.0f));
+
+        return period;
+    }
+} // namespace
+
+TEST_CASE ("Oscillators share their tables", "[WaveformTableRegistry]")
+{
+    auto& registry = WaveformTableRegistry::getInstance();
+
+    const auto& sine = registry.getTable (OscillatorWrapper::Sine, 64);
+    const auto numTables = registry.getNumTables();
+
+    CHECK (&registry.getTable (OscillatorWrapper::Sine, 64) == &sine);
+    CHECK (registry.getNumTables() == numTables);
+
+    CHECK (&registry.getTable (OscillatorWrapper::Sine, 65) != &sine);
+    CHECK (&registry.getTable (OscillatorWrapper::Saw, 64) != &sine);
+    CHECK (registry.getNumTables() == numTables + 2);
+
+    // hundreds of modulators add no tables
+    std::array<OscillatorWrapper, 200> oscillators;
+
+    for (auto& oscillator : oscillators)
+        oscillator.setWaveform (OscillatorWrapper::Sine, 64);
+
+    CHECK (registry.getNumTables() == numTables + 2);
+}
+
+TEST_CASE ("Table waveforms keep their exact shape", "[WaveformTableRegistry]")
+{
+    const size_t periodLength = 1000;
+    OscillatorWrapper oscillator;
+
+    SECTION ("Sine is the plain table")
+    {
+        oscillator.setWaveform (OscillatorWrapper::Sine);
+        const auto period = renderPeriod (oscillator, periodLength);
+
+        for (size_t i = 0; i < periodLength; i++)
+            CHECK_THAT (period[i], Catch::Matchers::WithinAbs (std::sin (juce::MathConstants<float>::twoPi * static_cast<float> (i) / periodLength - juce::MathConstants<float>::pi), 1.0e-3));
+    }
+
+    // LFO shapes: no rounding or ringing, only the table interpolation at the jump
+    SECTION ("Saw")
+    {
+        oscillator.setWaveform (OscillatorWrapper::Saw);
+        const auto period = renderPeriod (oscillator, periodLength);
+
+        for (size_t i = 0; i < periodLength; i++)
+            CHECK_THAT (period[i], Catch::Matchers::WithinAbs (2.0f * static_cast<float> (i) / periodLength - 1.0f, 1.0e-3));
+    }
+
+    SECTION ("Square")
+    {
+        oscillator.setWaveform (OscillatorWrapper::Square);
+        const auto period = renderPeriod (oscillator, periodLength);
+        const auto numTransitionSamples = periodLength / 256 + 1;
+
+        for (size_t i = 0; i < periodLength; i++)
+            if (i < periodLength / 2 - numTransitionSamples)
+                CHECK (period[i] == -1.0f);
+            else if (i >= periodLength / 2 + numTransitionSamples)
+                CHECK (period[i] == 1.0f);
+    }
+
+    SECTION ("Random oscillators share the table but not the start phase")
+    {
+        OscillatorWrapper other;
+        oscillator.setWaveform (OscillatorWrapper::Random);
+        other.setWaveform (OscillatorWrapper::Random);
+
+        const auto period = renderPeriod (oscillator, periodLength);
+
+        CHECK (renderPeriod (oscillator, periodLength) == period);
+        CHECK (renderPeriod (other, periodLength) != period);
+
+        // switching back to a fixed shape starts at phase 0 again
+        oscillator.setWaveform (OscillatorWrapper::Saw);
+        CHECK_THAT (renderPeriod (oscillator, periodLength)[0], Catch::Matchers::WithinAbs (-1.0f, 1.0e-3));
+    }
+}
+
+TEST_CASE ("Waveforms switch while the audio thread runs", "[WaveformTableRegistry]")
+{
+    const juce::dsp::ProcessSpec spec{ 48000.0, 64, 1 };
+
+    OscillatorWrapper oscillator;
+    oscillator.prepare (spec);
+    oscillator.setFrequency (1000.0f);
+    oscillator.setWaveform (OscillatorWrapper::Sine, 512);
+
+    std::atomic<bool> done{ false };
+    std::vector<RealtimeSafety::Violation> violations;
+    float largest = 0.0f;
+
+    std::thread audioThread ([&]
+                             {
+                                 juce::AudioBuffer<float> buffer (1, static_cast<int> (spec.maximumBlockSize));
+                                 juce::dsp::AudioBlock<float> block (buffer);
+
+                                 RealtimeSafety::ScopedRealtimeCheck check;
+
+                                 while (! done.load())
+                                 {
+                                     buffer.clear();
+                                     oscillator.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+                                     for (int i = 0; i < buffer.getNumSamples(); i++)
+                                         largest = juce::jmax (largest, std::abs (buffer.getSample (0, i)));
+                                 }
+
+                                 violations = check.getViolations();
+                             });
+
+    const std::array<OscillatorWrapper::Waveform, 3> waveforms{ OscillatorWrapper::Saw, OscillatorWrapper::Square, OscillatorWrapper::Sine };
+
+    for (int i = 0; i < 300; i++)
+        oscillator.setWaveform (waveforms[static_cast<size_t> (i) % waveforms.size()], 512);
+
+    done = true;
+    audioThread.join();
+
+    for (auto& violation : violations)
+        FAIL_CHECK (RealtimeSafety::toString (violation));
+
+    CHECK (largest <= 1.0f + 1.0e-5f);
+}